@@ -30,6 +30,7 @@
  **********************************************************************************/
 #include "TNQVM.hpp"
 #include "IRUtils.hpp"
+#include <algorithm>
 
 namespace {
 inline int getShotCountOption(const xacc::HeterogeneousMap &in_options) {
@@ -39,6 +40,48 @@ inline int getShotCountOption(const xacc::HeterogeneousMap &in_options) {
   }
   return result;
 }
+
+// Dense state-vector engine: fast path for small registers.
+const std::string STATE_VECTOR_VISITOR = "statevector";
+// Max register size the dense engine accepts (2^32 amplitudes).
+constexpr int MAX_NUMBER_QUBITS_FOR_FAST_PATH = 32;
+// Options that only the tensor-network engines honor (truncation, slicing,
+// amplitude/conjugate contraction, MPI): the fast path is skipped if any is set.
+const std::vector<std::string> TENSOR_NETWORK_ONLY_OPTIONS{
+    "bitstring",           "contract-with-conjugate", "max-qubit",
+    "slice-batch-size",    "slice-checkpoint-file",   "mpi-communicator",
+    "mpi-shot-groups",     "max-bond-dim",            "svd-cutoff",
+    "fidelity-target",     "max-mps-memory-mb",       "canonical-form",
+    "async-gates",         "agg-width",               "variational-compression",
+    "mpi-rebalance-interval"};
+
+// Returns the name of the visitor to run a register of in_nbQubits qubits:
+// the configured exatn/exatn-mps visitor is substituted by the dense
+// state-vector engine when the register is at most 'sv-fast-path-max-qubits'
+// (opt-in, capped at 32) and no tensor-network-only option is set.
+inline std::string
+getVisitorForRegister(const std::string &in_visitorName, int in_nbQubits,
+                      const xacc::HeterogeneousMap &in_options) {
+  const bool isExatnVisitor = in_visitorName == "exatn" ||
+                              in_visitorName.rfind("exatn:", 0) == 0 ||
+                              in_visitorName.rfind("exatn-mps", 0) == 0;
+  if (!isExatnVisitor || !in_options.keyExists<int>("sv-fast-path-max-qubits") ||
+      !xacc::hasService<tnqvm::TNQVMVisitor>(STATE_VECTOR_VISITOR)) {
+    return in_visitorName;
+  }
+  const int maxQubits =
+      std::min(in_options.get<int>("sv-fast-path-max-qubits"),
+               MAX_NUMBER_QUBITS_FOR_FAST_PATH);
+  if (in_nbQubits > maxQubits) {
+    return in_visitorName;
+  }
+  for (const auto &key : TENSOR_NETWORK_ONLY_OPTIONS) {
+    if (in_options.key_exists_any_type(key)) {
+      return in_visitorName;
+    }
+  }
+  return STATE_VECTOR_VISITOR;
+}
 } // namespace
 namespace tnqvm {
 
@@ -47,7 +90,9 @@ const std::string TNQVM::DEFAULT_VISITOR_BACKEND = "itensor-mps";
 void TNQVM::execute(
     std::shared_ptr<AcceleratorBuffer> buffer,
     const std::vector<std::shared_ptr<xacc::CompositeInstruction>> functions) {
-  visitor = xacc::getService<TNQVMVisitor>(getVisitorName())->clone();
+  visitor = xacc::getService<TNQVMVisitor>(
+                getVisitorForRegister(getVisitorName(), buffer->size(), options))
+                ->clone();
   // If in VQE mode and there are more than one kernels
   if (vqeMode && functions.size() > 1 && visitor->supportVqeMode()) {
     auto kernelDecomposed = ObservedAnsatz::fromObservedComposites(functions);
@@ -70,11 +115,14 @@ void TNQVM::execute(
     // Now we have a wavefunction that represents execution of the ansatz.
     // Run the observable sub-circuits (change of basis + measurements)
     auto obsCircuits = kernelDecomposed.getObservedSubCircuits();
+    // Compute all terms in one batch so that the visitor can share the
+    // change-of-basis work between (qubit-wise) commuting terms.
+    const auto expVals = visitor->getExpectationValueZBatch(obsCircuits);
+    assert(expVals.size() == obsCircuits.size());
     for (int i = 0; i < obsCircuits.size(); ++i) {
       auto tmpBuffer = std::make_shared<xacc::AcceleratorBuffer>(
           obsCircuits[i]->name(), buffer->size());
-      double e = visitor->getExpectationValueZ(obsCircuits[i]);
-      tmpBuffer->addExtraInfo("exp-val-z", e);
+      tmpBuffer->addExtraInfo("exp-val-z", expVals[i]);
       buffer->appendChild(obsCircuits[i]->name(), tmpBuffer);
     }
     // Finalize the visitor
@@ -95,8 +143,9 @@ void TNQVM::execute(
 
 void TNQVM::execute(std::shared_ptr<xacc::AcceleratorBuffer> buffer,
                     const std::shared_ptr<xacc::CompositeInstruction> kernel) {
-  // Get the visitor backend
-  visitor = xacc::getService<TNQVMVisitor>(getVisitorName());
+  // Get the visitor backend (or the dense fast path for small registers)
+  visitor = xacc::getService<TNQVMVisitor>(
+      getVisitorForRegister(getVisitorName(), buffer->size(), options));
   visitor->setOptions(options);
 
   // Initialize the visitor
@@ -106,7 +155,8 @@ void TNQVM::execute(std::shared_ptr<xacc::AcceleratorBuffer> buffer,
   // Note: currently, we don't support MPS aggregated blocks (multiple qubit MPS
   // tensors in one block). Hence, the circuit must always be transformed into
   // *nearest* neighbor only (distance = 1 for two-qubit gates).
-  if (visitor->name() == "exatn-mps" || visitor->name() == "exatn-pmps") {
+  if ((visitor->name().rfind("exatn-mps", 0) == 0 || visitor->name() == "exatn-pmps") &&
+      !visitor->supportLongRangeGates()) {
     auto opt = xacc::getService<xacc::IRTransformation>("lnn-transform");
     opt->apply(kernel, nullptr, {std::make_pair("max-distance", 1)});
     // std::cout << "After LNN transform: \n" << kernel->toString() << "\n";
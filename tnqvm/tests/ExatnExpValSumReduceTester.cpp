@@ -33,6 +33,8 @@
 #include "xacc.hpp"
 #include "xacc_service.hpp"
 #include <random>
+#include <fstream>
+#include <cmath>
 namespace {
 inline double generateRandomProbability() {
   auto randFunc =
@@ -251,6 +253,99 @@ TEST(ExatnExpValSumReduceTester, testDeuteronH3) {
   }
 }
 
+TEST(ExatnExpValSumReduceTester, testSliceCheckpoint) {
+  const std::string checkpointFile = "ExatnSliceCheckpoint.txt";
+  // Stale checkpoint (of a different circuit): must be ignored.
+  {
+    std::ofstream staleFile(checkpointFile);
+    staleFile << "0\n0 100.0\n1 100.0\n";
+  }
+  auto accelerator = xacc::getAccelerator(
+      "tnqvm", {{"tnqvm-visitor", "exatn"},
+                {"max-qubit", 2},
+                {"slice-batch-size", 2},
+                {"slice-checkpoint-file", checkpointFile},
+                {"slice-checkpoint-interval", 1}});
+  xacc::qasm(R"(
+        .compiler xasm
+        .circuit test_checkpoint_circuit
+        .qbit q
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        Ry(q[2], 0.5);
+        CNOT(q[1], q[2]);
+        Rx(q[3], 1.2);
+        CNOT(q[2], q[3]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+    )");
+
+  auto program = xacc::getCompiled("test_checkpoint_circuit");
+  auto buffer = xacc::qalloc(4);
+  accelerator->execute(buffer, program);
+  // Validate with QPP
+  auto qpp = xacc::getAccelerator("qpp");
+  auto buffer_qpp = xacc::qalloc(4);
+  qpp->execute(buffer_qpp, program);
+  EXPECT_NEAR(buffer->getExpectationValueZ(), buffer_qpp->getExpectationValueZ(), 1e-6);
+  // The checkpoint is removed once all slices are completed.
+  EXPECT_FALSE(std::ifstream(checkpointFile).good());
+}
+
+TEST(ExatnExpValSumReduceTester, testSliceCheckpointResume) {
+  const std::string checkpointFile = "ExatnSliceCheckpointResume.txt";
+  auto accelerator = xacc::getAccelerator(
+      "tnqvm", {{"tnqvm-visitor", "exatn"},
+                {"max-qubit", 2},
+                {"slice-checkpoint-file", checkpointFile}});
+  xacc::qasm(R"(
+        .compiler xasm
+        .circuit test_checkpoint_resume_circuit
+        .qbit q
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        Ry(q[2], 0.5);
+        CNOT(q[1], q[2]);
+        Rx(q[3], 1.2);
+        CNOT(q[2], q[3]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+    )");
+  auto program = xacc::getCompiled("test_checkpoint_resume_circuit");
+  // Full run: gets the circuit hash of its checkpoint.
+  auto buffer = xacc::qalloc(4);
+  accelerator->execute(buffer, program);
+  const auto circuitHash =
+      accelerator->getExecutionInfo().getString("slice-checkpoint-hash");
+  EXPECT_FALSE(circuitHash.empty());
+
+  // Resume from a checkpoint of this circuit where path 0 is completed:
+  // its (altered) partial exp-val is used as is.
+  const auto resumeWithPath0 = [&](double in_partialExpVal) {
+    {
+      std::ofstream checkpoint(checkpointFile);
+      checkpoint.precision(17);
+      checkpoint << circuitHash << "\n0 " << in_partialExpVal << "\n";
+    }
+    auto resumedBuffer = xacc::qalloc(4);
+    accelerator->execute(resumedBuffer, program);
+    EXPECT_FALSE(std::ifstream(checkpointFile).good());
+    return resumedBuffer->getExpectationValueZ();
+  };
+  const double resumedExpVal1 = resumeWithPath0(10.0);
+  const double resumedExpVal2 = resumeWithPath0(20.0);
+  // The other paths are recomputed (same values): only the loaded one differs.
+  EXPECT_NEAR(resumedExpVal2 - resumedExpVal1, 10.0, 1e-6);
+  // Hence, the actual partial exp-val of path 0 is:
+  const double path0ExpVal = buffer->getExpectationValueZ() - (resumedExpVal1 - 10.0);
+  EXPECT_LE(std::abs(path0ExpVal), 1.0 + 1e-6);
+  EXPECT_GT(std::abs(resumedExpVal1 - buffer->getExpectationValueZ()), 1.0);
+}
+
 int main(int argc, char **argv) {
   xacc::Initialize();
   ::testing::InitGoogleTest(&argc, argv);
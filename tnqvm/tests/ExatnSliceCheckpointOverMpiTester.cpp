@@ -0,0 +1,88 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include "xacc.hpp"
+#include "xacc_service.hpp"
+#include <fstream>
+#include <cmath>
+#include <mpi.h>
+
+// This unit test is executed with mpiexec (2 processes).
+TEST(ExatnSliceCheckpointOverMpiTester, checkResumeAcrossRanks) {
+  const std::string checkpointFile = "ExatnSliceCheckpointOverMpi.txt";
+  auto accelerator = xacc::getAccelerator(
+      "tnqvm", {{"tnqvm-visitor", "exatn"},
+                {"max-qubit", 2},
+                {"slice-checkpoint-file", checkpointFile}});
+  xacc::qasm(R"(
+        .compiler xasm
+        .circuit test_checkpoint_mpi_circuit
+        .qbit q
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        Ry(q[2], 0.5);
+        CNOT(q[1], q[2]);
+        Rx(q[3], 1.2);
+        CNOT(q[2], q[3]);
+        Ry(q[4], 0.8);
+        CNOT(q[3], q[4]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+        Measure(q[4]);
+    )");
+  auto program = xacc::getCompiled("test_checkpoint_mpi_circuit");
+  // Full run (3 projected qubits: 8 paths): gets the circuit hash.
+  auto buffer = xacc::qalloc(5);
+  accelerator->execute(buffer, program);
+  const auto circuitHash =
+      accelerator->getExecutionInfo().getString("slice-checkpoint-hash");
+  EXPECT_FALSE(circuitHash.empty());
+
+  // MPI has been initialized by ExaTN.
+  int rank = 0;
+  int nbProcs = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nbProcs);
+  const auto rankFileName = [&](int in_rank) {
+    return checkpointFile + "." + std::to_string(in_rank);
+  };
+  // Resume from the checkpoint of a previous run with one more process:
+  // path 0 was completed by the extra process (not part of this run) and
+  // path 5 by the last process. The paths are handed out dynamically, hence
+  // they can be drawn by any process this time: their (altered) partial
+  // exp-vals must still be used, exactly once.
+  const auto resume = [&](double in_path0ExpVal, double in_path5ExpVal) {
+    if (rank == 0) {
+      std::ofstream extraRankFile(rankFileName(nbProcs));
+      extraRankFile.precision(17);
+      extraRankFile << circuitHash << "\n0 " << in_path0ExpVal << "\n";
+      std::ofstream lastRankFile(rankFileName(nbProcs - 1));
+      lastRankFile.precision(17);
+      lastRankFile << circuitHash << "\n5 " << in_path5ExpVal << "\n";
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto resumedBuffer = xacc::qalloc(5);
+    accelerator->execute(resumedBuffer, program);
+    MPI_Barrier(MPI_COMM_WORLD);
+    // All the checkpoint files (including that of the extra process) are
+    // removed once all slices are completed.
+    for (int i = 0; i <= nbProcs; ++i) {
+      EXPECT_FALSE(std::ifstream(rankFileName(i)).good());
+    }
+    return resumedBuffer->getExpectationValueZ();
+  };
+  const double resumedExpVal1 = resume(10.0, 20.0);
+  const double resumedExpVal2 = resume(20.0, 40.0);
+  // The other paths are recomputed (same values): only the loaded ones differ.
+  EXPECT_NEAR(resumedExpVal2 - resumedExpVal1, 30.0, 1e-6);
+  EXPECT_GT(std::abs(resumedExpVal1 - buffer->getExpectationValueZ()), 1.0);
+}
+
+int main(int argc, char **argv) {
+  xacc::Initialize();
+  ::testing::InitGoogleTest(&argc, argv);
+  auto ret = RUN_ALL_TESTS();
+  xacc::Finalize();
+  return ret;
+}
@@ -126,6 +126,45 @@ TEST(VQEModeTester, checkUcc)
     EXPECT_NEAR(-1.13717, (*buffer)["opt-val"].as<double>(), 1e-4);
 }
 
+// Terms which share (qubit-wise) measurement bases are grouped in VQE mode:
+// check against the term-by-term (non VQE mode) evaluation.
+TEST(VQEModeTester, checkCommutingTermGroups) 
+{
+    auto accVqeMode = xacc::getAccelerator("tnqvm", { std::make_pair("tnqvm-visitor", "exatn"), std::make_pair("vqe-mode", true) });
+    auto accNormalMode = xacc::getAccelerator("tnqvm", { std::make_pair("tnqvm-visitor", "exatn"), std::make_pair("vqe-mode", false) });
+    auto observable = xacc::quantum::getObservable(
+        "pauli", std::string("X0 X1 + X0 + X1 Z2 + Z0 Z1 + Z2 + Y0 Y1 + Y0 Z2 + X0 Y1 Z2"));
+    xacc::qasm(R"(
+        .compiler xasm
+        .circuit commuting_terms_ansatz
+        .qbit q
+        H(q[0]);
+        Ry(q[1], 0.123);
+        CNOT(q[0], q[1]);
+        Rx(q[2], 1.234);
+        CNOT(q[1], q[2]);
+        Rz(q[0], 0.567);
+    )");
+    auto ansatz = xacc::getCompiled("commuting_terms_ansatz");
+    auto kernels = observable->observe(ansatz);
+    auto bufferVqeMode = xacc::qalloc(3);
+    auto bufferNormalMode = xacc::qalloc(3);
+    accVqeMode->execute(bufferVqeMode, kernels);
+    accNormalMode->execute(bufferNormalMode, kernels);
+    for (const auto& kernel : kernels)
+    {
+        if (kernel->getInstructions().empty())
+        {
+            continue;
+        }
+        auto vqeModeChild = bufferVqeMode->getChildren(kernel->name());
+        auto normalModeChild = bufferNormalMode->getChildren(kernel->name());
+        EXPECT_EQ(vqeModeChild.size(), 1);
+        EXPECT_EQ(normalModeChild.size(), 1);
+        EXPECT_NEAR(vqeModeChild[0]->getExpectationValueZ(), normalModeChild[0]->getExpectationValueZ(), 1e-9);
+    }
+}
+
 int main(int argc, char **argv) 
 {
     xacc::set_verbose(true);   
@@ -37,6 +37,8 @@
 #include <random>
 #include <chrono> 
 #include <functional>
+#include <thread>
+#include <algorithm>
 
 typedef std::vector<std::complex<double>> StateVectorType;
 typedef std::vector<std::vector<std::complex<double>>> GateMatrixType;
@@ -82,6 +84,669 @@ void ApplySingleQubitGate(StateVectorType& io_psi, size_t in_index, const GateMa
     io_psi = stateVectorCopy;
 }
 
+// Runs in_kernel(begin, end) over [0, in_nbItems), partitioned across (at most) in_nbThreads threads.
+// Small ranges (less than in_minItemsPerThread items per thread) are processed by the calling thread.
+template<typename KernelType>
+void ParallelFor(uint64_t in_nbItems, const KernelType& in_kernel, size_t in_nbThreads, uint64_t in_minItemsPerThread)
+{
+    const uint64_t nbThreads = std::max<uint64_t>(1, std::min<uint64_t>(in_nbThreads, in_nbItems / in_minItemsPerThread));
+    if (nbThreads == 1)
+    {
+        in_kernel(0, in_nbItems);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(nbThreads);
+    const uint64_t chunkSize = in_nbItems / nbThreads;
+    for (uint64_t t = 0; t < nbThreads; ++t)
+    {
+        const uint64_t begin = t * chunkSize;
+        const uint64_t end = (t == nbThreads - 1) ? in_nbItems : begin + chunkSize;
+        threads.emplace_back(in_kernel, begin, end);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// Min number of amplitudes (pairs/quadruples) per thread for the in-place kernels.
+constexpr uint64_t MIN_AMPLITUDES_PER_THREAD = 1ULL << 14;
+
+// Complex multiplication without the (NaN-checking) library call,
+// so that the kernel loops can be vectorized.
+template<typename ElementType>
+inline ElementType FastComplexMul(const ElementType& in_a, const ElementType& in_b)
+{
+    return ElementType(in_a.real() * in_b.real() - in_a.imag() * in_b.imag(), in_a.real() * in_b.imag() + in_a.imag() * in_b.real());
+}
+
+// Insert a zero bit at position in_bitIdx of in_val.
+inline uint64_t InsertZeroBit(uint64_t in_val, size_t in_bitIdx)
+{
+    return ((in_val >> in_bitIdx) << (in_bitIdx + 1)) | (in_val & ((1ULL << in_bitIdx) - 1));
+}
+
+// Insert zero bits at two (different) positions.
+inline uint64_t InsertZeroBits(uint64_t in_val, size_t in_bitIdx1, size_t in_bitIdx2)
+{
+    return InsertZeroBit(InsertZeroBit(in_val, std::min(in_bitIdx1, in_bitIdx2)), std::max(in_bitIdx1, in_bitIdx2));
+}
+
+// In-place version of ApplySingleQubitGate (no state vector copy).
+// The amplitude pairs (i, i + 2^index) are partitioned across in_nbThreads threads.
+template<typename ElementType>
+void ApplySingleQubitGateInPlace(std::vector<ElementType>& io_psi, size_t in_index, const GateMatrixType& in_gateMatrix, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(in_gateMatrix.size() == 2 && in_gateMatrix[0].size() == 2 &&  in_gateMatrix[1].size() == 2);
+    assert(io_psi.size() >= (2ULL << in_index));
+    const ElementType m00(in_gateMatrix[0][0]);
+    const ElementType m01(in_gateMatrix[0][1]);
+    const ElementType m10(in_gateMatrix[1][0]);
+    const ElementType m11(in_gateMatrix[1][1]);
+    const uint64_t k_range = 1ULL << in_index;
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 2, [=](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBit(p, in_index);
+            const ElementType a0 = psi[i];
+            const ElementType a1 = psi[i + k_range];
+            psi[i] = FastComplexMul(m00, a0) + FastComplexMul(m01, a1);
+            psi[i + k_range] = FastComplexMul(m10, a0) + FastComplexMul(m11, a1);
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Diagonal single-qubit gate diag(d0, d1), e.g. Z, Rz, T.
+// The |0> half is skipped if d0 == 1 (phase gates).
+template<typename ElementType>
+void ApplyDiagonalGateInPlace(std::vector<ElementType>& io_psi, size_t in_index, const std::complex<double>& in_d0, const std::complex<double>& in_d1, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(io_psi.size() >= (2ULL << in_index));
+    const ElementType d0(in_d0);
+    const ElementType d1(in_d1);
+    const bool isPhaseGate = (in_d0 == std::complex<double>(1.0, 0.0));
+    const uint64_t k_range = 1ULL << in_index;
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 2, [=](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBit(p, in_index);
+            if (!isPhaseGate)
+            {
+                psi[i] = FastComplexMul(d0, psi[i]);
+            }
+            psi[i + k_range] = FastComplexMul(d1, psi[i + k_range]);
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Pauli-X (permutation): swap the amplitude pairs.
+template<typename ElementType>
+void ApplyXGateInPlace(std::vector<ElementType>& io_psi, size_t in_index, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(io_psi.size() >= (2ULL << in_index));
+    const uint64_t k_range = 1ULL << in_index;
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 2, [=](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBit(p, in_index);
+            std::swap(psi[i], psi[i + k_range]);
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Controlled single-qubit gate (e.g. CNOT, CY, CH, CRZ):
+// applies the 2x2 matrix on the target qubit of the amplitudes whose control bit is 1 (only 1/4 of the state vector is touched).
+template<typename ElementType>
+void ApplyControlledGateInPlace(std::vector<ElementType>& io_psi, size_t in_controlIndex, size_t in_targetIndex, const GateMatrixType& in_gateMatrix, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(in_controlIndex != in_targetIndex);
+    assert(in_gateMatrix.size() == 2 && in_gateMatrix[0].size() == 2 &&  in_gateMatrix[1].size() == 2);
+    const ElementType m00(in_gateMatrix[0][0]);
+    const ElementType m01(in_gateMatrix[0][1]);
+    const ElementType m10(in_gateMatrix[1][0]);
+    const ElementType m11(in_gateMatrix[1][1]);
+    const uint64_t ctrlMask = 1ULL << in_controlIndex;
+    const uint64_t k_range = 1ULL << in_targetIndex;
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 4, [=](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBits(p, in_controlIndex, in_targetIndex) | ctrlMask;
+            const ElementType a0 = psi[i];
+            const ElementType a1 = psi[i + k_range];
+            psi[i] = FastComplexMul(m00, a0) + FastComplexMul(m01, a1);
+            psi[i + k_range] = FastComplexMul(m10, a0) + FastComplexMul(m11, a1);
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Controlled-phase (diagonal) gate, e.g. CZ (phase = -1), CPhase:
+// multiplies the amplitudes whose both bits are 1 by the phase factor.
+template<typename ElementType>
+void ApplyControlledPhaseGateInPlace(std::vector<ElementType>& io_psi, size_t in_index1, size_t in_index2, const std::complex<double>& in_phase, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(in_index1 != in_index2);
+    const ElementType phase(in_phase);
+    const uint64_t mask = (1ULL << in_index1) | (1ULL << in_index2);
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 4, [=](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBits(p, in_index1, in_index2) | mask;
+            psi[i] = FastComplexMul(phase, psi[i]);
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Swap (permutation) gate: exchanges the |01> and |10> amplitudes.
+template<typename ElementType>
+void ApplySwapGateInPlace(std::vector<ElementType>& io_psi, size_t in_index1, size_t in_index2, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(in_index1 != in_index2);
+    const uint64_t mask1 = 1ULL << in_index1;
+    const uint64_t mask2 = 1ULL << in_index2;
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 4, [=](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBits(p, in_index1, in_index2);
+            std::swap(psi[i | mask1], psi[i | mask2]);
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Generic two-qubit gate (4x4 matrix, e.g. iSwap, fSim).
+// Matrix basis: |b1 b2>, i.e. in_index1 is the most significant bit (same as GetGateMatrix<CommonGates::CNOT>: control, target).
+template<typename ElementType>
+void ApplyTwoQubitGateInPlace(std::vector<ElementType>& io_psi, size_t in_index1, size_t in_index2, const GateMatrixType& in_gateMatrix, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    assert(in_index1 != in_index2);
+    assert(in_gateMatrix.size() == 4);
+    ElementType mat[4][4];
+    for (int row = 0; row < 4; ++row)
+    {
+        assert(in_gateMatrix[row].size() == 4);
+        for (int col = 0; col < 4; ++col)
+        {
+            mat[row][col] = ElementType(in_gateMatrix[row][col]);
+        }
+    }
+    const uint64_t mask1 = 1ULL << in_index1;
+    const uint64_t mask2 = 1ULL << in_index2;
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() / 4, [=, &mat](uint64_t in_begin, uint64_t in_end) {
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            const uint64_t i = InsertZeroBits(p, in_index1, in_index2);
+            const uint64_t idx[4] = { i, i | mask2, i | mask1, i | mask1 | mask2 };
+            const ElementType a[4] = { psi[idx[0]], psi[idx[1]], psi[idx[2]], psi[idx[3]] };
+            for (int row = 0; row < 4; ++row)
+            {
+                psi[idx[row]] = FastComplexMul(mat[row][0], a[0]) + FastComplexMul(mat[row][1], a[1]) + FastComplexMul(mat[row][2], a[2]) + FastComplexMul(mat[row][3], a[3]);
+            }
+        }
+    }, in_nbThreads, MIN_AMPLITUDES_PER_THREAD);
+}
+
+// Max number of qubits of a fused gate (2^k x 2^k unitary).
+constexpr size_t MAX_FUSED_GATE_QUBITS = 5;
+
+// Product of two (square) gate matrices: in_a * in_b
+inline GateMatrixType MultiplyGateMatrices(const GateMatrixType& in_a, const GateMatrixType& in_b)
+{
+    assert(in_a.size() == in_b.size());
+    const size_t dim = in_a.size();
+    GateMatrixType result(dim, std::vector<std::complex<double>>(dim, 0.0));
+    for (size_t row = 0; row < dim; ++row)
+    {
+        for (size_t k = 0; k < dim; ++k)
+        {
+            if (in_a[row][k] != 0.0)
+            {
+                for (size_t col = 0; col < dim; ++col)
+                {
+                    result[row][col] += in_a[row][k] * in_b[k][col];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Expands a gate matrix acting on in_gateQubits to the (super)set in_targetQubits,
+// i.e. tensor product with the identity on the other qubits.
+// Matrix basis: the first qubit in the list is the most significant bit.
+inline GateMatrixType ExpandGateMatrix(const GateMatrixType& in_matrix, const std::vector<size_t>& in_gateQubits, const std::vector<size_t>& in_targetQubits)
+{
+    const size_t nbQubits = in_targetQubits.size();
+    const uint64_t dim = 1ULL << nbQubits;
+    // Bit position of each gate qubit in the target matrix index.
+    std::vector<size_t> bitPositions;
+    uint64_t gateMask = 0;
+    for (const auto& qubit : in_gateQubits)
+    {
+        const auto iter = std::find(in_targetQubits.begin(), in_targetQubits.end(), qubit);
+        assert(iter != in_targetQubits.end());
+        bitPositions.emplace_back(nbQubits - 1 - std::distance(in_targetQubits.begin(), iter));
+        gateMask |= 1ULL << bitPositions.back();
+    }
+
+    const auto gateIndex = [&bitPositions](uint64_t in_targetIdx) {
+        uint64_t result = 0;
+        for (const auto& bitPos : bitPositions)
+        {
+            result = (result << 1) | ((in_targetIdx >> bitPos) & 1);
+        }
+        return result;
+    };
+
+    GateMatrixType result(dim, std::vector<std::complex<double>>(dim, 0.0));
+    for (uint64_t row = 0; row < dim; ++row)
+    {
+        for (uint64_t col = 0; col < dim; ++col)
+        {
+            // Identity on the other qubits
+            if ((row & ~gateMask) == (col & ~gateMask))
+            {
+                result[row][col] = in_matrix[gateIndex(row)][gateIndex(col)];
+            }
+        }
+    }
+    return result;
+}
+
+// Superoperator (4^k x 4^k matrix) of the channel rho -> sum_i K_i * rho * K_i^dagger,
+// i.e. sum_i K_i (x) conj(K_i) acting on the (row, column) qubits of the (vectorized) density matrix.
+// Matrix basis: the row (ket) qubits are the most significant bits, then the column (bra) qubits.
+inline GateMatrixType GetSuperOperatorMatrix(const std::vector<GateMatrixType>& in_krausOps)
+{
+    assert(!in_krausOps.empty());
+    const size_t dim = in_krausOps[0].size();
+    GateMatrixType result(dim * dim, std::vector<std::complex<double>>(dim * dim, 0.0));
+    for (const auto& krausOp : in_krausOps)
+    {
+        assert(krausOp.size() == dim);
+        for (size_t row1 = 0; row1 < dim; ++row1)
+        {
+            for (size_t col1 = 0; col1 < dim; ++col1)
+            {
+                if (krausOp[row1][col1] == 0.0)
+                {
+                    continue;
+                }
+                for (size_t row2 = 0; row2 < dim; ++row2)
+                {
+                    for (size_t col2 = 0; col2 < dim; ++col2)
+                    {
+                        result[row1 * dim + row2][col1 * dim + col2] += krausOp[row1][col1] * std::conj(krausOp[row2][col2]);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Generic k-qubit gate (2^k x 2^k matrix, k <= MAX_FUSED_GATE_QUBITS).
+// Matrix basis: in_qubits[0] is the most significant bit.
+// The matrix and amplitude offsets are prepared once so that the kernel can be
+// applied repeatedly (e.g. to each cache block).
+template<typename ElementType>
+class MultiQubitGateKernel
+{
+public:
+    MultiQubitGateKernel(const std::vector<size_t>& in_qubits, const GateMatrixType& in_gateMatrix) :
+        m_nbQubits(in_qubits.size()),
+        m_dim(1ULL << in_qubits.size()),
+        m_sortedQubits(in_qubits)
+    {
+        assert(m_nbQubits > 0 && m_nbQubits <= MAX_FUSED_GATE_QUBITS);
+        assert(in_gateMatrix.size() == m_dim);
+        m_matrix.resize(m_dim * m_dim);
+        for (uint64_t row = 0; row < m_dim; ++row)
+        {
+            for (uint64_t col = 0; col < m_dim; ++col)
+            {
+                m_matrix[row * m_dim + col] = ElementType(in_gateMatrix[row][col]);
+            }
+        }
+        // Amplitude offsets of each basis state of the gate qubits.
+        m_offsets.assign(m_dim, 0);
+        for (uint64_t j = 0; j < m_dim; ++j)
+        {
+            for (size_t i = 0; i < m_nbQubits; ++i)
+            {
+                if ((j >> (m_nbQubits - 1 - i)) & 1)
+                {
+                    m_offsets[j] |= 1ULL << in_qubits[i];
+                }
+            }
+        }
+        std::sort(m_sortedQubits.begin(), m_sortedQubits.end());
+    }
+
+    // Min state vector size that this gate can be applied to.
+    uint64_t minSize() const { return 2ULL << m_sortedQubits.back(); }
+    size_t nbQubits() const { return m_nbQubits; }
+
+    // Applies the gate to the amplitude groups [in_begin, in_end) of in_psi
+    // (there are size/2^k groups).
+    void apply(ElementType* io_psi, uint64_t in_begin, uint64_t in_end) const
+    {
+        // Dispatch to the fixed-size implementations (unrolled/vectorized loops)
+        switch (m_nbQubits)
+        {
+            case 1: applyImpl<1>(io_psi, in_begin, in_end); break;
+            case 2: applyImpl<2>(io_psi, in_begin, in_end); break;
+            case 3: applyImpl<3>(io_psi, in_begin, in_end); break;
+            case 4: applyImpl<4>(io_psi, in_begin, in_end); break;
+            case 5: applyImpl<5>(io_psi, in_begin, in_end); break;
+            default: assert(false);
+        }
+    }
+
+private:
+    template<size_t NB_QUBITS>
+    void applyImpl(ElementType* io_psi, uint64_t in_begin, uint64_t in_end) const
+    {
+        constexpr uint64_t DIM = 1ULL << NB_QUBITS;
+        size_t sortedQubits[NB_QUBITS];
+        std::copy(m_sortedQubits.begin(), m_sortedQubits.end(), sortedQubits);
+        uint64_t offsets[DIM];
+        std::copy(m_offsets.begin(), m_offsets.end(), offsets);
+        const ElementType* mat = m_matrix.data();
+        ElementType amps[DIM];
+        for (uint64_t p = in_begin; p < in_end; ++p)
+        {
+            uint64_t i = p;
+            for (size_t q = 0; q < NB_QUBITS; ++q)
+            {
+                i = InsertZeroBit(i, sortedQubits[q]);
+            }
+            for (uint64_t j = 0; j < DIM; ++j)
+            {
+                amps[j] = io_psi[i + offsets[j]];
+            }
+            for (uint64_t row = 0; row < DIM; ++row)
+            {
+                typename ElementType::value_type sumReal = 0.0;
+                typename ElementType::value_type sumImag = 0.0;
+                for (uint64_t col = 0; col < DIM; ++col)
+                {
+                    const ElementType& m = mat[row * DIM + col];
+                    sumReal += m.real() * amps[col].real() - m.imag() * amps[col].imag();
+                    sumImag += m.real() * amps[col].imag() + m.imag() * amps[col].real();
+                }
+                io_psi[i + offsets[row]] = ElementType(sumReal, sumImag);
+            }
+        }
+    }
+
+    size_t m_nbQubits;
+    uint64_t m_dim;
+    std::vector<size_t> m_sortedQubits;
+    std::vector<ElementType> m_matrix;
+    std::vector<uint64_t> m_offsets;
+};
+
+template<typename ElementType>
+void ApplyMultiQubitGateInPlace(std::vector<ElementType>& io_psi, const std::vector<size_t>& in_qubits, const GateMatrixType& in_gateMatrix, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    const MultiQubitGateKernel<ElementType> kernel(in_qubits, in_gateMatrix);
+    assert(io_psi.size() >= kernel.minSize());
+    ElementType* psi = io_psi.data();
+    ParallelFor(io_psi.size() >> in_qubits.size(), [psi, &kernel](uint64_t in_begin, uint64_t in_end) {
+        kernel.apply(psi, in_begin, in_end);
+    }, in_nbThreads, std::max<uint64_t>(1, MIN_AMPLITUDES_PER_THREAD >> in_qubits.size()));
+}
+
+// Gate fusion and cache-blocked scheduling for the in-place kernels:
+// each gate is multiplied into the latest queued (fused) gate that it can be moved to,
+// i.e. past gates on disjoint qubits only, as long as the union of their qubits has at most in_maxFusedQubits qubits.
+// At flush(), fused gates acting only on qubits below in_cacheBlockQubits are grouped and applied
+// chunk-by-chunk (2^in_cacheBlockQubits amplitudes), i.e. one memory pass for the whole group.
+class FusedGateQueue
+{
+public:
+    FusedGateQueue(size_t in_maxFusedQubits = 4, size_t in_cacheBlockQubits = 14, size_t in_maxQueueSize = 64) :
+        m_maxFusedQubits(std::max<size_t>(1, std::min(in_maxFusedQubits, MAX_FUSED_GATE_QUBITS))),
+        m_cacheBlockQubits(in_cacheBlockQubits),
+        m_maxQueueSize(in_maxQueueSize)
+    {}
+
+    // Adds a gate (matrix basis: in_qubits[0] is the most significant bit).
+    // Returns true if the queue is full, i.e. should be flushed.
+    bool addGate(const std::vector<size_t>& in_qubits, const GateMatrixType& in_gateMatrix)
+    {
+        for (auto iter = m_queue.rbegin(); iter != m_queue.rend(); ++iter)
+        {
+            std::vector<size_t> fusedQubits(iter->qubits);
+            bool overlap = false;
+            for (const auto& qubit : in_qubits)
+            {
+                if (std::find(iter->qubits.begin(), iter->qubits.end(), qubit) == iter->qubits.end())
+                {
+                    fusedQubits.emplace_back(qubit);
+                }
+                else
+                {
+                    overlap = true;
+                }
+            }
+
+            if (fusedQubits.size() <= m_maxFusedQubits)
+            {
+                const auto expandedMatrix = (fusedQubits.size() > iter->qubits.size()) ? ExpandGateMatrix(iter->matrix, iter->qubits, fusedQubits) : iter->matrix;
+                iter->matrix = MultiplyGateMatrices(ExpandGateMatrix(in_gateMatrix, in_qubits, fusedQubits), expandedMatrix);
+                iter->qubits = fusedQubits;
+                return false;
+            }
+
+            if (overlap)
+            {
+                // Cannot be moved past this gate.
+                break;
+            }
+        }
+
+        m_queue.emplace_back(FusedGate{ in_qubits, in_gateMatrix });
+        return m_queue.size() >= m_maxQueueSize;
+    }
+
+    bool empty() const { return m_queue.empty(); }
+
+    // Applies all the queued gates to the state vector.
+    template<typename ElementType>
+    void flush(std::vector<ElementType>& io_psi, size_t in_nbThreads = std::thread::hardware_concurrency())
+    {
+        const uint64_t blockSize = std::min<uint64_t>(io_psi.size(), 1ULL << m_cacheBlockQubits);
+        const auto isLowOrderGate = [blockSize](const FusedGate& in_gate) {
+            return (2ULL << *std::max_element(in_gate.qubits.begin(), in_gate.qubits.end())) <= blockSize;
+        };
+        const auto isDisjoint = [](const FusedGate& in_gate1, const FusedGate& in_gate2) {
+            return std::none_of(in_gate1.qubits.begin(), in_gate1.qubits.end(), [&in_gate2](size_t in_qubit) {
+                return std::find(in_gate2.qubits.begin(), in_gate2.qubits.end(), in_qubit) != in_gate2.qubits.end();
+            });
+        };
+        // Move low-order gates backward (past disjoint, i.e. commuting, gates) to join the preceding low-order group.
+        for (size_t i = 1; i < m_queue.size(); ++i)
+        {
+            if (!isLowOrderGate(m_queue[i]))
+            {
+                continue;
+            }
+            size_t pos = i;
+            while (pos > 0 && !isLowOrderGate(m_queue[pos - 1]) && isDisjoint(m_queue[pos - 1], m_queue[i]))
+            {
+                --pos;
+            }
+            if (pos < i && pos > 0 && isLowOrderGate(m_queue[pos - 1]))
+            {
+                std::rotate(m_queue.begin() + pos, m_queue.begin() + i, m_queue.begin() + i + 1);
+            }
+        }
+
+        auto iter = m_queue.begin();
+        while (iter != m_queue.end())
+        {
+            const auto runEnd = std::find_if_not(iter, m_queue.end(), isLowOrderGate);
+            if (std::distance(iter, runEnd) > 1)
+            {
+                // Cache-blocked: apply the whole run to each chunk while it is resident.
+                std::vector<MultiQubitGateKernel<ElementType>> kernels;
+                for (; iter != runEnd; ++iter)
+                {
+                    kernels.emplace_back(iter->qubits, iter->matrix);
+                }
+                ElementType* psi = io_psi.data();
+                ParallelFor(io_psi.size() / blockSize, [psi, blockSize, &kernels](uint64_t in_begin, uint64_t in_end) {
+                    for (uint64_t block = in_begin; block < in_end; ++block)
+                    {
+                        for (const auto& kernel : kernels)
+                        {
+                            kernel.apply(psi + block * blockSize, 0, blockSize >> kernel.nbQubits());
+                        }
+                    }
+                }, in_nbThreads, 1);
+            }
+            else
+            {
+                applyGate(io_psi, *iter, in_nbThreads);
+                ++iter;
+            }
+        }
+        m_queue.clear();
+    }
+
+private:
+    struct FusedGate
+    {
+        std::vector<size_t> qubits;
+        GateMatrixType matrix;
+    };
+
+    // Full-vector pass: use the specialized kernels where possible.
+    template<typename ElementType>
+    static void applyGate(std::vector<ElementType>& io_psi, const FusedGate& in_gate, size_t in_nbThreads)
+    {
+        if (in_gate.qubits.size() == 1)
+        {
+            if (in_gate.matrix[0][1] == 0.0 && in_gate.matrix[1][0] == 0.0)
+            {
+                ApplyDiagonalGateInPlace(io_psi, in_gate.qubits[0], in_gate.matrix[0][0], in_gate.matrix[1][1], in_nbThreads);
+            }
+            else
+            {
+                ApplySingleQubitGateInPlace(io_psi, in_gate.qubits[0], in_gate.matrix, in_nbThreads);
+            }
+        }
+        else if (in_gate.qubits.size() == 2)
+        {
+            ApplyTwoQubitGateInPlace(io_psi, in_gate.qubits[0], in_gate.qubits[1], in_gate.matrix, in_nbThreads);
+        }
+        else
+        {
+            ApplyMultiQubitGateInPlace(io_psi, in_gate.qubits, in_gate.matrix, in_nbThreads);
+        }
+    }
+
+    size_t m_maxFusedQubits;
+    size_t m_cacheBlockQubits;
+    size_t m_maxQueueSize;
+    std::vector<FusedGate> m_queue;
+};
+
+// Parity (Z-string) bit mask of a list of qubit indices.
+template<typename IndexType>
+uint64_t GetParityMask(const std::vector<IndexType>& in_bits)
+{
+    uint64_t mask = 0;
+    for (const auto& bitIdx : in_bits)
+    {
+        mask |= (1ULL << bitIdx);
+    }
+    return mask;
+}
+
+// Expectation values of multiple Z-strings (one parity mask each) in a single pass over the state vector:
+// result[j] = Sum_i (-1)^popcount(i & mask_j) * |psi_i|^2
+// The index range is partitioned across in_nbThreads threads;
+// within each block, probabilities are computed once and shared by all masks.
+template<typename ElementType>
+std::vector<double> CalcExpValueZByMasks(const std::vector<uint64_t>& in_masks, const ElementType* in_psi, uint64_t in_size, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    // Min number of amplitudes for each thread.
+    constexpr uint64_t MIN_ELEMENTS_PER_THREAD = 1ULL << 15;
+    const size_t nbMasks = in_masks.size();
+    const auto reduceKernel = [&in_masks, in_psi, nbMasks](uint64_t in_begin, uint64_t in_end, double* out_result) {
+        constexpr uint64_t BLOCK_SIZE = 256;
+        double probs[BLOCK_SIZE];
+        for (uint64_t blockStart = in_begin; blockStart < in_end; blockStart += BLOCK_SIZE)
+        {
+            const uint64_t blockSize = std::min<uint64_t>(BLOCK_SIZE, in_end - blockStart);
+            for (uint64_t k = 0; k < blockSize; ++k)
+            {
+                const auto& amplitude = in_psi[blockStart + k];
+                probs[k] = static_cast<double>(amplitude.real()) * amplitude.real() + static_cast<double>(amplitude.imag()) * amplitude.imag();
+            }
+
+            for (size_t j = 0; j < nbMasks; ++j)
+            {
+                const uint64_t mask = in_masks[j];
+                double blockSum = 0.0;
+                for (uint64_t k = 0; k < blockSize; ++k)
+                {
+                    // +1 for even parity, -1 for odd parity
+                    const double sign = 1.0 - 2.0 * (__builtin_popcountll((blockStart + k) & mask) & 1);
+                    blockSum += sign * probs[k];
+                }
+                out_result[j] += blockSum;
+            }
+        }
+    };
+
+    const uint64_t nbThreads = std::max<uint64_t>(1, std::min<uint64_t>(in_nbThreads, in_size / MIN_ELEMENTS_PER_THREAD));
+    // Partial results of each chunk (reduced in order for reproducibility)
+    std::vector<std::vector<double>> partialResults(nbThreads, std::vector<double>(nbMasks, 0.0));
+    const uint64_t chunkSize = in_size / nbThreads;
+    ParallelFor(nbThreads, [&](uint64_t in_beginChunk, uint64_t in_endChunk) {
+        for (uint64_t chunk = in_beginChunk; chunk < in_endChunk; ++chunk)
+        {
+            const uint64_t begin = chunk * chunkSize;
+            const uint64_t end = (chunk == nbThreads - 1) ? in_size : begin + chunkSize;
+            reduceKernel(begin, end, partialResults[chunk].data());
+        }
+    }, nbThreads, 1);
+
+    std::vector<double> result(nbMasks, 0.0);
+    for (const auto& partialResult : partialResults)
+    {
+        for (size_t j = 0; j < nbMasks; ++j)
+        {
+            result[j] += partialResult[j];
+        }
+    }
+    return result;
+}
+
+template<typename ElementType>
+std::vector<double> CalcExpValueZByMasks(const std::vector<uint64_t>& in_masks, const std::vector<ElementType>& in_psi, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    return CalcExpValueZByMasks(in_masks, in_psi.data(), in_psi.size(), in_nbThreads);
+}
+
+// Single Z-string version: expectation value of Z on all qubits in the list.
+template<typename ElementType, typename IndexType>
+double CalcExpValueZ(const std::vector<IndexType>& in_bits, const std::vector<ElementType>& in_psi, size_t in_nbThreads = std::thread::hardware_concurrency())
+{
+    return CalcExpValueZByMasks(std::vector<uint64_t>{ GetParityMask(in_bits) }, in_psi.data(), in_psi.size(), in_nbThreads)[0];
+}
+
 void ApplyCNOTGate(StateVectorType& io_psi, size_t in_controlIndex, size_t in_targetIndex)
 {
     // Must have at least 2 qubits
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "ExaTnTensorPool.hpp"
+#include "AllGateVisitor.hpp"
+#include "NoiseModel.hpp"
+#include "xacc_service.hpp"
+#include "utils/GateMatrixAlgebra.hpp"
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace tnqvm {
+// Cache of the noise channel tensors (Choi matrices) of a noise model.
+// For a fixed noise model, the noise channels of a gate instance only depend on
+// the gate type, its parameters and its qubits: the noise model query, the Kraus -> Choi
+// conversion and the tensor creation hence only happen once per (gate, qubits) key.
+// The cache is kept across executions (i.e. by the visitor service instance): it is only cleared when the noise model changes
+// (see setNoiseModel()) or when the cache is destroyed.
+// Note: tensors with the same Choi matrix are shared by all keys (see ExaTnTensorPool::getGateTensor()).
+// Visitors that fuse the noise channels into the gates (e.g. exatn-dm) use the host-side superoperators instead.
+class ExaTnNoiseTensorCache
+{
+public:
+    struct NoiseTensor
+    {
+        std::string tensorName;
+        // Qubits that the channel is acting on
+        std::vector<size_t> qubits;
+        // Bit order of the (multi-qubit) Choi matrix
+        xacc::KrausMatBitOrder bitOrder;
+    };
+
+    struct NoiseSuperOperator
+    {
+        // Qubits that the channel is acting on (the first one is the MSB)
+        std::vector<size_t> qubits;
+        // sum_i K_i (x) conj(K_i), see GetSuperOperatorMatrix()
+        GateMatrixType matrix;
+    };
+
+    ExaTnNoiseTensorCache(const std::string& in_namePrefix) :
+        m_tensorPool(in_namePrefix),
+        m_nbCacheMisses(0)
+    {}
+
+    ~ExaTnNoiseTensorCache()
+    {
+        if (exatn::isInitialized())
+        {
+            clear();
+        }
+    }
+
+    // Sets the noise model to query: the cache is reset if it is not the same as the previous one.
+    void setNoiseModel(std::shared_ptr<xacc::NoiseModel> in_noiseModel)
+    {
+        const std::string noiseModelJson = in_noiseModel ? in_noiseModel->toJson() : "";
+        if (noiseModelJson != m_noiseModelJson)
+        {
+            clear();
+            m_noiseModelJson = noiseModelJson;
+        }
+        m_noiseModel = in_noiseModel;
+    }
+
+    // Returns the noise channel tensors to apply after this gate (in order).
+    std::vector<NoiseTensor> getNoiseTensors(xacc::quantum::Gate& in_gate)
+    {
+        assert(m_noiseModel);
+        const std::string gateKey = getGateKey(in_gate);
+        const auto iter = m_noiseTensors.find(gateKey);
+        if (iter != m_noiseTensors.end())
+        {
+            return iter->second;
+        }
+
+        // e.g. a parametric gate with different angles every time:
+        // drop the keys (the tensors themselves are shared by their data).
+        if (m_noiseTensors.size() >= MAX_CACHED_KEYS)
+        {
+            m_noiseTensors.clear();
+        }
+
+        ++m_nbCacheMisses;
+        if (!m_noiseUtils)
+        {
+            m_noiseUtils = xacc::getService<xacc::NoiseModelUtils>("default");
+        }
+        std::vector<NoiseTensor> noiseTensors;
+        for (const auto& channel : m_noiseModel->getNoiseChannels(in_gate))
+        {
+            const auto choiMatrix = m_noiseUtils->krausToChoi(channel.mats);
+            std::vector<std::complex<double>> choiData;
+            choiData.reserve(choiMatrix.size() * choiMatrix.size());
+            for (const auto& row : choiMatrix)
+            {
+                choiData.insert(choiData.end(), row.begin(), row.end());
+            }
+            // k-qubit channel: rank-4k tensor
+            const exatn::TensorShape tensorShape(std::vector<exatn::DimExtent>(4 * channel.noise_qubits.size(), 2));
+            const std::string tensorName = m_tensorPool.getGateTensor("NOISE" + std::to_string(channel.noise_qubits.size()), tensorShape, choiData);
+            noiseTensors.emplace_back(NoiseTensor{ tensorName, std::vector<size_t>(channel.noise_qubits.begin(), channel.noise_qubits.end()), channel.bit_order });
+        }
+
+        m_noiseTensors.emplace(gateKey, noiseTensors);
+        return noiseTensors;
+    }
+
+    // Returns the superoperators of the noise channels to apply after this gate (in order).
+    std::vector<NoiseSuperOperator> getNoiseSuperOperators(xacc::quantum::Gate& in_gate)
+    {
+        assert(m_noiseModel);
+        const std::string gateKey = getGateKey(in_gate);
+        const auto iter = m_noiseSuperOps.find(gateKey);
+        if (iter != m_noiseSuperOps.end())
+        {
+            return iter->second;
+        }
+
+        if (m_noiseSuperOps.size() >= MAX_CACHED_KEYS)
+        {
+            m_noiseSuperOps.clear();
+        }
+
+        ++m_nbCacheMisses;
+        std::vector<NoiseSuperOperator> noiseSuperOps;
+        for (const auto& channel : m_noiseModel->getNoiseChannels(in_gate))
+        {
+            // MSB first, as the gate matrices.
+            std::vector<size_t> qubits(channel.noise_qubits.begin(), channel.noise_qubits.end());
+            if (channel.bit_order == xacc::KrausMatBitOrder::LSB)
+            {
+                std::reverse(qubits.begin(), qubits.end());
+            }
+            noiseSuperOps.emplace_back(NoiseSuperOperator{ qubits, GetSuperOperatorMatrix(channel.mats) });
+        }
+
+        m_noiseSuperOps.emplace(gateKey, noiseSuperOps);
+        return noiseSuperOps;
+    }
+
+    // Is this tensor owned (hence, will be destroyed) by this cache?
+    bool contains(const std::string& in_tensorName) const { return m_tensorPool.contains(in_tensorName); }
+
+    // Number of (gate, qubits) keys whose noise channels were converted (i.e. the noise model was queried) since the last resetNbCacheMisses() or clear().
+    size_t getNbCacheMisses() const { return m_nbCacheMisses; }
+
+    // Resets the cache-miss count (e.g. at the end of an execution) without dropping any cached channel.
+    void resetNbCacheMisses() { m_nbCacheMisses = 0; }
+
+    // Destroys all the cached tensors.
+    void clear()
+    {
+        m_noiseTensors.clear();
+        m_noiseSuperOps.clear();
+        m_tensorPool.clear();
+        m_nbCacheMisses = 0;
+    }
+
+private:
+    static std::string getGateKey(xacc::quantum::Gate& in_gate)
+    {
+        std::ostringstream key;
+        key << std::setprecision(std::numeric_limits<double>::max_digits10) << in_gate.name();
+        for (size_t i = 0; i < in_gate.nParameters(); ++i)
+        {
+            key << "," << in_gate.getParameter(i).as<double>();
+        }
+        for (const auto& bit : in_gate.bits())
+        {
+            key << "|" << bit;
+        }
+        return key.str();
+    }
+
+    // Max number of (gate, qubits) keys
+    static constexpr size_t MAX_CACHED_KEYS = 4096;
+    ExaTnTensorPool m_tensorPool;
+    std::shared_ptr<xacc::NoiseModel> m_noiseModel;
+    std::shared_ptr<xacc::NoiseModelUtils> m_noiseUtils;
+    std::string m_noiseModelJson;
+    std::unordered_map<std::string, std::vector<NoiseTensor>> m_noiseTensors;
+    std::unordered_map<std::string, std::vector<NoiseSuperOperator>> m_noiseSuperOps;
+    size_t m_nbCacheMisses;
+};
+} // namespace tnqvm
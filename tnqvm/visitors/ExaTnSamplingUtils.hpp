@@ -0,0 +1,44 @@
+#pragma once
+
+#include "NoiseModel.hpp"
+#include <chrono>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tnqvm {
+// Shot sampling helpers shared by the noisy ExaTN visitors (exatn-dm, exatn-pmps).
+
+// Uniform random number in [0, 1) (the generator is seeded once).
+inline double getRandomProbability()
+{
+    static auto randomProbFunc = std::bind(std::uniform_real_distribution<double>(0, 1), std::mt19937(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+    return randomProbFunc();
+}
+
+// Converts sampled qubit values (indexed by qubit) to the result bit string (in measurement order),
+// applying readout errors if a noise model is provided.
+inline std::string generateResultBitString(const std::vector<uint8_t>& in_sampledBits, const std::vector<size_t>& in_measureQubits, xacc::NoiseModel* in_noiseModel = nullptr)
+{
+    std::string result;
+    for (const auto& qubit : in_measureQubits)
+    {
+        const bool bit = (in_sampledBits[qubit] == 1);
+        if (in_noiseModel)
+        {
+            // Apply Readout error:
+            const auto roErrorProb = getRandomProbability();
+            const auto [meas0Prep1, meas1Prep0] = in_noiseModel->readoutError(qubit);
+            const double flipProb = bit ? meas0Prep1 : meas1Prep0;
+            const bool measBit = (roErrorProb < flipProb) ? !bit : bit;
+            result.push_back(measBit ? '1' : '0');
+        }
+        else
+        {
+            result.push_back(bit ? '1' : '0');
+        }
+    }
+    return result;
+}
+} // namespace tnqvm
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "exatn.hpp"
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <deque>
+#include <map>
+#include <unordered_map>
+
+namespace tnqvm {
+// Per-visitor registry of reusable ExaTN tensors, to avoid the create/destroy
+// (allocation and runtime registration) round trip for every gate:
+// (1) Scratch tensors (e.g. merged or result tensors of a gate contraction)
+// are pooled by shape: acquireScratchTensor() returns a free tensor of the
+// requested shape, creating one only if none is available;
+// releaseScratchTensor() returns it to the pool.
+// Free scratch tensors are capped in total size (e.g. MPS bond dimensions change
+// on every gate, hence most shapes are never requested again): when the cap is
+// exceeded, the least recently released ones are destroyed.
+// Note: a scratch tensor keeps its previous content; callers that accumulate
+// into it (contractTensors) must still zero it.
+// (2) Gate tensors are created once per distinct tensor body and kept alive
+// until clear(), which the visitor calls in finalize().
+// Tensor names are prefixed with the visitor-specific prefix so that
+// different visitors sharing the ExaTN runtime do not collide.
+class ExaTnTensorPool
+{
+public:
+    // in_maxGateTensors: max number of cached gate tensors (0: unlimited).
+    // When the limit is reached, the oldest gate tensor is evicted.
+    // Only use a limit if the gate tensors are not referenced lazily (e.g. by a tensor network to be evaluated later).
+    // in_maxFreeScratchBytes: max total size of the free (released) scratch tensors.
+    ExaTnTensorPool(const std::string& in_namePrefix, size_t in_maxGateTensors = 0, size_t in_maxFreeScratchBytes = DEFAULT_MAX_FREE_SCRATCH_BYTES) :
+        m_namePrefix(in_namePrefix),
+        m_maxGateTensors(in_maxGateTensors),
+        m_maxFreeScratchBytes(in_maxFreeScratchBytes),
+        m_freeScratchBytes(0),
+        m_tensorCounter(0)
+    {}
+
+    // The pool owns its tensors: not copyable.
+    ExaTnTensorPool(const ExaTnTensorPool&) = delete;
+    ExaTnTensorPool& operator=(const ExaTnTensorPool&) = delete;
+
+    // Destroys the remaining tensors (e.g. if finalize() was never reached),
+    // unless the ExaTN runtime is already finalized.
+    ~ExaTnTensorPool()
+    {
+        if (exatn::isInitialized())
+        {
+            for (const auto& [tensorName, key] : m_usedScratchTensors)
+            {
+                exatn::destroyTensor(tensorName);
+            }
+            m_usedScratchTensors.clear();
+            clear();
+        }
+    }
+
+    // Default cap of the free scratch tensors: 256 MB
+    static constexpr size_t DEFAULT_MAX_FREE_SCRATCH_BYTES = 256ULL * 1024 * 1024;
+
+    // Returns the name of a free scratch tensor with the requested shape.
+    std::string acquireScratchTensor(const exatn::TensorShape& in_shape, exatn::TensorElementType in_elementType = exatn::TensorElementType::COMPLEX64)
+    {
+        const ScratchKey key{ in_elementType, in_shape.getDimExtents() };
+        auto& freeList = m_freeScratchTensors[key];
+        if (!freeList.empty())
+        {
+            const std::string tensorName = freeList.back();
+            freeList.pop_back();
+            m_freeScratchOrder.erase(std::find(m_freeScratchOrder.begin(), m_freeScratchOrder.end(), tensorName));
+            m_freeScratchBytes -= getTensorBytes(key);
+            m_freeScratchTensorKeys.erase(tensorName);
+            m_usedScratchTensors.emplace(tensorName, key);
+            return tensorName;
+        }
+
+        const std::string tensorName = m_namePrefix + "_Scratch_" + std::to_string(m_tensorCounter++);
+        const bool created = exatn::createTensor(tensorName, in_elementType, in_shape);
+        assert(created);
+        m_usedScratchTensors.emplace(tensorName, key);
+        return tensorName;
+    }
+
+    // Returns a scratch tensor to the pool: it can be handed out again by the next acquireScratchTensor().
+    void releaseScratchTensor(const std::string& in_tensorName)
+    {
+        const auto iter = m_usedScratchTensors.find(in_tensorName);
+        assert(iter != m_usedScratchTensors.end());
+        m_freeScratchTensors[iter->second].emplace_back(in_tensorName);
+        m_freeScratchOrder.emplace_back(in_tensorName);
+        m_freeScratchBytes += getTensorBytes(iter->second);
+        m_freeScratchTensorKeys.emplace(in_tensorName, iter->second);
+        m_usedScratchTensors.erase(iter);
+        while (m_freeScratchBytes > m_maxFreeScratchBytes && !m_freeScratchOrder.empty())
+        {
+            evictFreeScratchTensor();
+        }
+    }
+
+    // Returns the name of a gate tensor with the given body,
+    // creating (and initializing) it on the first request.
+    // in_gateName is only used as a lookup key (the body is always compared).
+    std::string getGateTensor(const std::string& in_gateName, const exatn::TensorShape& in_shape, const std::vector<std::complex<double>>& in_data, exatn::TensorElementType in_elementType = exatn::TensorElementType::COMPLEX64)
+    {
+        // Note: multiple gate tensors can share the same key if the key doesn't identify the gate body uniquely,
+        // e.g. parameter values are rounded.
+        auto& entries = m_gateTensors[in_gateName];
+        for (const auto& entry : entries)
+        {
+            if (entry.elementType == in_elementType && entry.shape == in_shape.getDimExtents() && entry.data == in_data)
+            {
+                return entry.tensorName;
+            }
+        }
+
+        if (m_maxGateTensors > 0 && m_gateTensorNames.size() >= m_maxGateTensors)
+        {
+            evictGateTensor();
+        }
+
+        const std::string tensorName = m_namePrefix + "_Gate_" + std::to_string(m_tensorCounter++);
+        const bool created = exatn::createTensor(tensorName, in_elementType, in_shape);
+        assert(created);
+        // Gate matrices are always given in double precision.
+        const bool initialized = (in_elementType == exatn::TensorElementType::COMPLEX32) ?
+            exatn::initTensorData(tensorName, std::vector<std::complex<float>>(in_data.begin(), in_data.end())) :
+            exatn::initTensorData(tensorName, in_data);
+        assert(initialized);
+        m_gateTensors[in_gateName].emplace_back(GateTensorEntry{ tensorName, in_elementType, in_shape.getDimExtents(), in_data });
+        m_gateTensorNames.emplace_back(in_gateName, tensorName);
+        return tensorName;
+    }
+
+    // Is this tensor owned (hence, will be destroyed) by this pool?
+    bool contains(const std::string& in_tensorName) const
+    {
+        if (m_usedScratchTensors.find(in_tensorName) != m_usedScratchTensors.end())
+        {
+            return true;
+        }
+        if (m_freeScratchTensorKeys.find(in_tensorName) != m_freeScratchTensorKeys.end())
+        {
+            return true;
+        }
+        return std::find_if(m_gateTensorNames.begin(), m_gateTensorNames.end(), [&in_tensorName](const auto& in_entry) {
+            return in_entry.second == in_tensorName;
+        }) != m_gateTensorNames.end();
+    }
+
+    // Destroys all the tensors of this pool.
+    // Scratch tensors must all have been released.
+    void clear()
+    {
+        assert(m_usedScratchTensors.empty());
+        for (const auto& [freeKey, freeList] : m_freeScratchTensors)
+        {
+            for (const auto& tensorName : freeList)
+            {
+                const bool destroyed = exatn::destroyTensor(tensorName);
+                assert(destroyed);
+            }
+        }
+        for (const auto& [gateName, tensorName] : m_gateTensorNames)
+        {
+            const bool destroyed = exatn::destroyTensor(tensorName);
+            assert(destroyed);
+        }
+        m_freeScratchTensors.clear();
+        m_freeScratchTensorKeys.clear();
+        m_freeScratchOrder.clear();
+        m_freeScratchBytes = 0;
+        m_usedScratchTensors.clear();
+        m_gateTensors.clear();
+        m_gateTensorNames.clear();
+    }
+
+private:
+    using ScratchKey = std::pair<exatn::TensorElementType, std::vector<exatn::DimExtent>>;
+
+    static size_t getTensorBytes(const ScratchKey& in_key)
+    {
+        size_t elementBytes = sizeof(std::complex<double>);
+        switch (in_key.first)
+        {
+            case exatn::TensorElementType::REAL32: elementBytes = sizeof(float); break;
+            case exatn::TensorElementType::REAL64: elementBytes = sizeof(double); break;
+            case exatn::TensorElementType::COMPLEX32: elementBytes = sizeof(std::complex<float>); break;
+            default: break;
+        }
+        size_t volume = 1;
+        for (const auto& extent : in_key.second)
+        {
+            volume *= extent;
+        }
+        return volume * elementBytes;
+    }
+
+    // Destroys the least recently released free scratch tensor.
+    void evictFreeScratchTensor()
+    {
+        const std::string tensorName = m_freeScratchOrder.front();
+        m_freeScratchOrder.pop_front();
+        const auto keyIter = m_freeScratchTensorKeys.find(tensorName);
+        assert(keyIter != m_freeScratchTensorKeys.end());
+        auto& freeList = m_freeScratchTensors[keyIter->second];
+        freeList.erase(std::find(freeList.begin(), freeList.end(), tensorName));
+        if (freeList.empty())
+        {
+            m_freeScratchTensors.erase(keyIter->second);
+        }
+        m_freeScratchBytes -= getTensorBytes(keyIter->second);
+        m_freeScratchTensorKeys.erase(keyIter);
+        // The runtime orders the destroy after any pending operations on this tensor.
+        const bool destroyed = exatn::destroyTensor(tensorName);
+        assert(destroyed);
+    }
+
+    void evictGateTensor()
+    {
+        const std::string gateName = m_gateTensorNames.front().first;
+        const std::string tensorName = m_gateTensorNames.front().second;
+        m_gateTensorNames.pop_front();
+        auto& entries = m_gateTensors[gateName];
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [&tensorName](const GateTensorEntry& in_entry) {
+            return in_entry.tensorName == tensorName;
+        }), entries.end());
+        if (entries.empty())
+        {
+            m_gateTensors.erase(gateName);
+        }
+        // The runtime orders the destroy after any pending operations on this tensor.
+        const bool destroyed = exatn::destroyTensor(tensorName);
+        assert(destroyed);
+    }
+
+    struct GateTensorEntry
+    {
+        std::string tensorName;
+        exatn::TensorElementType elementType;
+        std::vector<exatn::DimExtent> shape;
+        std::vector<std::complex<double>> data;
+    };
+
+    std::string m_namePrefix;
+    size_t m_maxGateTensors;
+    size_t m_maxFreeScratchBytes;
+    size_t m_freeScratchBytes;
+    size_t m_tensorCounter;
+    // Free scratch tensors by shape.
+    std::map<ScratchKey, std::vector<std::string>> m_freeScratchTensors;
+    // Free scratch tensors => shape.
+    std::unordered_map<std::string, ScratchKey> m_freeScratchTensorKeys;
+    // Free scratch tensors in release order (for eviction).
+    std::deque<std::string> m_freeScratchOrder;
+    // Scratch tensors in use => shape.
+    std::unordered_map<std::string, ScratchKey> m_usedScratchTensors;
+    // Gate tensors by gate name.
+    std::unordered_map<std::string, std::vector<GateTensorEntry>> m_gateTensors;
+    // (Gate name, tensor name) in creation order (for eviction).
+    std::deque<std::pair<std::string, std::string>> m_gateTensorNames;
+};
+} // namespace tnqvm
@@ -61,6 +61,19 @@ public:
   virtual void initialize(std::shared_ptr<AcceleratorBuffer> buffer, int nbShots = 1) = 0;
   virtual const double
   getExpectationValueZ(std::shared_ptr<CompositeInstruction> function) = 0;
+  // Batched exp-val-z calculation (VQE mode): returns the expectation value of
+  // each observed sub-circuit (same order as the input list).
+  // Visitors can override this to share work across sub-circuits,
+  // e.g. terms that require the same change of basis.
+  virtual std::vector<double> getExpectationValueZBatch(
+      const std::vector<std::shared_ptr<CompositeInstruction>> &functions) {
+    std::vector<double> result;
+    result.reserve(functions.size());
+    for (auto &function : functions) {
+      result.emplace_back(getExpectationValueZ(function));
+    }
+    return result;
+  }
 
   virtual const std::vector<std::complex<double>> getState() {
     return std::vector<std::complex<double>>{};
@@ -71,10 +84,38 @@ public:
   // Does this visitor implementation support VQE mode execution?
   // i.e. ability to cache the state vector after simulating the ansatz.
   virtual bool supportVqeMode() const { return false; }
+  // Can this visitor apply two-qubit gates on non-adjacent qubits directly?
+  // If not, MPS-based visitors require a nearest-neighbor transform of the circuit.
+  virtual bool supportLongRangeGates() const { return false; }
+  // Applies a generic k-qubit gate given as a (2^k x 2^k) unitary matrix.
+  // Matrix basis: in_qubits[0] is the most significant bit.
+  virtual void applyGateMatrix(
+      const std::vector<size_t> &in_qubits,
+      const std::vector<std::vector<std::complex<double>>> &in_matrix) {
+    xacc::error("Visitor '" + name() + "' doesn't support generic k-qubit gates.");
+  }
   // Execution information that visitor wants to persist.
   HeterogeneousMap getExecutionInfo() const { return executionInfo; }
 
 protected:
+  // Checks the qubits of a generic gate (see applyGateMatrix):
+  // they must be distinct and within the in_nbQubits-qubit register.
+  static void validateGateQubits(const std::vector<size_t> &in_qubits,
+                                 size_t in_nbQubits) {
+    for (size_t i = 0; i < in_qubits.size(); ++i) {
+      if (in_qubits[i] >= in_nbQubits) {
+        xacc::error("Gate qubit " + std::to_string(in_qubits[i]) +
+                    " is out of range (number of qubits: " +
+                    std::to_string(in_nbQubits) + ").");
+      }
+      for (size_t j = 0; j < i; ++j) {
+        if (in_qubits[j] == in_qubits[i]) {
+          xacc::error("Duplicate gate qubit " + std::to_string(in_qubits[i]) + ".");
+        }
+      }
+    }
+  }
+
   std::shared_ptr<AcceleratorBuffer> buffer;
   HeterogeneousMap options;
   // Visitor impl to set if need be.
@@ -1,4 +1,5 @@
 #include "ExaTnDmVisitor.hpp"
+#include "ExaTnSamplingUtils.hpp"
 #include "tensor_basic.hpp"
 #include "talshxx.hpp"
 #include "utils/GateMatrixAlgebra.hpp"
@@ -128,8 +129,8 @@ std::vector<std::vector<std::complex<double>>> conjugateMatrix(
   return result;
 }
 
-std::vector<std::complex<double>>
-getGateMatrix(const xacc::Instruction &in_gate, bool in_dagger = false) {
+std::vector<std::vector<std::complex<double>>>
+getUnitaryMatrix(const xacc::Instruction &in_gate) {
   using namespace tnqvm;
   const auto gateEnum = GetGateType(in_gate.name());
   const auto getMatrix = [&]() {
@@ -177,11 +178,48 @@ getGateMatrix(const xacc::Instruction &in_gate, bool in_dagger = false) {
     }
   };  
 
-  const auto gateMatrix = getMatrix();
+  return getMatrix();
+}
+
+std::vector<std::complex<double>>
+getGateMatrix(const xacc::Instruction &in_gate, bool in_dagger = false) {
+  const auto gateMatrix = getUnitaryMatrix(in_gate);
   return in_dagger ? flattenGateMatrix(conjugateMatrix(gateMatrix))
                    : flattenGateMatrix(gateMatrix);
 }
 
+// Max number of qubits of a fused superoperator (4^k x 4^k matrix, rank-4k tensor).
+// Larger unitaries (applyGateMatrix) are appended as separate U and U* tensors.
+constexpr size_t MAX_SUPEROP_QUBITS = 2;
+
+// Density matrix legs of a superoperator: the ket legs (qubits), then the bra
+// legs (qubits + nbQubits), the first one being the MSB.
+std::vector<size_t> getSuperOpLegs(const std::vector<size_t> &in_qubits,
+                                   size_t in_nbQubits) {
+  std::vector<size_t> legs(in_qubits);
+  for (const auto &qubit : in_qubits) {
+    legs.emplace_back(qubit + in_nbQubits);
+  }
+  return legs;
+}
+
+// Lookup key of a (fused) superoperator tensor in the tensor pool.
+std::string getSuperOpKey(const std::vector<std::complex<double>> &in_data) {
+  size_t seed = in_data.size();
+  const auto hashCombine = [&seed](double in_val) {
+    seed ^= std::hash<double>{}(in_val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+  for (const auto &elem : in_data) {
+    hashCombine(elem.real());
+    hashCombine(elem.imag());
+  }
+  return "SUPEROP_" + std::to_string(seed);
+}
+
+// Max number of qubits whose marginal distribution is computed by a single
+// contraction (2^k probabilities) when sampling the measured qubits.
+constexpr size_t MAX_SAMPLING_BLOCK_QUBITS = 12;
+
 void recursiveFindAllCombinations(std::vector<std::vector<unsigned int>>& io_result,
 const std::vector<unsigned int> &arr,
                 std::vector<unsigned int> &data, int start, int end, int index,
@@ -296,7 +334,10 @@ void checkKrausTensorConfig(const exatn::TensorNetwork &in_tensorNet,
 } // namespace
 
 namespace tnqvm {
-ExaTnDmVisitor::ExaTnDmVisitor() {
+// Note: gate tensors are referenced by the density matrix network until it is
+// evaluated (finalize), hence the tensor pool doesn't evict any of them.
+ExaTnDmVisitor::ExaTnDmVisitor()
+    : m_tensorPool("Dm"), m_noiseTensorCache("DmNoise") {
   // TODO
 }
 
@@ -334,10 +375,26 @@ void ExaTnDmVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer,
   m_buffer = buffer;
   m_tensorNetwork = buildInitialNetwork(buffer->size());
   m_tensorIdCounter = m_tensorNetwork.getMaxTensorId();
+  m_superOps.clear();
+  m_latestSuperOpIdx.assign(buffer->size(), -1);
+  m_measuredBits.clear();
+  m_nbShots = nbShots;
+  m_marginalQubits.clear();
+  if (options.keyExists<std::vector<int>>("marginal-qubits")) {
+    for (const auto &qubit : options.get<std::vector<int>>("marginal-qubits")) {
+      if (qubit < 0 || static_cast<size_t>(qubit) >= buffer->size()) {
+        xacc::error("Invalid marginal qubit index: " + std::to_string(qubit));
+      }
+      m_marginalQubits.emplace_back(qubit);
+    }
+  }
   if (options.pointerLikeExists<xacc::NoiseModel>("noise-model")) {
     m_noiseConfig = xacc::as_shared_ptr(
         options.getPointerLike<xacc::NoiseModel>("noise-model"));
   }
+  if (m_noiseConfig) {
+    m_noiseTensorCache.setNoiseModel(m_noiseConfig);
+  }
 }
 
 exatn::TensorNetwork
@@ -370,6 +427,7 @@ ExaTnDmVisitor::buildInitialNetwork(size_t in_nbQubits) const {
 
 void ExaTnDmVisitor::finalize() {
   executionInfo.clear();
+  appendSuperOperators();
   // Max number of qubits that we allow for a full density matrix retrieval.
   // For more qubits, only expectation contraction is supported.
   constexpr size_t MAX_SIZE_TO_COLLAPSE_DM = 10; 
@@ -419,21 +477,13 @@ void ExaTnDmVisitor::finalize() {
   if (!m_measuredBits.empty()) {
     auto tensorIdCounter = m_tensorIdCounter;
     auto expValTensorNet = m_tensorNetwork;
-    const std::string measZTensorName = "MEAS_Z";
-    {
+    const std::string measZTensorName = [&]() {
       xacc::quantum::Z zGate(0);
       const auto gateMatrix = getGateMatrix(zGate);
       assert(gateMatrix.size() == 4);
-      // Create the tensor
-      const bool created = exatn::createTensorSync(
-          measZTensorName, exatn::TensorElementType::COMPLEX64,
-          exatn::TensorShape{2, 2});
-      assert(created);
-      // Init tensor body data
-      const bool initialized =
-          exatn::initTensorDataSync(measZTensorName, gateMatrix);
-      assert(initialized);
-    }
+      return m_tensorPool.getGateTensor(zGate.name(), exatn::TensorShape{2, 2},
+                                        gateMatrix);
+    }();
     // Add Z tensors for measurement
     for (const auto &measBit : m_measuredBits) {
       tensorIdCounter++;
@@ -452,20 +502,12 @@ void ExaTnDmVisitor::finalize() {
     // std::cout << "TENSOR NETWORK TO COMPUTE THE TRACE:\n";
     // printDensityMatrix(expValTensorNet, m_buffer->size(), false);
     // Compute the trace, closing the tensor network:
-    const std::string idTensor = "ID_TRACE";
-    {
+    const std::string idTensor = [&]() {
       xacc::quantum::Identity idGate(0);
       const auto idGateMatrix = getGateMatrix(idGate);
-      // Create the tensor
-      const bool created =
-          exatn::createTensorSync(idTensor, exatn::TensorElementType::COMPLEX64,
-                                  exatn::TensorShape{2, 2});
-      assert(created);
-      // Init tensor body data
-      const bool initialized =
-          exatn::initTensorDataSync(idTensor, idGateMatrix);
-      assert(initialized);
-    }
+      return m_tensorPool.getGateTensor(idGate.name(), exatn::TensorShape{2, 2},
+                                        idGateMatrix);
+    }();
 
     for (size_t qId = 0; qId < m_buffer->size(); ++qId) {
       tensorIdCounter++;
@@ -498,18 +540,28 @@ void ExaTnDmVisitor::finalize() {
         m_buffer->addExtraInfo("exp-val-z", expValZ);
       }
     }
-    bool destroyed = exatn::destroyTensor(measZTensorName);
-    assert(destroyed);
-    destroyed = exatn::destroyTensor(idTensor);
-    assert(destroyed);
+  }
+
+  if (!m_marginalQubits.empty()) {
+    m_buffer->addExtraInfo("marginal-probabilities",
+                           computeMarginalProbabilities(m_marginalQubits));
+  }
+
+  // Shot sampling (the full density matrix is never formed)
+  if (m_nbShots > 0 && !m_measuredBits.empty()) {
+    for (const auto &bitString : sampleMeasuredBits(m_nbShots)) {
+      m_buffer->appendMeasurement(bitString);
+    }
   }
 
   std::unordered_set<std::string> tensorList;
   for (auto iter = m_tensorNetwork.cbegin(); iter != m_tensorNetwork.cend();
        ++iter) {
     const auto &tensorName = iter->second.getTensor()->getName();
-    // Not a root tensor
-    if (!tensorName.empty() && tensorName[0] != '_') {
+    // Not a root tensor nor a pooled (gate or noise) tensor
+    if (!tensorName.empty() && tensorName[0] != '_' &&
+        !m_tensorPool.contains(tensorName) &&
+        !m_noiseTensorCache.contains(tensorName)) {
       tensorList.emplace(iter->second.getTensor()->getName());
     }
   }
@@ -518,6 +570,9 @@ void ExaTnDmVisitor::finalize() {
     const bool destroyed = exatn::destroyTensor(tensorName);
     assert(destroyed);
   }
+  m_tensorPool.clear();
+  executionInfo.insert("noise-cache-misses", static_cast<int>(m_noiseTensorCache.getNbCacheMisses()));
+  m_noiseTensorCache.resetNbCacheMisses();
 
   m_buffer.reset();
   m_noiseConfig.reset();
@@ -525,140 +580,69 @@ void ExaTnDmVisitor::finalize() {
 
 void ExaTnDmVisitor::applySingleQubitGate(
     xacc::quantum::Gate &in_gateInstruction) {
-  {
-    m_tensorIdCounter++;
-    assert(in_gateInstruction.bits().size() == 1);
-    const auto gateMatrix = getGateMatrix(in_gateInstruction);
-    // std::cout << "Gate mattrix:\n";
-    // for (const auto &el : gateMatrix) {
-    //   std::cout << el << "\n";
-    // }
-    assert(gateMatrix.size() == 4);
-    const std::string uniqueGateName =
-        in_gateInstruction.name() + std::to_string(m_tensorIdCounter);
-    // Create the tensor
-    const bool created = exatn::createTensorSync(
-        uniqueGateName, exatn::TensorElementType::COMPLEX64,
-        exatn::TensorShape{2, 2});
-    assert(created);
-    // Init tensor body data
-    const bool initialized =
-        exatn::initTensorDataSync(uniqueGateName, gateMatrix);
-    assert(initialized);
-
-    const std::vector<unsigned int> gatePairing{
-        static_cast<unsigned int>(in_gateInstruction.bits()[0])};
-    // Append the tensor for this gate to the network
-    const bool appended = m_tensorNetwork.appendTensorGate(
-        m_tensorIdCounter,
-        // Get the gate tensor data which must have been initialized.
-        exatn::getTensor(uniqueGateName),
-        // which qubits that the gate is acting on
-        gatePairing);
-    assert(appended);
-  }
-
-  {
-    // Append the dagger gate
-    m_tensorIdCounter++;
-    const auto gateMatrix = getGateMatrix(in_gateInstruction, true);
-    // std::cout << "Gate mattrix dagger:\n";
-    // for (const auto &el : gateMatrix) {
-    //   std::cout << el << "\n";
-    // }
-    assert(gateMatrix.size() == 4);
-    const std::string uniqueGateName =
-        in_gateInstruction.name() + "_CONJ_" + std::to_string(m_tensorIdCounter);
-    // Create the tensor
-    const bool created = exatn::createTensorSync(
-        uniqueGateName, exatn::TensorElementType::COMPLEX64,
-        exatn::TensorShape{2, 2});
-    assert(created);
-    // Init tensor body data
-    const bool initialized =
-        exatn::initTensorDataSync(uniqueGateName, gateMatrix);
-    assert(initialized);
-    const std::vector<unsigned int> gatePairingConj{static_cast<unsigned int>(
-        m_buffer->size() + in_gateInstruction.bits()[0])};
-    const bool conjAppended = m_tensorNetwork.appendTensorGate(
-        m_tensorIdCounter,
-        // Get the gate tensor data which must have been initialized.
-        exatn::getTensor(uniqueGateName),
-        // which qubits that the gate is acting on
-        gatePairingConj);
-    assert(conjAppended);
-  }
-
-  // DEBUG
-  // std::cout << "Before noise:\n";
-  // m_tensorNetwork.printIt();
-
+  assert(in_gateInstruction.bits().size() == 1);
+  // U (x) U* on the ket and bra legs (one tensor), fused with the noise
+  // channels.
+  queueSuperOperator(
+      in_gateInstruction.bits(),
+      GetSuperOperatorMatrix({getUnitaryMatrix(in_gateInstruction)}));
   // Adding noise tensors.
   applyNoise(in_gateInstruction);
 }
 
 void ExaTnDmVisitor::applyTwoQubitGate(
     xacc::quantum::Gate &in_gateInstruction) {
+  assert(in_gateInstruction.bits().size() == 2);
+  // Gate matrix basis: bits()[0] is the MSB.
+  queueSuperOperator(
+      in_gateInstruction.bits(),
+      GetSuperOperatorMatrix({getUnitaryMatrix(in_gateInstruction)}));
+  // Adding noise tensors.
+  applyNoise(in_gateInstruction);
+}
+
+void ExaTnDmVisitor::applyGateMatrix(
+    const std::vector<size_t> &in_qubits,
+    const std::vector<std::vector<std::complex<double>>> &in_matrix) {
+  if (in_qubits.empty() || (1ULL << in_qubits.size()) != in_matrix.size()) {
+    xacc::error("Gate matrix dimension doesn't match the number of qubits.");
+  }
+  validateGateQubits(in_qubits, m_buffer->size());
+  if (in_qubits.size() <= MAX_SUPEROP_QUBITS) {
+    queueSuperOperator(in_qubits, GetSuperOperatorMatrix({in_matrix}));
+    return;
+  }
+  // Keep the order of the operations.
+  appendSuperOperators();
+  // Rank-2k gate tensor; the first qubit is the MSB (last leg) of the matrix.
+  const exatn::TensorShape gateShape(
+      std::vector<exatn::DimExtent>(2 * in_qubits.size(), 2));
+  const std::string gateKey = "UNITARY" + std::to_string(in_qubits.size());
   {
     m_tensorIdCounter++;
-    assert(in_gateInstruction.bits().size() == 2);
-    const auto gateMatrix = getGateMatrix(in_gateInstruction);
-    assert(gateMatrix.size() == 16);
-    const std::string uniqueGateName =
-        in_gateInstruction.name() + std::to_string(m_tensorIdCounter);
-    // Create the tensor
-    const bool created = exatn::createTensorSync(
-        uniqueGateName, exatn::TensorElementType::COMPLEX64,
-        exatn::TensorShape{2, 2, 2, 2});
-    assert(created);
-    // Init tensor body data
-    const bool initialized =
-        exatn::initTensorDataSync(uniqueGateName, gateMatrix);
-    assert(initialized);
-
-    const std::vector<unsigned int> gatePairing{
-        static_cast<unsigned int>(in_gateInstruction.bits()[1]),
-        static_cast<unsigned int>(in_gateInstruction.bits()[0])};
-    // Append the tensor for this gate to the network
+    const std::string uniqueGateName = m_tensorPool.getGateTensor(
+        gateKey, gateShape, flattenGateMatrix(in_matrix));
+    std::vector<unsigned int> gatePairing;
+    for (auto iter = in_qubits.rbegin(); iter != in_qubits.rend(); ++iter) {
+      gatePairing.emplace_back(*iter);
+    }
     const bool appended = m_tensorNetwork.appendTensorGate(
-        m_tensorIdCounter,
-        // Get the gate tensor data which must have been initialized.
-        exatn::getTensor(uniqueGateName),
-        // which qubits that the gate is acting on
-        gatePairing);
+        m_tensorIdCounter, exatn::getTensor(uniqueGateName), gatePairing);
     assert(appended);
   }
   {
     m_tensorIdCounter++;
-    const auto gateMatrix = getGateMatrix(in_gateInstruction, true);
-    assert(gateMatrix.size() == 16);
-    const std::string uniqueGateName =
-        in_gateInstruction.name() + "_CONJ_" + std::to_string(m_tensorIdCounter);
-    // Create the tensor
-    const bool created = exatn::createTensorSync(
-        uniqueGateName, exatn::TensorElementType::COMPLEX64,
-        exatn::TensorShape{2, 2, 2, 2});
-    assert(created);
-    // Init tensor body data
-    const bool initialized =
-        exatn::initTensorDataSync(uniqueGateName, gateMatrix);
-    assert(initialized);
-    const std::vector<unsigned int> gatePairingConj{
-        static_cast<unsigned int>(m_buffer->size() +
-                                  in_gateInstruction.bits()[1]),
-        static_cast<unsigned int>(m_buffer->size() +
-                                  in_gateInstruction.bits()[0])};
+    const std::string uniqueGateName = m_tensorPool.getGateTensor(
+        gateKey + "_CONJ", gateShape,
+        flattenGateMatrix(conjugateMatrix(in_matrix)));
+    std::vector<unsigned int> gatePairingConj;
+    for (auto iter = in_qubits.rbegin(); iter != in_qubits.rend(); ++iter) {
+      gatePairingConj.emplace_back(m_buffer->size() + *iter);
+    }
     const bool conjAppended = m_tensorNetwork.appendTensorGate(
-        m_tensorIdCounter,
-        // Get the gate tensor data which must have been initialized.
-        exatn::getTensor(uniqueGateName),
-        // which qubits that the gate is acting on
-        gatePairingConj);
+        m_tensorIdCounter, exatn::getTensor(uniqueGateName), gatePairingConj);
     assert(conjAppended);
   }
-
-  // Adding noise tensors.
-  applyNoise(in_gateInstruction);
 }
 
 void ExaTnDmVisitor::applyNoise(xacc::quantum::Gate &in_gateInstruction) {
@@ -668,98 +652,11 @@ void ExaTnDmVisitor::applyNoise(xacc::quantum::Gate &in_gateInstruction) {
   // std::cout << "Before noise:\n";
   // printDensityMatrix(m_tensorNetwork, m_buffer->size());
 
-  const auto noiseChannels =
-      m_noiseConfig->getNoiseChannels(in_gateInstruction);
-  auto noiseUtils = xacc::getService<NoiseModelUtils>("default");
-
-  for (auto &channel : noiseChannels) {
-    auto noiseMat = noiseUtils->krausToChoi(channel.mats);
-
-    // for (const auto &row : noiseMat) {
-    //   for (const auto &el : row) {
-    //     std::cout << el << " ";
-    //   }
-    //   std::cout << "\n";
-    // }
-
-    m_tensorIdCounter++;
-    const std::string noiseTensorName = in_gateInstruction.name() + "_Noise_" +
-                                        std::to_string(m_tensorIdCounter);
-    if (channel.noise_qubits.size() == 1) {
-      // Create the tensor
-      const bool created = exatn::createTensorSync(
-          noiseTensorName, exatn::TensorElementType::COMPLEX64,
-          exatn::TensorShape{2, 2, 2, 2});
-      assert(created);
-      // Init tensor body data
-      const bool initialized = exatn::initTensorDataSync(
-          noiseTensorName, flattenGateMatrix(noiseMat));
-      assert(initialized);
-
-      const std::vector<
-          std::pair<unsigned int, std::pair<unsigned int, unsigned int>>>
-          noisePairing{
-              {static_cast<unsigned int>(channel.noise_qubits[0]), {1, 0}},
-              {static_cast<unsigned int>(channel.noise_qubits[0] +
-                                         m_buffer->size()),
-               {3, 2}}};
-      // Append the tensor for this gate to the network
-      const bool appended = m_tensorNetwork.appendTensorGateGeneral(
-          m_tensorIdCounter, exatn::getTensor(noiseTensorName),
-          // which qubits that the gate is acting on
-          noisePairing);
-      assert(appended);
-    } else if (channel.noise_qubits.size() == 2) {
-      // Create the tensor
-      const bool created = exatn::createTensorSync(
-          noiseTensorName, exatn::TensorElementType::COMPLEX64,
-          exatn::TensorShape{2, 2, 2, 2, 2, 2, 2, 2});
-      assert(created);
-      // Init tensor body data
-      const bool initialized = exatn::initTensorDataSync(
-          noiseTensorName, flattenGateMatrix(noiseMat));
-      assert(initialized);
-
-      // DEBUG: Using this to check all possible permutations.
-      // checkKrausTensorConfig(m_tensorNetwork, channel.noise_qubits[0],
-      //                        channel.noise_qubits[1], m_buffer->size(),
-      //                        noiseTensorName);
-
-      const std::vector<
-          std::pair<unsigned int, std::pair<unsigned int, unsigned int>>>
-          noisePairingMsb{
-              {static_cast<unsigned int>(channel.noise_qubits[0]), {5, 6}},
-              {static_cast<unsigned int>(channel.noise_qubits[0] +
-                                         m_buffer->size()),
-               {1, 2}},
-              {static_cast<unsigned int>(channel.noise_qubits[1]), {4, 7}},
-              {static_cast<unsigned int>(channel.noise_qubits[1] +
-                                         m_buffer->size()),
-               {0, 3}}};
-
-      const std::vector<
-          std::pair<unsigned int, std::pair<unsigned int, unsigned int>>>
-          noisePairingLsb{
-              {static_cast<unsigned int>(channel.noise_qubits[1]), {5, 6}},
-              {static_cast<unsigned int>(channel.noise_qubits[1] +
-                                         m_buffer->size()),
-               {1, 2}},
-              {static_cast<unsigned int>(channel.noise_qubits[0]), {4, 7}},
-              {static_cast<unsigned int>(channel.noise_qubits[0] +
-                                         m_buffer->size()),
-               {0, 3}}};
-      const auto noisePairing = (channel.bit_order == KrausMatBitOrder::MSB)
-                                    ? noisePairingMsb
-                                    : noisePairingLsb;
-      // Append the tensor for this gate to the network
-      const bool appended = m_tensorNetwork.appendTensorGateGeneral(
-          m_tensorIdCounter, exatn::getTensor(noiseTensorName),
-          // which qubits that the gate is acting on
-          noisePairing);
-      assert(appended);
-    } else {
-      xacc::error("Unsupported noise data.");
-    }
+  // Noise superoperators (converted once per gate and qubits), fused into the
+  // gate superoperator.
+  for (const auto &noiseSuperOp :
+       m_noiseTensorCache.getNoiseSuperOperators(in_gateInstruction)) {
+    queueSuperOperator(noiseSuperOp.qubits, noiseSuperOp.matrix);
   }
 
   // DEBUG:
@@ -768,6 +665,69 @@ void ExaTnDmVisitor::applyNoise(xacc::quantum::Gate &in_gateInstruction) {
   // printDensityMatrix(m_tensorNetwork, m_buffer->size());
 }
 
+void ExaTnDmVisitor::queueSuperOperator(
+    const std::vector<size_t> &in_qubits,
+    const std::vector<std::vector<std::complex<double>>> &in_superOp) {
+  assert(in_superOp.size() == (1ULL << (2 * in_qubits.size())));
+  // The latest queued superoperator acting on any of these qubits:
+  // the ones queued after it commute with this one.
+  int latestIdx = -1;
+  for (const auto &qubit : in_qubits) {
+    latestIdx = std::max(latestIdx, m_latestSuperOpIdx[qubit]);
+  }
+
+  if (latestIdx >= 0) {
+    auto &latestSuperOp = m_superOps[latestIdx];
+    std::vector<size_t> fusedQubits(latestSuperOp.qubits);
+    for (const auto &qubit : in_qubits) {
+      if (!xacc::container::contains(fusedQubits, qubit)) {
+        fusedQubits.emplace_back(qubit);
+      }
+    }
+
+    if (fusedQubits.size() <= MAX_SUPEROP_QUBITS) {
+      const auto nbQubits = m_buffer->size();
+      const auto fusedLegs = getSuperOpLegs(fusedQubits, nbQubits);
+      latestSuperOp.matrix = MultiplyGateMatrices(
+          ExpandGateMatrix(in_superOp, getSuperOpLegs(in_qubits, nbQubits),
+                           fusedLegs),
+          ExpandGateMatrix(latestSuperOp.matrix,
+                           getSuperOpLegs(latestSuperOp.qubits, nbQubits),
+                           fusedLegs));
+      latestSuperOp.qubits = fusedQubits;
+      for (const auto &qubit : in_qubits) {
+        m_latestSuperOpIdx[qubit] = latestIdx;
+      }
+      return;
+    }
+  }
+
+  m_superOps.emplace_back(SuperOperator{in_qubits, in_superOp});
+  for (const auto &qubit : in_qubits) {
+    m_latestSuperOpIdx[qubit] = static_cast<int>(m_superOps.size()) - 1;
+  }
+}
+
+void ExaTnDmVisitor::appendSuperOperators() {
+  for (const auto &superOp : m_superOps) {
+    m_tensorIdCounter++;
+    // Rank-4k tensor, same leg convention as applyGateMatrix() with the ket and
+    // bra legs of the density matrix.
+    const auto superOpData = flattenGateMatrix(superOp.matrix);
+    const exatn::TensorShape superOpShape(
+        std::vector<exatn::DimExtent>(4 * superOp.qubits.size(), 2));
+    const std::string uniqueGateName = m_tensorPool.getGateTensor(
+        getSuperOpKey(superOpData), superOpShape, superOpData);
+    const auto legs = getSuperOpLegs(superOp.qubits, m_buffer->size());
+    const std::vector<unsigned int> gatePairing(legs.rbegin(), legs.rend());
+    const bool appended = m_tensorNetwork.appendTensorGate(
+        m_tensorIdCounter, exatn::getTensor(uniqueGateName), gatePairing);
+    assert(appended);
+  }
+  m_superOps.clear();
+  std::fill(m_latestSuperOpIdx.begin(), m_latestSuperOpIdx.end(), -1);
+}
+
 void ExaTnDmVisitor::visit(Identity &in_IdentityGate) {
   applySingleQubitGate(in_IdentityGate);
 }
@@ -853,6 +813,137 @@ void ExaTnDmVisitor::visit(fSim &in_fsimGate) {
   applyTwoQubitGate(in_fsimGate);
 }
 
+std::vector<double> ExaTnDmVisitor::computeMarginalProbabilities(
+    const std::vector<size_t> &in_qubits,
+    const std::vector<std::pair<size_t, uint8_t>> &in_projectedBits) {
+  const auto nbQubits = m_buffer->size();
+  // Ket and bra legs of each qubit are closed by:
+  // the identity (trace), a projector (|0><0| or |1><1|) or a rank-3 diagonal
+  // tensor whose third leg is left open.
+  const std::string traceTensor = m_tensorPool.getGateTensor(
+      "I", exatn::TensorShape{2, 2}, {1.0, 0.0, 0.0, 1.0});
+  const std::string projectorTensors[2] = {
+      m_tensorPool.getGateTensor("PROJ0", exatn::TensorShape{2, 2},
+                                 {1.0, 0.0, 0.0, 0.0}),
+      m_tensorPool.getGateTensor("PROJ1", exatn::TensorShape{2, 2},
+                                 {0.0, 0.0, 0.0, 1.0})};
+  std::vector<std::complex<double>> diagData(8, 0.0);
+  diagData[0] = 1.0;
+  diagData[7] = 1.0;
+  const std::string diagTensor = m_tensorPool.getGateTensor(
+      "DIAG", exatn::TensorShape{2, 2, 2}, diagData);
+
+  std::vector<std::string> closingTensors(nbQubits, traceTensor);
+  for (const auto &[qubit, bit] : in_projectedBits) {
+    assert(qubit < nbQubits && bit < 2);
+    closingTensors[qubit] = projectorTensors[bit];
+  }
+  for (const auto &qubit : in_qubits) {
+    if (qubit >= nbQubits || closingTensors[qubit] != traceTensor) {
+      xacc::error("Invalid marginal qubits.");
+    }
+    closingTensors[qubit] = diagTensor;
+  }
+
+  auto tensorIdCounter = m_tensorIdCounter;
+  auto marginalTensorNet = m_tensorNetwork;
+  for (size_t qId = 0; qId < nbQubits; ++qId) {
+    tensorIdCounter++;
+    // Remaining legs: the ket legs, then the bra legs of qubits [qId, nbQubits),
+    // then the open diagonal legs (in qubit order).
+    const std::vector<std::pair<unsigned int, unsigned int>> pairing{
+        {static_cast<unsigned int>(0), 0},
+        {static_cast<unsigned int>(nbQubits - qId), 1}};
+    const bool appended = marginalTensorNet.appendTensor(
+        tensorIdCounter, exatn::getTensor(closingTensors[qId]), pairing);
+    assert(appended);
+  }
+  marginalTensorNet.rename("__MARGINAL__" + m_tensorNetwork.getName());
+  const bool evaledOk = exatn::evaluateSync(marginalTensorNet);
+  assert(evaledOk);
+
+  // Open legs are in increasing qubit order, the first leg being the fastest.
+  std::vector<size_t> sortedQubits(in_qubits);
+  std::sort(sortedQubits.begin(), sortedQubits.end());
+  std::vector<double> result(1ULL << in_qubits.size(), 0.0);
+  const std::string resultTensorName = marginalTensorNet.getTensor(0)->getName();
+  auto talsh_tensor = exatn::getLocalTensor(resultTensorName);
+  const std::complex<double> *body_ptr;
+  if (!talsh_tensor || !talsh_tensor->getDataAccessHostConst(&body_ptr)) {
+    xacc::error("Failed to retrieve tensor data!");
+  }
+  assert(talsh_tensor->getVolume() == result.size());
+  for (uint64_t i = 0; i < result.size(); ++i) {
+    uint64_t resultIdx = 0;
+    for (size_t j = 0; j < in_qubits.size(); ++j) {
+      const auto legId = std::distance(
+          sortedQubits.begin(),
+          std::find(sortedQubits.begin(), sortedQubits.end(), in_qubits[j]));
+      resultIdx = (resultIdx << 1) | ((i >> legId) & 1);
+    }
+    // Rounding errors
+    result[resultIdx] = std::max(body_ptr[i].real(), 0.0);
+  }
+  talsh_tensor.reset();
+  const bool destroyed = exatn::destroyTensorSync(resultTensorName);
+  assert(destroyed);
+  return result;
+}
+
+std::vector<std::string> ExaTnDmVisitor::sampleMeasuredBits(int in_nbShots) {
+  std::vector<size_t> measureQubits;
+  for (const auto &qubit : m_measuredBits) {
+    if (!xacc::container::contains(measureQubits, qubit)) {
+      measureQubits.emplace_back(qubit);
+    }
+  }
+  // Blocks of measured qubits: the marginal distribution of each block is
+  // conditioned on the values sampled for the previous blocks.
+  std::vector<std::vector<size_t>> blocks;
+  for (size_t i = 0; i < measureQubits.size(); i += MAX_SAMPLING_BLOCK_QUBITS) {
+    blocks.emplace_back(
+        measureQubits.begin() + i,
+        measureQubits.begin() +
+            std::min(i + MAX_SAMPLING_BLOCK_QUBITS, measureQubits.size()));
+  }
+
+  // Cumulative (unnormalized) distributions by sampled prefix: shots sharing
+  // a prefix share the contraction. With a single block (e.g. <= 12 measured
+  // qubits), all the shots are sampled from one marginal distribution.
+  std::unordered_map<std::string, std::vector<double>> cumulativeProbs;
+  std::vector<std::string> result;
+  result.reserve(in_nbShots);
+  for (int shotId = 0; shotId < in_nbShots; ++shotId) {
+    std::vector<uint8_t> sampledBits(m_buffer->size(), 0);
+    std::vector<std::pair<size_t, uint8_t>> projectedBits;
+    std::string prefix;
+    for (const auto &block : blocks) {
+      auto iter = cumulativeProbs.find(prefix);
+      if (iter == cumulativeProbs.end()) {
+        auto probs = computeMarginalProbabilities(block, projectedBits);
+        std::partial_sum(probs.begin(), probs.end(), probs.begin());
+        iter = cumulativeProbs.emplace(prefix, std::move(probs)).first;
+      }
+      const auto &cumulative = iter->second;
+      const double randProb = getRandomProbability() * cumulative.back();
+      const uint64_t sampledIdx = std::min<uint64_t>(
+          std::distance(cumulative.begin(),
+                        std::upper_bound(cumulative.begin(), cumulative.end(),
+                                         randProb)),
+          cumulative.size() - 1);
+      for (size_t j = 0; j < block.size(); ++j) {
+        const uint8_t bit = (sampledIdx >> (block.size() - 1 - j)) & 1;
+        sampledBits[block[j]] = bit;
+        projectedBits.emplace_back(block[j], bit);
+        prefix.push_back(bit ? '1' : '0');
+      }
+    }
+    result.emplace_back(generateResultBitString(sampledBits, m_measuredBits,
+                                                m_noiseConfig.get()));
+  }
+  return result;
+}
+
 const double ExaTnDmVisitor::getExpectationValueZ(
     std::shared_ptr<CompositeInstruction> in_function) {
   return 0.0;
@@ -3,6 +3,8 @@
 #include "TNQVMVisitor.hpp"
 #include "tensor_network.hpp"
 #include "exatn.hpp"
+#include "ExaTnTensorPool.hpp"
+#include "ExaTnNoiseTensorCache.hpp"
 
 // Full density matrix noisy visitor:
 // Name: "exatn-dm"
@@ -14,7 +16,13 @@
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
 // | backend                     | Name of the IBMQ backend to query the backend configuration.           |    string   | None                     |
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | marginal-qubits             | Qubits to compute the marginal (diagonal) probabilities of.            | vector<int> | <unused>                 |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
 // If either `backend-json` or `backend` is provided, the `exatn-dm` simulator will simulate the backend noise associated with each quantum gate.
+// If `shots` is provided, the measured bit strings are sampled from the (noisy) density matrix network.
+// The `marginal-qubits` probabilities are stored in the `marginal-probabilities` buffer info:
+// element i is the probability of the bit string i (binary representation), the first qubit being the MSB.
+// The execution info `noise-cache-misses` (int) is the number of distinct (gate, qubits) noise channels converted during the execution.
 
 namespace xacc {
 // Forward declaration
@@ -65,6 +73,8 @@ public:
     virtual void visit(fSim& in_fsimGate) override;
     // others
     virtual void visit(Measure& in_MeasureGate) override;
+    // Generic k-qubit gate (no noise channels are applied)
+    virtual void applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix) override;
 
     virtual const double getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function) override;
     class ExaTnTensorFunctor : public talsh::TensorFunctor<exatn::Identifiable>
@@ -87,13 +97,40 @@ public:
     void applySingleQubitGate(xacc::quantum::Gate& in_gateInstruction);
     void applyTwoQubitGate(xacc::quantum::Gate& in_gateInstruction);
     void applyNoise(xacc::quantum::Gate &in_gateInstruction);
+    // Marginal probabilities (2^k values, in_qubits[0] being the MSB) of the k qubits in_qubits,
+    // jointly with the projection of the in_projectedBits qubits onto the given values.
+    // Only the density matrix diagonal of these qubits is kept open: the other qubits are traced out.
+    std::vector<double> computeMarginalProbabilities(const std::vector<size_t>& in_qubits, const std::vector<std::pair<size_t, uint8_t>>& in_projectedBits = {});
+    // Samples the measured qubits (sequential conditional marginals over blocks of qubits).
+    std::vector<std::string> sampleMeasuredBits(int in_nbShots);
+    // Queues the superoperator (4^k x 4^k matrix) acting on the density matrix qubits in_qubits,
+    // fusing it into the latest queued superoperator on these qubits when possible.
+    void queueSuperOperator(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_superOp);
+    // Appends the queued superoperators to the tensor network (one tensor each).
+    void appendSuperOperators();
     
   private:
+    struct SuperOperator
+    {
+        // The first qubit is the MSB of the (ket and bra) matrix basis.
+        std::vector<size_t> qubits;
+        std::vector<std::vector<std::complex<double>>> matrix;
+    };
     exatn::TensorNetwork m_tensorNetwork;
     std::shared_ptr<AcceleratorBuffer> m_buffer;
     std::vector<size_t> m_measuredBits;
+    // Qubits to compute the marginal probabilities of (option)
+    std::vector<size_t> m_marginalQubits;
     int m_nbShots;
     int m_tensorIdCounter;
     std::shared_ptr<xacc::NoiseModel> m_noiseConfig;
+    // Gate tensors (shared by all the instances of the same gate)
+    ExaTnTensorPool m_tensorPool;
+    // Noise channel superoperators by (gate, qubits), kept across executions of the same noise model
+    ExaTnNoiseTensorCache m_noiseTensorCache;
+    // Gates (U x U*) fused with their noise channels, not yet appended to the network (in order).
+    std::vector<SuperOperator> m_superOps;
+    // Index of the latest queued superoperator acting on each qubit (-1 if none).
+    std::vector<int> m_latestSuperOpIdx;
 };
 } // namespace tnqvm
\ No newline at end of file
@@ -269,6 +269,89 @@ TEST(JsonNoiseModelTester, checkSimple) {
   }
 }
 
+TEST(JsonNoiseModelTester, checkNoiseTensorReuse) {
+  auto noiseModel = xacc::getService<xacc::NoiseModel>("json");
+  noiseModel->initialize({{"noise-model", depol_json}});
+  auto accelerator = xacc::getAccelerator(
+      "tnqvm", {{"tnqvm-visitor", "exatn-dm"}, {"noise-model", noiseModel}});
+  auto xasmCompiler = xacc::getCompiler("xasm");
+  // The same noise channel after every X gate
+  auto program = xasmCompiler
+                     ->compile(R"(__qpu__ void testXXX(qbit q) {
+        X(q[0]);
+        X(q[0]);
+        X(q[0]);
+        Measure(q[0]);
+      })",
+                               accelerator)
+                     ->getComposite("testXXX");
+  std::vector<std::vector<std::complex<double>>> firstDm;
+  // The cache is kept across executions of the same noise model.
+  for (int i = 0; i < 2; ++i) {
+    auto buffer = xacc::qalloc(1);
+    accelerator->execute(buffer, program);
+    // The three X gates share one noise channel conversion,
+    // which the second execution reuses.
+    EXPECT_EQ(accelerator->getExecutionInfo().get<int>("noise-cache-misses"),
+              i == 0 ? 1 : 0);
+    auto densityMatrix =
+        *(accelerator
+              ->getExecutionInfo<xacc::ExecutionInfo::DensityMatrixPtrType>(
+                  xacc::ExecutionInfo::DmKey));
+    EXPECT_TRUE(validateDensityMatrix(densityMatrix));
+    // Depolarizing after each X: |1> population is reduced
+    EXPECT_LT(densityMatrix[1][1].real(), 0.99333333);
+    EXPECT_GT(densityMatrix[1][1].real(), 0.9);
+    if (i == 0) {
+      firstDm = densityMatrix;
+    } else {
+      for (size_t row = 0; row < 2; ++row) {
+        for (size_t col = 0; col < 2; ++col) {
+          EXPECT_NEAR(std::abs(densityMatrix[row][col] - firstDm[row][col]),
+                      0.0, 1e-12);
+        }
+      }
+    }
+  }
+}
+
+TEST(JsonNoiseModelTester, checkSuperOperatorFusion) {
+  auto accelerator =
+      xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-dm"}});
+  auto xasmCompiler = xacc::getCompiler("xasm");
+  // Interleaved gates on different qubits: H-Z-H (= X) on q[2] is fused across
+  // the gates on q[0] and q[1], then CX(q[1], q[2]) into the q[2] superoperator.
+  auto program = xasmCompiler
+                     ->compile(R"(__qpu__ void testFusion(qbit q) {
+        H(q[0]);
+        X(q[2]);
+        CX(q[0], q[1]);
+        H(q[2]);
+        Z(q[2]);
+        H(q[2]);
+        CX(q[1], q[2]);
+        Measure(q[0]);
+      })",
+                               accelerator)
+                     ->getComposite("testFusion");
+  auto buffer = xacc::qalloc(3);
+  accelerator->execute(buffer, program);
+  auto densityMatrix =
+      *(accelerator
+            ->getExecutionInfo<xacc::ExecutionInfo::DensityMatrixPtrType>(
+                xacc::ExecutionInfo::DmKey));
+  EXPECT_TRUE(validateDensityMatrix(densityMatrix));
+  // GHZ state: (|000> + |111>)/sqrt(2)
+  for (size_t row = 0; row < 8; ++row) {
+    for (size_t col = 0; col < 8; ++col) {
+      const double expected =
+          ((row == 0 || row == 7) && (col == 0 || col == 7)) ? 0.5 : 0.0;
+      EXPECT_NEAR(densityMatrix[row][col].real(), expected, 1e-12);
+      EXPECT_NEAR(densityMatrix[row][col].imag(), 0.0, 1e-12);
+    }
+  }
+}
+
 TEST(JsonNoiseModelTester, checkBitOrdering) {
   auto xasmCompiler = xacc::getCompiler("xasm");
   auto program = xasmCompiler
@@ -485,6 +568,59 @@ TEST(JsonNoiseModelTester, checkGHZ) {
               1e-6);
 }
 
+TEST(JsonNoiseModelTester, checkShotSampling) {
+  auto accelerator = xacc::getAccelerator(
+      "tnqvm", {{"tnqvm-visitor", "exatn-dm"}, {"shots", 1024}});
+  auto xasmCompiler = xacc::getCompiler("xasm");
+  auto program = xasmCompiler
+                     ->compile(R"(__qpu__ void testGhzShots(qbit q) {
+        H(q[0]);
+        CX(q[0], q[1]);
+        CX(q[1], q[2]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+      })",
+                               accelerator)
+                     ->getComposite("testGhzShots");
+  auto buffer = xacc::qalloc(3);
+  accelerator->execute(buffer, program);
+  const auto counts = buffer->getMeasurementCounts();
+  EXPECT_EQ(counts.size(), 2);
+  EXPECT_EQ(counts.at("000") + counts.at("111"), 1024);
+  EXPECT_NEAR(buffer->computeMeasurementProbability("000"), 0.5, 0.1);
+}
+
+TEST(JsonNoiseModelTester, checkMarginalProbabilities) {
+  auto xasmCompiler = xacc::getCompiler("xasm");
+  auto program = xasmCompiler
+                     ->compile(R"(__qpu__ void testMarginals(qbit q) {
+        X(q[0]);
+        H(q[1]);
+        CX(q[1], q[2]);
+        Measure(q[0]);
+      })",
+                               nullptr)
+                     ->getComposites()[0];
+  // Amplitude damping (25%) after X(q[0])
+  auto noiseModel = xacc::getService<xacc::NoiseModel>("json");
+  noiseModel->initialize({{"noise-model", ad_json}});
+  auto accelerator =
+      xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-dm"},
+                                     {"noise-model", noiseModel},
+                                     {"marginal-qubits", std::vector<int>{2, 0}}});
+  auto buffer = xacc::qalloc(3);
+  accelerator->execute(buffer, program);
+  const auto marginals =
+      (*buffer)["marginal-probabilities"].as<std::vector<double>>();
+  // Index: q[2] q[0] (MSB first)
+  ASSERT_EQ(marginals.size(), 4);
+  EXPECT_NEAR(marginals[0], 0.5 * 0.25, 1e-9);
+  EXPECT_NEAR(marginals[1], 0.5 * 0.75, 1e-9);
+  EXPECT_NEAR(marginals[2], 0.5 * 0.25, 1e-9);
+  EXPECT_NEAR(marginals[3], 0.5 * 0.75, 1e-9);
+}
+
 // Test VQE with noise
 TEST(JsonNoiseModelTester, testDeuteronVqeH2) {
   auto noiseModel = xacc::getService<xacc::NoiseModel>("json");
@@ -1,10 +1,13 @@
 #include "ExaTnPmpsVisitor.hpp"
+#include "ExaTnSamplingUtils.hpp"
 #include "tensor_basic.hpp"
 #include "talshxx.hpp"
 #include "utils/GateMatrixAlgebra.hpp"
 #include "base/Gates.hpp"
 #include "NoiseModel.hpp"
 #include "xacc_service.hpp"
+#include <algorithm>
+#include <unordered_map>
 #ifdef TNQVM_EXATN_USES_MKL_BLAS
 #include <dlfcn.h>
 #endif
@@ -99,46 +102,6 @@ std::vector<std::complex<double>> calculateDensityMatrix(const exatn::TensorNetw
     return getTensorData(tempNetwork.getTensor(0)->getName());
 }
 
-std::string generateResultBitString(const std::vector<std::complex<double>>& in_dmDiagonalElems, const std::vector<size_t>& in_measureQubits, size_t in_nbQubits, xacc::NoiseModel* in_noiseModel = nullptr)
-{
-    static auto randomProbFunc = std::bind(std::uniform_real_distribution<double>(0, 1), std::mt19937(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
-    // Pick a random probability
-    const auto probPick = randomProbFunc();
-    const size_t N = in_dmDiagonalElems.size();
-    // Random state selection
-    double cumulativeProb = 0.0;
-    size_t stateSelect = 0;
-    // select a state based on cumulative distribution (diagonal elements)
-    while (cumulativeProb < probPick && stateSelect < N)
-    {
-        cumulativeProb += in_dmDiagonalElems[stateSelect++].real();
-    }
-
-    // back one step
-    stateSelect--;
-    std::string result;
-    for (const auto& qubit : in_measureQubits)
-    {
-        const auto qubitIdx = in_nbQubits - qubit - 1;
-        const bool bit = ((stateSelect >> qubitIdx) & 1);
-        if (in_noiseModel)
-        {
-            // Apply Readout error:
-            const auto roErrorProb = randomProbFunc();
-            const auto [meas0Prep1, meas1Prep0] = in_noiseModel->readoutError(qubit);
-            const double flipProb = bit ? meas0Prep1 : meas1Prep0;
-            const bool measBit = (roErrorProb < flipProb) ? !bit : bit;
-            result.push_back(measBit ? '1' : '0');
-        }
-        else
-        {
-            result.push_back(bit ? '1' : '0');
-        }    
-    }
-
-    return result;  
-}
-
 std::vector<std::complex<double>> getGateMatrix(const xacc::Instruction& in_gate)
 {
     using namespace tnqvm;
@@ -188,19 +151,16 @@ std::vector<std::complex<double>> getGateMatrix(const xacc::Instruction& in_gate
     return flattenGateMatrix(getMatrix());
 }
 
-void contractSingleQubitGateTensor(const std::string& qubitTensorName, const std::string& in_gateTensorName)
+void contractSingleQubitGateTensor(const std::string& qubitTensorName, const std::string& in_gateTensorName, tnqvm::ExaTnTensorPool& io_tensorPool)
 {
     auto qubitTensor =  exatn::getTensor(qubitTensorName);
     assert(qubitTensor->getRank() == 2 || qubitTensor->getRank() == 3 || qubitTensor->getRank() == 4);
     auto gateTensor =  exatn::getTensor(in_gateTensorName);
     assert(gateTensor->getRank() == 2);
 
-    const std::string RESULT_TENSOR_NAME = "Result";
     // Result tensor always has the same shape as the qubit tensor
-    const bool resultTensorCreated = exatn::createTensorSync(RESULT_TENSOR_NAME, 
-                                                            exatn::TensorElementType::COMPLEX64, 
-                                                            qubitTensor->getShape());
-    assert(resultTensorCreated);
+    const std::string RESULT_TENSOR_NAME = io_tensorPool.acquireScratchTensor(qubitTensor->getShape());
+    // Note: the contraction accumulates into the result tensor.
     const bool resultTensorInitialized = exatn::initTensorSync(RESULT_TENSOR_NAME, 0.0);
     assert(resultTensorInitialized);
     
@@ -240,8 +200,48 @@ void contractSingleQubitGateTensor(const std::string& qubitTensorName, const std
     };
 
     exatn::numericalServer->transformTensorSync(qubitTensorName, std::make_shared<tnqvm::ExaTnPmpsVisitor::ExaTnTensorFunctor>(updateFunc));
-    const bool resultTensorDestroyed = exatn::destroyTensor(RESULT_TENSOR_NAME);
-    assert(resultTensorDestroyed);
+    io_tensorPool.releaseScratchTensor(RESULT_TENSOR_NAME);
+}
+
+// Creates a copy of a qubit tensor, conjugated and weighted by a diagonal operator on its physical (first) leg:
+// M(s,...) = in_diagOp[s] * conj(Q(s,...)). The copy is a scratch tensor of the pool.
+std::string createWeightedConjugateTensor(const std::string& in_qubitTensorName, const std::array<double, 2>& in_diagOp, tnqvm::ExaTnTensorPool& io_tensorPool)
+{
+    auto qubitTensor = exatn::getTensor(in_qubitTensorName);
+    auto tensorData = getTensorData(in_qubitTensorName);
+    assert(tensorData.size() == qubitTensor->getVolume());
+    // Column-major: the physical leg is the fastest-running index.
+    for (size_t i = 0; i < tensorData.size(); ++i)
+    {
+        tensorData[i] = in_diagOp[i % QUBIT_DIM] * std::conj(tensorData[i]);
+    }
+    const std::string tensorName = io_tensorPool.acquireScratchTensor(qubitTensor->getShape());
+    const bool initialized = exatn::initTensorDataSync(tensorName, tensorData);
+    assert(initialized);
+    return tensorName;
+}
+
+// Note: the contraction accumulates into the result tensor, hence zero it first.
+void contractIntoTensor(const std::string& in_resultTensorName, const std::string& in_pattern)
+{
+    const bool initialized = exatn::initTensorSync(in_resultTensorName, 0.0);
+    assert(initialized);
+    const bool contractOk = exatn::contractTensorsSync(in_pattern, 1.0);
+    assert(contractOk);
+}
+
+// Full contraction of two tensors with the same shape (and leg order).
+std::complex<double> contractAllLegs(const std::string& in_lhsTensorName, const std::string& in_rhsTensorName)
+{
+    const auto lhsData = getTensorData(in_lhsTensorName);
+    const auto rhsData = getTensorData(in_rhsTensorName);
+    assert(lhsData.size() == rhsData.size());
+    std::complex<double> result { 0.0, 0.0 };
+    for (size_t i = 0; i < lhsData.size(); ++i)
+    {
+        result += lhsData[i] * rhsData[i];
+    }
+    return result;
 }
 
 // Retrieve the leg Id of the connection b/w two tensors.
@@ -293,7 +293,7 @@ std::pair<size_t, size_t> getBondLegId(const exatn::TensorNetwork& in_tensorNetw
     return std::make_pair(lhsBondId, rhsBondId);
 }
 
-void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, const std::vector<size_t>& in_bits, const std::string& in_gateTensorName)
+void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, const std::vector<size_t>& in_bits, const std::string& in_gateTensorName, tnqvm::ExaTnTensorPool& io_tensorPool)
 {
     exatn::TensorNetwork tempNetwork(in_tensorNetwork);
     const std::string q1TensorName = "Q" + std::to_string(in_bits[0]);
@@ -321,12 +321,13 @@ void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, co
         mergeContractionPattern.replace(mergeContractionPattern.find("R"), 1, q1TensorName);
     }
     auto qubitsMergedTensor =  tempNetwork.getTensor(mergedTensorId);
+    // Merged and result tensors are scratch tensors from the pool.
+    qubitsMergedTensor->rename(io_tensorPool.acquireScratchTensor(qubitsMergedTensor->getShape()));
     mergeContractionPattern.replace(mergeContractionPattern.find("D"), 1, qubitsMergedTensor->getName());
     // std::cout << "Merged: " << mergeContractionPattern << "\n";
     
     const auto contractMergePattern = [](std::shared_ptr<exatn::Tensor>& mergedTensor, const std::string& in_mergePattern) {
-        const bool mergedTensorCreated = exatn::createTensorSync(mergedTensor, exatn::TensorElementType::COMPLEX64);
-        assert(mergedTensorCreated);
+        // Note: the contraction accumulates into the output tensor.
         const bool mergedTensorInitialized = exatn::initTensorSync(mergedTensor->getName(), 0.0);
         assert(mergedTensorInitialized);
         const bool mergedContractionOk = exatn::contractTensorsSync(in_mergePattern, 1.0);
@@ -335,18 +336,18 @@ void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, co
    
     contractMergePattern(qubitsMergedTensor, mergeContractionPattern);
     std::string svdPattern = mergeContractionPattern;
-    std::shared_ptr<exatn::Tensor> gateMergeTensor = std::make_shared<exatn::Tensor>("Result", qubitsMergedTensor->getShape());
+    std::shared_ptr<exatn::Tensor> gateMergeTensor = std::make_shared<exatn::Tensor>(io_tensorPool.acquireScratchTensor(qubitsMergedTensor->getShape()), qubitsMergedTensor->getShape());
     // Merge with gate:
     std::string patternStr;
     if (qubitsMergedTensor->getRank() == 4)
     {
         if (!shouldFlipOrder)
         {
-            patternStr = "Result(u0,u1,u2,u3)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3)*" + in_gateTensorName + "(c1,c0,u0,u2)";
+            patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3)*" + in_gateTensorName + "(c1,c0,u0,u2)";
         }
         else
         {
-            patternStr = "Result(u0,u1,u2,u3)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3)*" + in_gateTensorName + "(c0,c1,u0,u2)";
+            patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3)*" + in_gateTensorName + "(c0,c1,u0,u2)";
         }   
     }
     else if (qubitsMergedTensor->getRank() == 5)
@@ -356,22 +357,22 @@ void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, co
         {
             if (in_bits[0] == 0)
             {
-                patternStr = "Result(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3,u4)*" + in_gateTensorName + "(c1,c0,u0,u2)";
+                patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3,u4)*" + in_gateTensorName + "(c1,c0,u0,u2)";
             }
             else
             {
-                patternStr = "Result(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4)*" + in_gateTensorName + "(c1,c0,u0,u3)";
+                patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4)*" + in_gateTensorName + "(c1,c0,u0,u3)";
             }
         }
         else
         {
             if (in_bits[1] == 0)
             {
-                patternStr = "Result(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3,u4)*" + in_gateTensorName + "(c0,c1,u0,u2)";
+                patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,c1,u3,u4)*" + in_gateTensorName + "(c0,c1,u0,u2)";
             }
             else
             {
-                patternStr = "Result(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4)*" + in_gateTensorName + "(c0,c1,u0,u3)";
+                patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3,u4)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4)*" + in_gateTensorName + "(c0,c1,u0,u3)";
             }
         }   
     }
@@ -379,11 +380,11 @@ void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, co
     {
         if (!shouldFlipOrder)
         {
-            patternStr = "Result(u0,u1,u2,u3,u4,u5)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4,u5)*" + in_gateTensorName + "(c1,c0,u0,u3)";
+            patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3,u4,u5)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4,u5)*" + in_gateTensorName + "(c1,c0,u0,u3)";
         }
         else
         {
-            patternStr = "Result(u0,u1,u2,u3,u4,u5)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4,u5)*" + in_gateTensorName + "(c0,c1,u0,u3)";
+            patternStr = gateMergeTensor->getName() + "(u0,u1,u2,u3,u4,u5)=" + qubitsMergedTensor->getName() + "(c0,u1,u2,c1,u4,u5)*" + in_gateTensorName + "(c0,c1,u0,u3)";
         }   
     }
     else
@@ -428,12 +429,14 @@ void contractTwoQubitGateTensor(const exatn::TensorNetwork& in_tensorNetwork, co
         assert(svdOk);
     }
 
-    const auto destroyed = exatn::destroyTensorSync("Result");
-    assert(destroyed);
+    io_tensorPool.releaseScratchTensor(qubitsMergedTensor->getName());
+    io_tensorPool.releaseScratchTensor(gateMergeTensor->getName());
 }
 }
 namespace tnqvm {
-ExaTnPmpsVisitor::ExaTnPmpsVisitor()
+ExaTnPmpsVisitor::ExaTnPmpsVisitor():
+    m_tensorPool("Pmps", MAX_CACHED_GATE_TENSORS),
+    m_noiseTensorCache("PmpsNoise")
 {
     // TODO
 }
@@ -490,9 +493,19 @@ void ExaTnPmpsVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int
         m_noiseConfig->initialize({{"backend", options.getString("backend")}});
       }
     }
+    if (m_noiseConfig)
+    {
+        m_noiseTensorCache.setNoiseModel(m_noiseConfig);
+    }
     // DEBUG
     // printDensityMatrix(m_pmpsTensorNetwork, m_buffer->size());
     // Since this is a noisy simulation, always run shots by default.
+    m_shotsRequested = (nbShots > 0);
+    m_outputDensityMatrix = false;
+    if (options.keyExists<bool>("density-matrix"))
+    {
+        m_outputDensityMatrix = options.get<bool>("density-matrix");
+    }
     m_nbShots = (nbShots < 1) ? 1024 : nbShots;
 }
 
@@ -613,40 +626,36 @@ exatn::TensorNetwork ExaTnPmpsVisitor::buildInitialNetwork(size_t in_nbQubits, b
 void ExaTnPmpsVisitor::finalize() 
 { 
     exatn::sync();
-    // If there are measurements:
-    if (!m_measuredBits.empty())
+    // The dense density matrix is only computed on request (small circuits only).
+    if (m_outputDensityMatrix)
     {
-        // Retrieve the density matrix:
-        const auto flattenedDm = calculateDensityMatrix(m_pmpsTensorNetwork, m_buffer->size());
-        const std::vector<std::complex<double>> diagElems = [&](){
-            const auto dim = 1ULL << m_buffer->size();
-            std::vector<std::complex<double>> result(dim);
-            for (size_t i = 0; i < dim; ++i)
-            {
-                result[i] = flattenedDm[ i * dim + i];
-                assert(std::abs(result[i].imag()) < 1e-12);
+        if (m_buffer->size() <= MAX_QUBITS_DENSITY_MATRIX)
+        {
+            const auto flattenedDm = calculateDensityMatrix(m_pmpsTensorNetwork, m_buffer->size());
+            std::vector<std::pair<double, double>> flattenDmPairs;
+            for (const auto &elem : flattenedDm) {
+              flattenDmPairs.emplace_back(std::make_pair(elem.real(), elem.imag()));
             }
-            return result;
-        }();
+            m_buffer->addExtraInfo("density_matrix", flattenDmPairs);
+        }
+        else
+        {
+            xacc::warning("The density matrix is only available for circuits of up to " + std::to_string(MAX_QUBITS_DENSITY_MATRIX) + " qubits. Ignored.");
+        }
+    }
 
-        std::vector<std::pair<double, double>> flattenDmPairs;
-        for (const auto &elem : flattenedDm) {
-          flattenDmPairs.emplace_back(std::make_pair(elem.real(), elem.imag()));
+    // If there are measurements:
+    if (!m_measuredBits.empty())
+    {
+        // No shots requested: add the exact exp-val-z
+        if (!m_shotsRequested)
+        {
+            m_buffer->addExtraInfo("exp-val-z", computeExpectationValueZ(m_measuredBits));
         }
-        m_buffer->addExtraInfo("density_matrix", flattenDmPairs);
-        const auto sumDiag = [](const std::vector<std::complex<double>>& in_diag){
-            double sum = 0.0;
-            for (const auto& x : in_diag)
-            {
-                sum += x.real();
-            }
-            return sum;
-        }(diagElems);
-        // Validate trace = 1.0
-        assert(std::abs(sumDiag - 1.0) < 1e-3);
-        for (int i = 0; i < m_nbShots; ++i)
+        // Sample qubit-by-qubit from the PMPS (no density matrix)
+        for (const auto& bitString : sampleMeasuredBits(m_nbShots))
         {
-            m_buffer->appendMeasurement(generateResultBitString(diagElems, m_measuredBits, m_buffer->size(), m_noiseConfig.get()));
+            m_buffer->appendMeasurement(bitString);
         }
         
         m_measuredBits.clear();
@@ -657,29 +666,36 @@ void ExaTnPmpsVisitor::finalize()
         const bool destroyed = exatn::destroyTensorSync("Q" + std::to_string(i));
         assert(destroyed);
     }
+    m_tensorPool.clear();
+    executionInfo.insert("noise-cache-misses", static_cast<int>(m_noiseTensorCache.getNbCacheMisses()));
+    m_noiseTensorCache.resetNbCacheMisses();
 }
 
-std::vector<KrausOp> ExaTnPmpsVisitor::convertNoiseChannel(
-    const std::vector<NoiseChannelKraus> &in_channels) const {
-  std::vector<KrausOp> result;
-  const auto noiseUtils = xacc::getService<NoiseModelUtils>("default");
-  for (const auto &channel : in_channels) {
-    // Note: we don't support multi-qubit channels in the PMPS simulator.
-    // Hence, just ignore it.
-    if (channel.noise_qubits.size() == 1) {
-      KrausOp newOp;
-      newOp.qubit = channel.noise_qubits[0];
-      newOp.mats = noiseUtils->krausToChoi(channel.mats);
-      result.emplace_back(newOp);
-    } else {
-      static bool warnOnce = false;
-      if (!warnOnce) {
-        std::cout << "Multi-qubit channels are not supported. Ignoring.\n";
-        warnOnce = true;
-      }
+void ExaTnPmpsVisitor::applyNoise(xacc::quantum::Gate& in_gateInstruction)
+{
+    if (!m_noiseConfig)
+    {
+        return;
+    }
+    // Noise tensors (converted and created once per gate and qubits)
+    for (const auto& noiseTensor : m_noiseTensorCache.getNoiseTensors(in_gateInstruction))
+    {
+        // Note: we don't support multi-qubit channels in the PMPS simulator.
+        // Hence, just ignore it.
+        if (noiseTensor.qubits.size() == 1) 
+        {
+            applyLocalKrausOp(noiseTensor.qubits[0], noiseTensor.tensorName);
+        } 
+        else 
+        {
+            static bool warnOnce = false;
+            if (!warnOnce) 
+            {
+                std::cout << "Multi-qubit channels are not supported. Ignoring.\n";
+                warnOnce = true;
+            }
+        }
     }
-  }
-  return result;
 }
 
 void ExaTnPmpsVisitor::applySingleQubitGate(xacc::quantum::Gate& in_gateInstruction)
@@ -687,29 +703,15 @@ void ExaTnPmpsVisitor::applySingleQubitGate(xacc::quantum::Gate& in_gateInstruct
     assert(in_gateInstruction.bits().size() == 1);
     const auto gateMatrix = getGateMatrix(in_gateInstruction);
     assert(gateMatrix.size() == 4);
-    const std::string& gateTensorName = in_gateInstruction.name();
-    // Create the tensor
-    const bool created = exatn::createTensorSync(gateTensorName, exatn::TensorElementType::COMPLEX64, exatn::TensorShape{ 2, 2 });
-    assert(created);
-    // Init tensor body data
-    const bool initialized = exatn::initTensorDataSync(gateTensorName, gateMatrix);
-    assert(initialized);
+    // Gate tensor (created once, cached by the pool)
+    const std::string gateTensorName = m_tensorPool.getGateTensor(in_gateInstruction.name(), exatn::TensorShape{ 2, 2 }, gateMatrix);
 
     const size_t bitIdx = in_gateInstruction.bits()[0];
     const std::string qubitTensorName = "Q" + std::to_string(bitIdx);
-    contractSingleQubitGateTensor(qubitTensorName, gateTensorName);
-    const bool destroyed = exatn::destroyTensorSync(gateTensorName);
-    assert(destroyed);
+    contractSingleQubitGateTensor(qubitTensorName, gateTensorName, m_tensorPool);
  
     // Apply noise (Kraus) Op
-    if (m_noiseConfig) 
-    {
-        const auto noiseOps = convertNoiseChannel(m_noiseConfig->getNoiseChannels(in_gateInstruction));
-        for (const auto& op : noiseOps)
-        {
-            applyKrausOp(op);
-        }
-    }
+    applyNoise(in_gateInstruction);
 }
 
 void ExaTnPmpsVisitor::applyTwoQubitGate(xacc::quantum::Gate& in_gateInstruction)
@@ -720,16 +722,9 @@ void ExaTnPmpsVisitor::applyTwoQubitGate(xacc::quantum::Gate& in_gateInstruction
     const auto gateMatrix = getGateMatrix(in_gateInstruction);
     assert(gateMatrix.size() == 16);
     
-    const std::string& gateTensorName = in_gateInstruction.name();
-    // Create the tensor
-    const bool created = exatn::createTensorSync(gateTensorName, exatn::TensorElementType::COMPLEX64, exatn::TensorShape{ 2, 2, 2, 2 });
-    assert(created);
-    // Init tensor body data
-    const bool initialized = exatn::initTensorDataSync(gateTensorName, gateMatrix);
-    assert(initialized);
-    contractTwoQubitGateTensor(m_pmpsTensorNetwork, in_gateInstruction.bits(), gateTensorName);
-    const bool destroyed = exatn::destroyTensorSync(gateTensorName);
-    assert(destroyed);
+    // Gate tensor (created once, cached by the pool)
+    const std::string gateTensorName = m_tensorPool.getGateTensor(in_gateInstruction.name(), exatn::TensorShape{ 2, 2, 2, 2 }, gateMatrix);
+    contractTwoQubitGateTensor(m_pmpsTensorNetwork, in_gateInstruction.bits(), gateTensorName, m_tensorPool);
     m_pmpsTensorNetwork = buildInitialNetwork(m_buffer->size(), false);
     // Truncate SVD:
     const std::string q1TensorName = "Q" + std::to_string(in_gateInstruction.bits()[0]);
@@ -738,35 +733,175 @@ void ExaTnPmpsVisitor::applyTwoQubitGate(xacc::quantum::Gate& in_gateInstruction
     m_pmpsTensorNetwork = buildInitialNetwork(m_buffer->size(), false);
 
     // Apply noise (Kraus) Op
-    if (m_noiseConfig) 
+    applyNoise(in_gateInstruction);
+}
+
+void ExaTnPmpsVisitor::applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix)
+{
+    if (in_qubits.empty() || (1ULL << in_qubits.size()) != in_matrix.size())
+    {
+        xacc::error("Gate matrix dimension doesn't match the number of qubits.");
+    }
+    validateGateQubits(in_qubits, m_buffer->size());
+    const std::vector<std::complex<double>> gateData = [&in_matrix]() {
+        std::vector<std::complex<double>> result;
+        result.reserve(in_matrix.size() * in_matrix.size());
+        for (const auto& row : in_matrix)
+        {
+            if (row.size() != in_matrix.size())
+            {
+                xacc::error("Invalid gate matrix: the matrix must be square.");
+            }
+            result.insert(result.end(), row.begin(), row.end());
+        }
+        return result;
+    }();
+    const size_t nbQubits = m_buffer->size();
+    const size_t firstSite = *std::min_element(in_qubits.begin(), in_qubits.end());
+    const size_t lastSite = *std::max_element(in_qubits.begin(), in_qubits.end());
+    const auto siteTensorName = [](size_t in_site) { return "Q" + std::to_string(in_site); };
+    const auto bondLabel = [](size_t in_site) { return "j" + std::to_string(in_site); };
+    // Leg labels of a site tensor (same leg order as buildInitialNetwork()):
+    // physical (p), left bond, Kraus (k), right bond; the bond between sites s and s + 1 is j<s>.
+    const auto siteLegs = [&](size_t in_site) {
+        const std::string physLeg = "p" + std::to_string(in_site);
+        const std::string krausLeg = "k" + std::to_string(in_site);
+        if (nbQubits == 1)
+        {
+            return std::vector<std::string>{ physLeg, krausLeg };
+        }
+        if (in_site == 0)
+        {
+            return std::vector<std::string>{ physLeg, bondLabel(in_site), krausLeg };
+        }
+        if (in_site == nbQubits - 1)
+        {
+            return std::vector<std::string>{ physLeg, bondLabel(in_site - 1), krausLeg };
+        }
+        return std::vector<std::string>{ physLeg, bondLabel(in_site - 1), krausLeg, bondLabel(in_site) };
+    };
+    const auto toPattern = [](const std::string& in_tensorName, const std::vector<std::string>& in_legs) {
+        std::string result = in_tensorName + "(";
+        for (const auto& leg : in_legs)
+        {
+            result += leg + ",";
+        }
+        result.back() = ')';
+        return result;
+    };
+    std::unordered_map<std::string, exatn::DimExtent> legDims;
+    const auto getShape = [&legDims](const std::vector<std::string>& in_legs) {
+        std::vector<exatn::DimExtent> shape;
+        for (const auto& leg : in_legs)
+        {
+            shape.emplace_back(legDims.at(leg));
+        }
+        return exatn::TensorShape(shape);
+    };
+
+    // Step 1: merge the site tensors spanned by the gate into Theta (physical and Kraus legs of these sites + outer bonds).
+    std::string thetaTensorName = siteTensorName(firstSite);
+    std::vector<std::string> thetaLegs = siteLegs(firstSite);
+    for (size_t site = firstSite; site <= lastSite; ++site)
     {
-        const auto noiseOps = convertNoiseChannel(m_noiseConfig->getNoiseChannels(in_gateInstruction));
-        for (const auto& op : noiseOps)
+        const auto legs = siteLegs(site);
+        const auto dims = exatn::getTensor(siteTensorName(site))->getDimExtents();
+        for (size_t i = 0; i < legs.size(); ++i)
+        {
+            legDims[legs[i]] = dims[i];
+        }
+        if (site == firstSite)
+        {
+            continue;
+        }
+        const std::string bond = bondLabel(site - 1);
+        std::vector<std::string> mergedLegs;
+        std::copy_if(thetaLegs.begin(), thetaLegs.end(), std::back_inserter(mergedLegs), [&bond](const std::string& in_leg) { return in_leg != bond; });
+        std::copy_if(legs.begin(), legs.end(), std::back_inserter(mergedLegs), [&bond](const std::string& in_leg) { return in_leg != bond; });
+        const std::string mergedTensorName = m_tensorPool.acquireScratchTensor(getShape(mergedLegs));
+        contractIntoTensor(mergedTensorName, toPattern(mergedTensorName, mergedLegs) + "=" + toPattern(thetaTensorName, thetaLegs) + "*" + toPattern(siteTensorName(site), legs));
+        if (thetaTensorName != siteTensorName(firstSite))
         {
-            applyKrausOp(op);
+            m_tensorPool.releaseScratchTensor(thetaTensorName);
         }
+        thetaTensorName = mergedTensorName;
+        thetaLegs = mergedLegs;
     }
-}
-void ExaTnPmpsVisitor::applyKrausOp(const KrausOp& in_op) 
-{
-    static size_t krausTensorCounter = 0;
-    ++krausTensorCounter;
-    
-    auto krausTensor = std::make_shared<exatn::Tensor>("__KRAUS__" + std::to_string(krausTensorCounter), exatn::TensorShape{2, 2, 2, 2});
-    const bool created = exatn::createTensorSync(krausTensor, exatn::TensorElementType::COMPLEX64);
-    assert(created);
-    std::vector<std::complex<double>> krausVec;
-    krausVec.reserve(in_op.mats.size() * in_op.mats.size());
-    for (const auto &row : in_op.mats) 
+
+    // Step 2: apply U on the physical legs of the gate qubits (the Kraus and bond legs are untouched).
+    // Rank-2k gate tensor; the first qubit is the MSB (last leg) of the matrix:
+    // input leg (k-1-m) and output leg (2k-1-m) of the m-th gate qubit.
+    const size_t nbGateQubits = in_qubits.size();
+    std::vector<std::string> gateLegs(2 * nbGateQubits);
+    std::vector<std::string> thetaInLegs = thetaLegs;
+    for (size_t m = 0; m < nbGateQubits; ++m)
     {
-      for (const auto &entry : row) 
-      {
-        krausVec.emplace_back(entry);
-      }
+        const std::string physLeg = "p" + std::to_string(in_qubits[m]);
+        const std::string inLeg = "c" + std::to_string(in_qubits[m]);
+        gateLegs[nbGateQubits - 1 - m] = inLeg;
+        gateLegs[2 * nbGateQubits - 1 - m] = physLeg;
+        std::replace(thetaInLegs.begin(), thetaInLegs.end(), physLeg, inLeg);
     }
-    const bool initialized = exatn::initTensorDataSync(krausTensor->getName(), krausVec);
-    assert(initialized);
-    applyLocalKrausOp(in_op.qubit, krausTensor->getName());
+    const std::string gateTensorName = m_tensorPool.getGateTensor("UNITARY" + std::to_string(nbGateQubits),
+                                                                  exatn::TensorShape(std::vector<exatn::DimExtent>(2 * nbGateQubits, QUBIT_DIM)), gateData);
+    std::string restTensorName = m_tensorPool.acquireScratchTensor(getShape(thetaLegs));
+    contractIntoTensor(restTensorName, toPattern(restTensorName, thetaLegs) + "=" + toPattern(thetaTensorName, thetaInLegs) + "*" + toPattern(gateTensorName, gateLegs));
+    if (thetaTensorName != siteTensorName(firstSite))
+    {
+        m_tensorPool.releaseScratchTensor(thetaTensorName);
+    }
+
+    // Step 3: split back site-by-site (left-to-right SVD, same as two-qubit gates),
+    // the new bonds are exact (no truncation other than the zero singular values below).
+    std::vector<std::string> restLegs = thetaLegs;
+    for (size_t site = firstSite; site < lastSite; ++site)
+    {
+        const auto legs = siteLegs(site);
+        const std::string bond = bondLabel(site);
+        std::vector<std::string> newRestLegs { bond };
+        std::copy_if(restLegs.begin(), restLegs.end(), std::back_inserter(newRestLegs),
+                     [&legs](const std::string& in_leg) { return std::find(legs.begin(), legs.end(), in_leg) == legs.end(); });
+        exatn::DimExtent leftVolume = 1;
+        for (const auto& leg : legs)
+        {
+            if (leg != bond)
+            {
+                leftVolume *= legDims.at(leg);
+            }
+        }
+        const auto restVolume = getShape(restLegs).getVolume() / leftVolume;
+        legDims[bond] = std::min(leftVolume, restVolume);
+
+        const bool destroyed = exatn::destroyTensorSync(siteTensorName(site));
+        assert(destroyed);
+        const bool created = exatn::createTensorSync(siteTensorName(site), exatn::TensorElementType::COMPLEX64, getShape(legs));
+        assert(created);
+        const std::string newRestTensorName = m_tensorPool.acquireScratchTensor(getShape(newRestLegs));
+        const bool svdOk = exatn::decomposeTensorSVDLRSync(toPattern(restTensorName, restLegs) + "=" + toPattern(siteTensorName(site), legs) + "*" + toPattern(newRestTensorName, newRestLegs));
+        assert(svdOk);
+        m_tensorPool.releaseScratchTensor(restTensorName);
+        restTensorName = newRestTensorName;
+        restLegs = newRestLegs;
+    }
+    {
+        const auto legs = siteLegs(lastSite);
+        const bool destroyed = exatn::destroyTensorSync(siteTensorName(lastSite));
+        assert(destroyed);
+        const bool created = exatn::createTensorSync(siteTensorName(lastSite), exatn::TensorElementType::COMPLEX64, getShape(legs));
+        assert(created);
+        const bool initialized = exatn::initTensorSync(siteTensorName(lastSite), 0.0);
+        assert(initialized);
+        const bool copied = exatn::addTensorsSync(toPattern(siteTensorName(lastSite), legs) + "+=" + toPattern(restTensorName, restLegs), 1.0);
+        assert(copied);
+        m_tensorPool.releaseScratchTensor(restTensorName);
+    }
+    m_pmpsTensorNetwork = buildInitialNetwork(nbQubits, false);
+    for (size_t site = firstSite; site < lastSite; ++site)
+    {
+        truncateSvdTensors(siteTensorName(site), siteTensorName(site + 1));
+        m_pmpsTensorNetwork = buildInitialNetwork(nbQubits, false);
+    }
+    // Note: no noise channel is applied to generic gates (the noise model is keyed by gate instruction).
 }
 
 void ExaTnPmpsVisitor::applyLocalKrausOp(size_t in_siteId, const std::string& in_opTensorName)
@@ -786,10 +921,12 @@ void ExaTnPmpsVisitor::applyLocalKrausOp(size_t in_siteId, const std::string& in
     mergeContractionPattern.replace(mergeContractionPattern.find("L"), 1, qubitTensorName);
     mergeContractionPattern.replace(mergeContractionPattern.find("R"), 1, qubitTensorName);
     auto mergedTensor = m_pmpsTensorNetwork.getTensor(mergedTensorId);
-    mergedTensor->rename("D");
+    // Merged (D) tensor: scratch tensor from the pool
+    const std::string mergedTensorName = m_tensorPool.acquireScratchTensor(mergedTensor->getShape());
+    mergedTensor->rename(mergedTensorName);
+    mergeContractionPattern.replace(mergeContractionPattern.find("D"), 1, mergedTensorName);
     // std::cout << mergeContractionPattern << "\n";
-    const bool mergedTensorCreated = exatn::createTensorSync(mergedTensor, exatn::TensorElementType::COMPLEX64);
-    assert(mergedTensorCreated);
+    // Note: the contractions accumulate into the output tensors, hence zero them first.
     const bool mergedTensorInitialized = exatn::initTensorSync(mergedTensor->getName(), 0.0);
     assert(mergedTensorInitialized);
     const bool mergedContractionOk = exatn::contractTensorsSync(mergeContractionPattern, 1.0);
@@ -801,21 +938,20 @@ void ExaTnPmpsVisitor::applyLocalKrausOp(size_t in_siteId, const std::string& in
     //     std::cout << elem << "\n";
     // }
     // Step 2: Append Kraus tensor as a 2-qubit gate
-    static size_t counter = 0;
-    const std::string RESULT_TENSOR_NAME = "Result_Kraus_" + std::to_string(counter++);
+    const std::string RESULT_TENSOR_NAME = m_tensorPool.acquireScratchTensor(mergedTensor->getShape());
     const std::string patternStr = [&]() -> std::string {
         if (mergedTensor->getRank() == 2)
         {
             assert(m_buffer->size() == 1);
-            return RESULT_TENSOR_NAME + "(u0,u1)=D(c0,c1)*" + opTensor->getName() + "(u0,c0,u1,c1)";
+            return RESULT_TENSOR_NAME + "(u0,u1)=" + mergedTensorName + "(c0,c1)*" + opTensor->getName() + "(u0,c0,u1,c1)";
         }
         else if (mergedTensor->getRank() == 4)
         {
-            return RESULT_TENSOR_NAME + "(u0,u1,u2,u3)=D(c0,u1,c1,u3)*" + opTensor->getName() + "(u0,c0,u2,c1)";
+            return RESULT_TENSOR_NAME + "(u0,u1,u2,u3)=" + mergedTensorName + "(c0,u1,c1,u3)*" + opTensor->getName() + "(u0,c0,u2,c1)";
         }
         else if (mergedTensor->getRank() == 6)
         {
-            return RESULT_TENSOR_NAME + "(u0,u1,u2,u3,u4,u5)=D(c0,u1,u2,c1,u4,u5)*" + opTensor->getName() + "(u0,c0,u3,c1)";
+            return RESULT_TENSOR_NAME + "(u0,u1,u2,u3,u4,u5)=" + mergedTensorName + "(c0,u1,u2,c1,u4,u5)*" + opTensor->getName() + "(u0,c0,u3,c1)";
         }
         else
         {
@@ -825,10 +961,6 @@ void ExaTnPmpsVisitor::applyLocalKrausOp(size_t in_siteId, const std::string& in
     }();
    
     // Result tensor always has the same shape as the *merged* qubit tensor
-    const bool resultTensorCreated = exatn::createTensorSync(RESULT_TENSOR_NAME, 
-                                                            exatn::TensorElementType::COMPLEX64, 
-                                                            mergedTensor->getShape());
-    assert(resultTensorCreated);
     const bool resultTensorInitialized = exatn::initTensorSync(RESULT_TENSOR_NAME, 0.0);
     assert(resultTensorInitialized);
     
@@ -869,10 +1001,9 @@ void ExaTnPmpsVisitor::applyLocalKrausOp(size_t in_siteId, const std::string& in
     assert(destroyed);
 
     auto svdTensor1 = std::make_shared<exatn::Tensor>(qubitTensorName, tensorShape);
-    auto svdTensor2 = std::make_shared<exatn::Tensor>("__SVD__", tensorShape);
-    bool created = exatn::createTensorSync(svdTensor1, exatn::TensorElementType::COMPLEX64);
-    assert(created);
-    created = exatn::createTensorSync(svdTensor2, exatn::TensorElementType::COMPLEX64);
+    // The second SVD factor is discarded: use a scratch tensor.
+    auto svdTensor2 = std::make_shared<exatn::Tensor>(m_tensorPool.acquireScratchTensor(tensorShape), tensorShape);
+    const bool created = exatn::createTensorSync(svdTensor1, exatn::TensorElementType::COMPLEX64);
     assert(created);
 
     const std::string svdPattern = [&]() -> std::string {
@@ -916,14 +1047,9 @@ void ExaTnPmpsVisitor::applyLocalKrausOp(size_t in_siteId, const std::string& in
     // {
     //     std::cout << elem << "\n";
     // }
-    destroyed = exatn::destroyTensorSync(svdTensor2->getName());
-    assert(destroyed);
-    destroyed = exatn::destroyTensorSync(mergedTensor->getName());
-    assert(destroyed);
-    destroyed = exatn::destroyTensorSync(RESULT_TENSOR_NAME);
-    assert(destroyed);
-    destroyed = exatn::destroyTensorSync(in_opTensorName);
-    assert(destroyed);
+    m_tensorPool.releaseScratchTensor(svdTensor2->getName());
+    m_tensorPool.releaseScratchTensor(mergedTensorName);
+    m_tensorPool.releaseScratchTensor(RESULT_TENSOR_NAME);
     const auto krausBondId = (tensorShape.getRank() == 2) ? 1 : 2;
     std::vector<double> krausBondNorm;
     const bool normOk = exatn::computePartialNormsSync(qubitTensorName, krausBondId, krausBondNorm);
@@ -1095,7 +1221,231 @@ void ExaTnPmpsVisitor::visit(fSim& in_fsimGate)
 
 const double ExaTnPmpsVisitor::getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function) 
 { 
-    return 0.0;
+    // Walk the circuit and visit all gates
+    InstructionIterator it(in_function);
+    while (it.hasNext()) 
+    {
+        auto nextInst = it.next();
+        if (nextInst->isEnabled()) 
+        {
+            nextInst->accept(this);
+        }
+    }
+
+    return computeExpectationValueZ(m_measuredBits);
+}
+
+double ExaTnPmpsVisitor::computeExpectationValueZ(const std::vector<size_t>& in_bits)
+{
+    // Identity on all sites, Z on the measured ones.
+    std::vector<std::array<double, 2>> diagOps(m_buffer->size(), { 1.0, 1.0 });
+    for (const auto& bit : in_bits)
+    {
+        std::array<double, 2> zOp { 1.0, -1.0 };
+        if (m_noiseConfig)
+        {
+            // Readout error: <z_meas> given the prepared state, i.e. 1 - 2*P(1|0) and 2*P(0|1) - 1.
+            const auto [meas0Prep1, meas1Prep0] = m_noiseConfig->readoutError(bit);
+            zOp = { 1.0 - 2.0 * meas1Prep0, 2.0 * meas0Prep1 - 1.0 };
+        }
+        diagOps[bit][0] *= zOp[0];
+        diagOps[bit][1] *= zOp[1];
+    }
+
+    const auto result = contractWithDiagonalOps(diagOps);
+    assert(std::abs(result.imag()) < 1e-9);
+    return result.real();
+}
+
+std::complex<double> ExaTnPmpsVisitor::contractWithDiagonalOps(const std::vector<std::array<double, 2>>& in_diagOps)
+{
+    const size_t nbQubits = m_buffer->size();
+    assert(in_diagOps.size() == nbQubits);
+    std::string envTensorName;
+    for (size_t i = 0; i + 1 < nbQubits; ++i)
+    {
+        const std::string newEnvTensorName = contractLeftEnvironment(envTensorName, i, in_diagOps[i]);
+        if (!envTensorName.empty())
+        {
+            m_tensorPool.releaseScratchTensor(envTensorName);
+        }
+        envTensorName = newEnvTensorName;
+    }
+
+    const auto result = closeLeftEnvironment(envTensorName, in_diagOps[nbQubits - 1]);
+    if (!envTensorName.empty())
+    {
+        m_tensorPool.releaseScratchTensor(envTensorName);
+    }
+    return result;
+}
+
+std::string ExaTnPmpsVisitor::contractLeftEnvironment(const std::string& in_leftEnvTensorName, size_t in_siteId, const std::array<double, 2>& in_diagOp)
+{
+    assert(in_siteId + 1 < m_buffer->size());
+    assert((in_siteId == 0) == in_leftEnvTensorName.empty());
+    const std::string qubitTensorName = "Q" + std::to_string(in_siteId);
+    auto qubitTensor = exatn::getTensor(qubitTensorName);
+    const std::string conjTensorName = createWeightedConjugateTensor(qubitTensorName, in_diagOp, m_tensorPool);
+    std::string envTensorName;
+    if (in_siteId == 0)
+    {
+        // Q0(s,r,k)
+        const auto bondDim = qubitTensor->getDimExtent(1);
+        envTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{ bondDim, bondDim });
+        contractIntoTensor(envTensorName, envTensorName + "(r,u)=" + qubitTensorName + "(s,r,k)*" + conjTensorName + "(s,u,k)");
+    }
+    else
+    {
+        // Q(s,l,k,r): absorb the environment into the ket tensor, then contract with the (weighted) bra tensor.
+        const auto bondDim = qubitTensor->getDimExtent(3);
+        const std::string tempTensorName = m_tensorPool.acquireScratchTensor(qubitTensor->getShape());
+        contractIntoTensor(tempTensorName, tempTensorName + "(s,u,k,r)=" + in_leftEnvTensorName + "(l,u)*" + qubitTensorName + "(s,l,k,r)");
+        envTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{ bondDim, bondDim });
+        contractIntoTensor(envTensorName, envTensorName + "(r,v)=" + tempTensorName + "(s,u,k,r)*" + conjTensorName + "(s,u,k,v)");
+        m_tensorPool.releaseScratchTensor(tempTensorName);
+    }
+    m_tensorPool.releaseScratchTensor(conjTensorName);
+    return envTensorName;
+}
+
+std::complex<double> ExaTnPmpsVisitor::closeLeftEnvironment(const std::string& in_leftEnvTensorName, const std::array<double, 2>& in_diagOp)
+{
+    const size_t siteId = m_buffer->size() - 1;
+    assert((siteId == 0) == in_leftEnvTensorName.empty());
+    const std::string qubitTensorName = "Q" + std::to_string(siteId);
+    const std::string conjTensorName = createWeightedConjugateTensor(qubitTensorName, in_diagOp, m_tensorPool);
+    std::complex<double> result { 0.0, 0.0 };
+    if (siteId == 0)
+    {
+        // Q0(s,k): no bond legs
+        result = contractAllLegs(qubitTensorName, conjTensorName);
+    }
+    else
+    {
+        // Q(s,l,k)
+        const std::string tempTensorName = m_tensorPool.acquireScratchTensor(exatn::getTensor(qubitTensorName)->getShape());
+        contractIntoTensor(tempTensorName, tempTensorName + "(s,u,k)=" + in_leftEnvTensorName + "(l,u)*" + qubitTensorName + "(s,l,k)");
+        result = contractAllLegs(tempTensorName, conjTensorName);
+        m_tensorPool.releaseScratchTensor(tempTensorName);
+    }
+    m_tensorPool.releaseScratchTensor(conjTensorName);
+    return result;
+}
+
+std::string ExaTnPmpsVisitor::contractRightEnvironment(const std::string& in_rightEnvTensorName, size_t in_siteId)
+{
+    const size_t nbQubits = m_buffer->size();
+    assert(in_siteId > 0 && in_siteId < nbQubits);
+    assert((in_siteId == nbQubits - 1) == in_rightEnvTensorName.empty());
+    const std::string qubitTensorName = "Q" + std::to_string(in_siteId);
+    auto qubitTensor = exatn::getTensor(qubitTensorName);
+    const std::string conjTensorName = createWeightedConjugateTensor(qubitTensorName, { 1.0, 1.0 }, m_tensorPool);
+    const auto bondDim = qubitTensor->getDimExtent(1);
+    const std::string envTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{ bondDim, bondDim });
+    if (in_siteId == nbQubits - 1)
+    {
+        // Q(s,l,k)
+        contractIntoTensor(envTensorName, envTensorName + "(l,u)=" + qubitTensorName + "(s,l,k)*" + conjTensorName + "(s,u,k)");
+    }
+    else
+    {
+        // Q(s,l,k,r)
+        const std::string tempTensorName = m_tensorPool.acquireScratchTensor(qubitTensor->getShape());
+        contractIntoTensor(tempTensorName, tempTensorName + "(s,l,k,v)=" + qubitTensorName + "(s,l,k,r)*" + in_rightEnvTensorName + "(r,v)");
+        contractIntoTensor(envTensorName, envTensorName + "(l,u)=" + tempTensorName + "(s,l,k,v)*" + conjTensorName + "(s,u,k,v)");
+        m_tensorPool.releaseScratchTensor(tempTensorName);
+    }
+    m_tensorPool.releaseScratchTensor(conjTensorName);
+    return envTensorName;
+}
+
+std::vector<std::string> ExaTnPmpsVisitor::sampleMeasuredBits(int in_nbShots)
+{
+    assert(!m_measuredBits.empty());
+    const size_t nbQubits = m_buffer->size();
+    std::vector<bool> isMeasured(nbQubits, false);
+    for (const auto& bit : m_measuredBits)
+    {
+        isMeasured[bit] = true;
+    }
+    // Qubits after the last measured one are traced out by the right environment.
+    const size_t firstSite = *std::min_element(m_measuredBits.begin(), m_measuredBits.end());
+    const size_t lastSite = *std::max_element(m_measuredBits.begin(), m_measuredBits.end());
+    // Right environments (traced out sites i..n-1) are independent of the samples: compute them once.
+    std::vector<std::string> rightEnvTensorNames(nbQubits + 1);
+    for (size_t i = nbQubits - 1; i > firstSite; --i)
+    {
+        rightEnvTensorNames[i] = contractRightEnvironment(rightEnvTensorNames[i + 1], i);
+    }
+
+    constexpr std::array<double, 2> IDENTITY_OP { 1.0, 1.0 };
+    const std::array<std::array<double, 2>, 2> PROJECTORS { std::array<double, 2>{ 1.0, 0.0 }, std::array<double, 2>{ 0.0, 1.0 } };
+    // Select an outcome given the (unnormalized) conditional probabilities.
+    const auto selectOutcome = [](double in_prob0, double in_prob1) -> uint8_t {
+        in_prob0 = std::max(in_prob0, 0.0);
+        in_prob1 = std::max(in_prob1, 0.0);
+        assert(in_prob0 + in_prob1 > 0.0);
+        return (getRandomProbability() * (in_prob0 + in_prob1) < in_prob0) ? 0 : 1;
+    };
+
+    std::vector<std::string> result;
+    result.reserve(in_nbShots);
+    for (int shotId = 0; shotId < in_nbShots; ++shotId)
+    {
+        std::vector<uint8_t> sampledBits(nbQubits, 0);
+        // Left environment: sites before i, projected onto the sampled values.
+        std::string envTensorName;
+        for (size_t i = 0; i <= lastSite; ++i)
+        {
+            if (i == nbQubits - 1)
+            {
+                // Last site (hence, measured)
+                const double prob0 = closeLeftEnvironment(envTensorName, PROJECTORS[0]).real();
+                const double prob1 = closeLeftEnvironment(envTensorName, PROJECTORS[1]).real();
+                sampledBits[i] = selectOutcome(prob0, prob1);
+                break;
+            }
+
+            std::string newEnvTensorName;
+            if (!isMeasured[i])
+            {
+                newEnvTensorName = contractLeftEnvironment(envTensorName, i, IDENTITY_OP);
+            }
+            else
+            {
+                // Conditional probabilities: close the projected left environments with the right environment.
+                const std::string env0TensorName = contractLeftEnvironment(envTensorName, i, PROJECTORS[0]);
+                const std::string env1TensorName = contractLeftEnvironment(envTensorName, i, PROJECTORS[1]);
+                const double prob0 = contractAllLegs(env0TensorName, rightEnvTensorNames[i + 1]).real();
+                const double prob1 = contractAllLegs(env1TensorName, rightEnvTensorNames[i + 1]).real();
+                sampledBits[i] = selectOutcome(prob0, prob1);
+                newEnvTensorName = (sampledBits[i] == 0) ? env0TensorName : env1TensorName;
+                m_tensorPool.releaseScratchTensor((sampledBits[i] == 0) ? env1TensorName : env0TensorName);
+            }
+
+            if (!envTensorName.empty())
+            {
+                m_tensorPool.releaseScratchTensor(envTensorName);
+            }
+            envTensorName = newEnvTensorName;
+        }
+
+        if (!envTensorName.empty())
+        {
+            m_tensorPool.releaseScratchTensor(envTensorName);
+        }
+        result.emplace_back(generateResultBitString(sampledBits, m_measuredBits, m_noiseConfig.get()));
+    }
+
+    for (const auto& tensorName : rightEnvTensorNames)
+    {
+        if (!tensorName.empty())
+        {
+            m_tensorPool.releaseScratchTensor(tensorName);
+        }
+    }
+    return result;
 }
 
 void ExaTnPmpsVisitor::truncateSvdTensors(const std::string& in_leftTensorName, const std::string& in_rightTensorName, double in_eps)
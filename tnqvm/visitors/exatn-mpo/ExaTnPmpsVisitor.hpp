@@ -3,6 +3,9 @@
 #include "TNQVMVisitor.hpp"
 #include "tensor_network.hpp"
 #include "exatn.hpp"
+#include "ExaTnTensorPool.hpp"
+#include "ExaTnNoiseTensorCache.hpp"
+#include <array>
 
 // Purified-MPS visitor:
 // Name: "exatn-pmps"
@@ -14,7 +17,11 @@
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
 // | backend                     | Name of the IBMQ backend to query the backend configuration.           |    string   | None                     |
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | density-matrix              | Add the (dense) density matrix as `density_matrix` (up to 12 qubits).  |    bool     | false                    |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
 // If either `backend-json` or `backend` is provided, the `exatn-pmps` simulator will simulate the backend noise associated with each quantum gate.
+// If no shots are requested, the exact expectation value <Z...Z> of the measured qubits (including readout errors) is also added as `exp-val-z`.
+// The execution info `noise-cache-misses` (int) is the number of distinct (gate, qubits) noise channels converted during the execution.
 
 namespace xacc {
 // Forward declaration
@@ -22,13 +29,6 @@ class NoiseModel;
 struct NoiseChannelKraus;
 } // namespace xacc
 namespace tnqvm {
-// Single-site Kraus Op (this Accelerator can only model this)
-struct KrausOp {
-  size_t qubit;
-  // Choi matrix
-  std::vector<std::vector<std::complex<double>>> mats;
-};
-
 class ExaTnPmpsVisitor : public TNQVMVisitor
 {
 public:
@@ -67,6 +67,9 @@ public:
     virtual void visit(Measure& in_MeasureGate) override;
 
     virtual const double getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function) override;
+    // Generic k-qubit gate: the sites spanned by the qubits are merged, U is applied on the physical legs
+    // (the Kraus legs are untouched), then the block is split back with SVDs. No noise channel is applied.
+    virtual void applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix) override;
     class ExaTnTensorFunctor : public talsh::TensorFunctor<exatn::Identifiable>
     {
     public:
@@ -86,16 +89,45 @@ public:
     [[nodiscard]] exatn::TensorNetwork buildInitialNetwork(size_t in_nbQubits, bool in_createQubitTensors) const;
     void applySingleQubitGate(xacc::quantum::Gate& in_gateInstruction);
     void applyTwoQubitGate(xacc::quantum::Gate& in_gateInstruction);
-    void applyKrausOp(const KrausOp& in_op);
     // Apply a local (single-site) Kraus operator
+    // Note: the operator tensor is not destroyed (it is owned by a tensor pool or the noise tensor cache).
     void applyLocalKrausOp(size_t in_siteId, const std::string& in_opTensorName);
     void truncateSvdTensors(const std::string& in_leftTensorName, const std::string& in_rightTensorName, double in_eps = 1e-9);
-    std::vector<KrausOp> convertNoiseChannel(const std::vector<NoiseChannelKraus>& in_channels) const;
+    // Apply the noise channels of the noise model (if any) after this gate
+    void applyNoise(xacc::quantum::Gate& in_gateInstruction);
+    // Exact <Z...Z> of the given qubits, i.e. Tr(rho * Z...Z), computed on the PMPS.
+    // Readout errors of the noise model (if any) are folded into the Z operators.
+    double computeExpectationValueZ(const std::vector<size_t>& in_bits);
+    // Contracts the PMPS with its conjugate through a diagonal operator on the physical leg of each site,
+    // i.e. Tr(rho * (D_0 x D_1 x ... x D_n-1)), by a left-to-right sweep over the sites: O(n * chi^3 * kappa).
+    std::complex<double> contractWithDiagonalOps(const std::vector<std::array<double, 2>>& in_diagOps);
+    // Left environment E(r,u) (ket bond, bra bond) of sites 0..in_siteId (in_siteId < n-1), with a diagonal operator on site in_siteId,
+    // given the left environment of sites 0..in_siteId-1 (empty for site 0).
+    // Returns a scratch tensor of the pool; the input environment is not released.
+    std::string contractLeftEnvironment(const std::string& in_leftEnvTensorName, size_t in_siteId, const std::array<double, 2>& in_diagOp);
+    // Contracts the last site (with a diagonal operator) into its left environment.
+    std::complex<double> closeLeftEnvironment(const std::string& in_leftEnvTensorName, const std::array<double, 2>& in_diagOp);
+    // Right environment R(l,u) of sites in_siteId..n-1 (traced out), given that of sites in_siteId+1..n-1 (empty for the last site).
+    std::string contractRightEnvironment(const std::string& in_rightEnvTensorName, size_t in_siteId);
+    // Samples measurement bit strings from the PMPS qubit-by-qubit (conditional probabilities),
+    // using left environments projected on the sampled values and cached right environments.
+    std::vector<std::string> sampleMeasuredBits(int in_nbShots);
 private:
     exatn::TensorNetwork m_pmpsTensorNetwork;
     std::shared_ptr<AcceleratorBuffer> m_buffer;
     std::shared_ptr<xacc::NoiseModel> m_noiseConfig;
     std::vector<size_t> m_measuredBits;
     int m_nbShots;
+    // Did the caller request shots (otherwise, exp-val-z is computed exactly)?
+    bool m_shotsRequested;
+    // Add the dense density matrix to the buffer (only for small circuits)
+    bool m_outputDensityMatrix;
+    static constexpr size_t MAX_QUBITS_DENSITY_MATRIX = 12;
+    // Max number of gate (and Kraus) tensors to keep in m_tensorPool
+    static constexpr size_t MAX_CACHED_GATE_TENSORS = 256;
+    // Reusable scratch and gate tensors
+    ExaTnTensorPool m_tensorPool;
+    // Noise channel tensors by (gate, qubits), kept across executions of the same noise model
+    ExaTnNoiseTensorCache m_noiseTensorCache;
 };
 } // namespace tnqvm
\ No newline at end of file
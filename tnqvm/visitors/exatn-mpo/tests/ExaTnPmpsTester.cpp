@@ -1,7 +1,9 @@
 #include <memory>
+#include <cmath>
 #include <gtest/gtest.h>
 #include "xacc.hpp"
 #include "xacc_service.hpp"
+#include "TNQVMVisitor.hpp"
 
 namespace {
 std::string getBackendJson() {
@@ -81,6 +83,112 @@ TEST(ExaTnPmpsTester, checkBell) {
   EXPECT_LT(qreg->computeMeasurementProbability("11"), 0.99);
 }
 
+TEST(ExaTnPmpsTester, checkExpValZ) {
+  auto xasmCompiler = xacc::getCompiler("xasm");
+  auto ir = xasmCompiler->compile(R"(__qpu__ void testExpVal(qbit q) {
+    Ry(q[0], 0.3);
+    CX(q[0],q[1]);
+    X(q[2]);
+    Ry(q[3], 0.7);
+    Measure(q[1]);
+    Measure(q[2]);
+    Measure(q[3]);
+  })");
+
+  auto program = ir->getComposite("testExpVal");
+  // No noise, no shots: exact <Z1Z2Z3>
+  auto accelerator =
+      xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-pmps"}});
+  auto qreg = xacc::qalloc(4);
+  accelerator->execute(qreg, program);
+  qreg->print();
+  EXPECT_NEAR((*qreg)["exp-val-z"].as<double>(), -std::cos(0.3) * std::cos(0.7), 1e-6);
+}
+
+TEST(ExaTnPmpsTester, checkSamplingLarge) {
+  // GHZ state: too large for the dense density matrix (4^20 elements).
+  const int nbQubits = 20;
+  auto xasmCompiler = xacc::getCompiler("xasm");
+  auto ir = xasmCompiler->compile(R"(__qpu__ void testGhz(qbit q) {
+    H(q[0]);
+    for (int i = 0; i < 19; i++) {
+      CX(q[i], q[i + 1]);
+    }
+    for (int i = 0; i < 20; i++) {
+      Measure(q[i]);
+    }
+  })");
+
+  auto program = ir->getComposite("testGhz");
+  auto accelerator = xacc::getAccelerator(
+      "tnqvm", {{"tnqvm-visitor", "exatn-pmps"}, {"shots", 1024}});
+  auto qreg = xacc::qalloc(nbQubits);
+  accelerator->execute(qreg, program);
+  const auto counts = qreg->getMeasurementCounts();
+  // Only all-0 and all-1 results
+  EXPECT_EQ(counts.size(), 2);
+  EXPECT_NEAR(qreg->computeMeasurementProbability(std::string(nbQubits, '0')), 0.5, 0.1);
+  EXPECT_NEAR(qreg->computeMeasurementProbability(std::string(nbQubits, '1')), 0.5, 0.1);
+  EXPECT_FALSE(qreg->hasExtraInfoKey("density_matrix"));
+}
+
+TEST(ExaTnPmpsTester, checkGenericGateMatrix) {
+  auto gateRegistry = xacc::getIRProvider("quantum");
+  {
+    // Toffoli gate as an 8x8 matrix (first qubit is the MSB)
+    std::vector<std::vector<std::complex<double>>> toffoliMat(
+        8, std::vector<std::complex<double>>(8, 0.0));
+    for (size_t i = 0; i < 6; ++i) {
+      toffoliMat[i][i] = 1.0;
+    }
+    toffoliMat[6][7] = 1.0;
+    toffoliMat[7][6] = 1.0;
+
+    auto visitor =
+        xacc::getService<tnqvm::TNQVMVisitor>("exatn-pmps")->clone();
+    auto qubitReg = xacc::qalloc(5);
+    // No shots: exact exp-val-z
+    visitor->initialize(qubitReg, -1);
+    gateRegistry->createInstruction("X", std::vector<std::size_t>{0})
+        ->accept(visitor);
+    gateRegistry->createInstruction("X", std::vector<std::size_t>{2})
+        ->accept(visitor);
+    // Non-adjacent qubits (identity on q1), target (q3) is the LSB.
+    visitor->applyGateMatrix({0, 2, 3}, toffoliMat);
+    // Unsorted qubits: controls q3, q4 (not set), target q1.
+    visitor->applyGateMatrix({3, 4, 1}, toffoliMat);
+    gateRegistry->createInstruction("Measure", std::vector<std::size_t>{3})
+        ->accept(visitor);
+    gateRegistry->createInstruction("Measure", std::vector<std::size_t>{4})
+        ->accept(visitor);
+    visitor->finalize();
+    // q3 = 1, q4 = 0
+    EXPECT_NEAR((*qubitReg)["exp-val-z"].as<double>(), -1.0, 1e-9);
+  }
+  {
+    // CNOT matrix (control is the MSB) on non-adjacent qubits, control q2 and
+    // target q0: <Z0> = cos(theta)
+    const double theta = 0.3;
+    const std::vector<std::vector<std::complex<double>>> cnotMat{
+        {1.0, 0.0, 0.0, 0.0},
+        {0.0, 1.0, 0.0, 0.0},
+        {0.0, 0.0, 0.0, 1.0},
+        {0.0, 0.0, 1.0, 0.0}};
+    auto visitor =
+        xacc::getService<tnqvm::TNQVMVisitor>("exatn-pmps")->clone();
+    auto qubitReg = xacc::qalloc(3);
+    visitor->initialize(qubitReg, -1);
+    auto ry = gateRegistry->createInstruction("Ry", std::vector<std::size_t>{2});
+    ry->setParameter(0, xacc::InstructionParameter(theta));
+    ry->accept(visitor);
+    visitor->applyGateMatrix({2, 0}, cnotMat);
+    gateRegistry->createInstruction("Measure", std::vector<std::size_t>{0})
+        ->accept(visitor);
+    visitor->finalize();
+    EXPECT_NEAR((*qubitReg)["exp-val-z"].as<double>(), std::cos(theta), 1e-6);
+  }
+}
+
 int main(int argc, char **argv) {
   xacc::Initialize();
   ::testing::InitGoogleTest(&argc, argv);
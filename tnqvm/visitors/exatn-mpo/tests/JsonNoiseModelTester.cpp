@@ -30,7 +30,8 @@ TEST(JsonNoiseModelTester, checkSimple) {
     noiseModel->initialize({{"noise-model", depol_json}});
     auto accelerator =
         xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-pmps"},
-                                       {"noise-model", noiseModel}});
+                                       {"noise-model", noiseModel},
+                                       {"density-matrix", true}});
     auto xasmCompiler = xacc::getCompiler("xasm");
     auto program = xasmCompiler
                        ->compile(R"(__qpu__ void testX(qbit q) {
@@ -104,6 +105,8 @@ TEST(JsonNoiseModelTester, checkRoError) {
     buffer->print();
     // P(1|0) = 0.1
     EXPECT_NEAR(buffer->computeMeasurementProbability("1"), 0.1, 0.05);
+    // Exact exp-val-z (no shots): 1 - 2*P(1|0)
+    EXPECT_NEAR((*buffer)["exp-val-z"].as<double>(), 0.8, 1e-6);
   }
   {
     auto program = xasmCompiler
@@ -119,6 +122,8 @@ TEST(JsonNoiseModelTester, checkRoError) {
     buffer->print();
     // P(0|1) = 0.2
     EXPECT_NEAR(buffer->computeMeasurementProbability("0"), 0.2, 0.05);
+    // Exact exp-val-z (no shots): 2*P(0|1) - 1
+    EXPECT_NEAR((*buffer)["exp-val-z"].as<double>(), -0.6, 1e-6);
   }
 }
 
@@ -14,6 +14,8 @@ public:
   void Start(BundleContext context) 
   {
     context.RegisterService<tnqvm::TNQVMVisitor>(std::make_shared<tnqvm::ExatnMpsVisitor>());
+    context.RegisterService<tnqvm::TNQVMVisitor>(std::make_shared<tnqvm::DoublePrecisionExatnMpsVisitor>());
+    context.RegisterService<tnqvm::TNQVMVisitor>(std::make_shared<tnqvm::SinglePrecisionExatnMpsVisitor>());
     context.RegisterService<xacc::IRTransformation>(std::make_shared<xacc::quantum::NearestNeighborTransform>());
     context.RegisterService<xacc::Instruction>(std::make_shared<xacc::circuits::RCS>());
   }
@@ -5,6 +5,8 @@
 #include "ExatnUtils.hpp"
 #include "utils/GateMatrixAlgebra.hpp"
 #include <map>
+#include <numeric>
+#include <set>
 #include <unistd.h>
 #ifdef TNQVM_EXATN_USES_MKL_BLAS
 #include <dlfcn.h>
@@ -22,26 +24,81 @@ const std::string ROOT_TENSOR_NAME = "Root";
 // it's faster to just run bit-string simulation on the state vector.    
 const int MAX_NUMBER_QUBITS_FOR_STATE_VEC = 20;
 
+// Copies the body of a local tensor to the host (in double precision),
+// the tensor can be stored in either double (COMPLEX64) or single (COMPLEX32) precision.
+bool readTensorBody(talsh::Tensor& in_tensor, std::vector<std::complex<double>>& out_data)
+{
+    const std::complex<double>* doubleBody;
+    if (in_tensor.getDataAccessHostConst(&doubleBody))
+    {
+        out_data.assign(doubleBody, doubleBody + in_tensor.getVolume());
+        return true;
+    }
+    const std::complex<float>* floatBody;
+    if (in_tensor.getDataAccessHostConst(&floatBody))
+    {
+        out_data.assign(floatBody, floatBody + in_tensor.getVolume());
+        return true;
+    }
+    return false;
+}
+
+// Overwrites the body of a local tensor (double or single precision) with the given (double precision) data.
+bool writeTensorBody(talsh::Tensor& in_tensor, const std::vector<std::complex<double>>& in_data)
+{
+    if (in_tensor.getVolume() != in_data.size())
+    {
+        return false;
+    }
+    std::complex<double>* doubleBody;
+    if (in_tensor.getDataAccessHost(&doubleBody))
+    {
+        std::copy(in_data.begin(), in_data.end(), doubleBody);
+        return true;
+    }
+    std::complex<float>* floatBody;
+    if (in_tensor.getDataAccessHost(&floatBody))
+    {
+        for (size_t i = 0; i < in_data.size(); ++i)
+        {
+            floatBody[i] = static_cast<std::complex<float>>(in_data[i]);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Initializes the body of a tensor of the given element type from double precision data.
+bool initTensorBody(const std::string& in_tensorName, exatn::TensorElementType in_elementType, const std::vector<std::complex<double>>& in_data, bool in_sync = true)
+{
+    if (in_elementType == exatn::TensorElementType::COMPLEX32)
+    {
+        const std::vector<std::complex<float>> floatData(in_data.begin(), in_data.end());
+        return in_sync ? exatn::initTensorDataSync(in_tensorName, floatData) : exatn::initTensorData(in_tensorName, floatData);
+    }
+    assert(in_elementType == exatn::TensorElementType::COMPLEX64);
+    return in_sync ? exatn::initTensorDataSync(in_tensorName, in_data) : exatn::initTensorData(in_tensorName, in_data);
+}
+
 void printTensorData(const std::string& in_tensorName)
 {
-    auto talsh_tensor = exatn::getLocalTensor(in_tensorName); 
+    auto talsh_tensor = exatn::getLocalTensor(in_tensorName);
     if (talsh_tensor)
     {
-        const std::complex<double>* body_ptr;
-        const bool access_granted = talsh_tensor->getDataAccessHostConst(&body_ptr); 
+        std::vector<std::complex<double>> tensorData;
+        const bool access_granted = readTensorBody(*talsh_tensor, tensorData);
         if (!access_granted)
         {
             std::cout << "Failed to retrieve tensor data!!!\n";
         }
         else
         {
-            for (int i = 0; i < talsh_tensor->getVolume(); ++i)
+            for (const auto& elem : tensorData)
             {
-                const auto& elem = body_ptr[i];
                 std::cout << elem << "\n";
             }
         }
-        
+
     }
     else
     {
@@ -56,17 +113,54 @@ std::vector<std::complex<double>> getTensorData(const std::string& in_tensorName
     
     if (talsh_tensor)
     {
-        std::complex<double>* body_ptr;
-        const bool access_granted = talsh_tensor->getDataAccessHost(&body_ptr); 
-
-        if (access_granted)
-        {
-            result.assign(body_ptr, body_ptr + talsh_tensor->getVolume());
-        }
+        readTensorBody(*talsh_tensor, result);
     }
     return result;
 } 
 
+// Replaces a tensor with a new one (same name) of the given shape and body.
+void resetTensor(const std::string& in_tensorName, exatn::TensorElementType in_elementType, const std::vector<exatn::DimExtent>& in_shape, const std::vector<std::complex<double>>& in_data)
+{
+    const bool destroyed = exatn::destroyTensorSync(in_tensorName);
+    assert(destroyed);
+    const bool created = exatn::createTensorSync(in_tensorName, in_elementType, in_shape);
+    assert(created);
+    const bool initialized = initTensorBody(in_tensorName, in_elementType, in_data);
+    assert(initialized);
+}
+
+// Leg labels in_prefix0, in_prefix1, ..., each followed by a comma, e.g. "s0,s1,".
+std::string getLegLabels(const std::string& in_prefix, size_t in_count)
+{
+    std::string result;
+    for (size_t i = 0; i < in_count; ++i)
+    {
+        result += in_prefix + std::to_string(i) + ",";
+    }
+    return result;
+}
+
+// Leg labels (from getLegLabels) placed after other legs, e.g. "s0,s1," => ",s0,s1".
+std::string getTrailingLegs(const std::string& in_legLabels)
+{
+    return in_legLabels.empty() ? "" : "," + in_legLabels.substr(0, in_legLabels.size() - 1);
+}
+
+// Replaces a tensor with a new one (same name) of the given shape, copying the body of another tensor of that shape (on the device).
+void resetTensorFrom(const std::string& in_tensorName, exatn::TensorElementType in_elementType, const std::vector<exatn::DimExtent>& in_shape,
+                     const std::string& in_sourceTensorName)
+{
+    const bool destroyed = exatn::destroyTensorSync(in_tensorName);
+    assert(destroyed);
+    const bool created = exatn::createTensorSync(in_tensorName, in_elementType, in_shape);
+    assert(created);
+    const bool initialized = exatn::initTensorSync(in_tensorName, 0.0);
+    assert(initialized);
+    const std::string legs = "(" + getTrailingLegs(getLegLabels("a", in_shape.size())).substr(1) + ")";
+    const bool copied = exatn::addTensorsSync(in_tensorName + legs + "+=" + in_sourceTensorName + legs, 1.0);
+    assert(copied);
+}
+
 std::unordered_map<std::string, tnqvm::Stat::FunctionCallStat>& getStatRegistry()
 {
     static std::unordered_map<std::string, tnqvm::Stat::FunctionCallStat> statMap;
@@ -105,13 +199,58 @@ inline bool indexInRange(size_t in_idx, const std::pair<size_t, size_t>& in_rang
 {
     return (in_idx >= in_range.first) && (in_idx <= in_range.second);
 }
+
+#ifdef TNQVM_MPI_ENABLED
+// Splits the MPS sites into contiguous ranges (one per rank, at least one site each)
+// balancing the given per-site costs: each rank takes its fair share of the remaining cost.
+// Returns the first site index of each rank.
+std::vector<size_t> partitionSites(const std::vector<double>& in_siteCosts, size_t in_nbRanks)
+{
+    assert(in_siteCosts.size() >= in_nbRanks);
+    std::vector<size_t> firstSites(in_nbRanks, 0);
+    double remainingCost = std::accumulate(in_siteCosts.begin(), in_siteCosts.end(), 0.0);
+    size_t site = 0;
+    for (size_t rank = 0; rank < in_nbRanks; ++rank)
+    {
+        firstSites[rank] = site;
+        if (rank == in_nbRanks - 1)
+        {
+            break;
+        }
+        const double targetCost = remainingCost / (in_nbRanks - rank);
+        // Leave (at least) one site for each of the remaining ranks.
+        const size_t siteLimit = in_siteCosts.size() - (in_nbRanks - rank - 1);
+        double rankCost = in_siteCosts[site++];
+        // Take the next site if that gets closer to the target.
+        while (site < siteLimit && (rankCost + in_siteCosts[site] - targetCost) < (targetCost - rankCost))
+        {
+            rankCost += in_siteCosts[site++];
+        }
+        remainingCost -= rankCost;
+    }
+    return firstSites;
+}
+#endif
 }
 namespace tnqvm {
 ExatnMpsVisitor::ExatnMpsVisitor():
     m_aggregator(this),
-    // By default, don't enable aggregation, i.e. simply running gate-by-gate first. 
-    // TODO: implement aggreation processing with ExaTN.
-    m_aggregateEnabled(false)
+    // Gate aggregation (merging gates into blocks before contracting them into the MPS)
+    // is disabled by default, i.e. gate-by-gate; the "agg-width" option enables it.
+    m_aggregateEnabled(false),
+    m_asyncTwoQubitGates(true),
+    m_maxPendingSites(0),
+    m_tensorPool("Mps", MAX_CACHED_GATE_TENSORS),
+    m_canonicalForm(false),
+    m_orthoCenter(-1),
+    m_fidelityTarget(1.0),
+    m_maxMemoryMb(0.0),
+    m_elementType(exatn::TensorElementType::COMPLEX64),
+    m_longRangeGates(false),
+    m_variationalCompression(false),
+    m_workingBondDim(0),
+    m_variationalSweeps(2),
+    m_isCompressing(false)
 {
     // TODO
 }
@@ -120,14 +259,18 @@ void ExatnMpsVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int
 { 
     const auto initializeStart = std::chrono::system_clock::now();
 
-    // Check if we have any specific config for the gate aggregator
-    if (m_aggregateEnabled && options.keyExists<int>("agg-width"))
+    // Gate aggregation (block gates) is enabled by the "agg-width" option.
+    m_aggregateEnabled = false;
+#ifndef TNQVM_MPI_ENABLED
+    if (options.keyExists<int>("agg-width"))
     {
+        m_aggregateEnabled = true;
         const int aggregatorWidth = options.get<int>("agg-width");
         AggregatorConfigs configs(aggregatorWidth);
         TensorAggregator newAggr(configs, this);
         m_aggregator = newAggr;
     }
+#endif
 
     // Initialize ExaTN
     if (!exatn::isInitialized()) {
@@ -214,6 +357,141 @@ void ExatnMpsVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int
         m_maxBondDim = options.get<int>("max-bond-dim");
         std::cout << "[DEBUG] Max bond dimension = " << m_maxBondDim << "\n";
     }
+
+    m_asyncTwoQubitGates = true;
+    if (options.keyExists<bool>("async-gates"))
+    {
+        m_asyncTwoQubitGates = options.get<bool>("async-gates");
+    }
+    m_pendingTwoQubitGates.clear();
+    m_pendingSites.clear();
+    m_pendingSingleQubitGates.clear();
+    m_maxPendingSites = 0;
+
+    // Off by default: two-qubit gates on disjoint sites can then be submitted asynchronously.
+    // Features that need the canonical form (truncation budget, long-range gates, variational compression) turn it on.
+    m_canonicalForm = false;
+    const bool canonicalFormSet = options.keyExists<bool>("canonical-form");
+    if (canonicalFormSet)
+    {
+        m_canonicalForm = options.get<bool>("canonical-form");
+    }
+    // The initial product state is in canonical form w.r.t. any site.
+    m_orthoCenter = 0;
+
+    m_fidelityTarget = 1.0;
+    if (options.keyExists<double>("fidelity-target"))
+    {
+        m_fidelityTarget = options.get<double>("fidelity-target");
+        if (m_fidelityTarget <= 0.0 || m_fidelityTarget > 1.0)
+        {
+            xacc::error("Invalid 'fidelity-target' value: must be in (0, 1].");
+        }
+#ifdef TNQVM_MPI_ENABLED
+        if (m_fidelityTarget < 1.0)
+        {
+            xacc::warning("'fidelity-target' is not supported in MPI mode: ignored.");
+            m_fidelityTarget = 1.0;
+        }
+#endif
+    }
+    m_maxMemoryMb = 0.0;
+    if (options.keyExists<double>("max-mps-memory-mb"))
+    {
+        m_maxMemoryMb = options.get<double>("max-mps-memory-mb");
+#ifdef TNQVM_MPI_ENABLED
+        if (m_maxMemoryMb > 0.0)
+        {
+            xacc::warning("'max-mps-memory-mb' is not supported in MPI mode: ignored.");
+            m_maxMemoryMb = 0.0;
+        }
+#endif
+    }
+    if ((m_fidelityTarget < 1.0 || m_maxMemoryMb > 0.0) && !m_canonicalForm)
+    {
+        if (canonicalFormSet)
+        {
+            xacc::warning("'fidelity-target' and 'max-mps-memory-mb' require the canonical form: 'canonical-form' is ignored.");
+        }
+        m_canonicalForm = true;
+    }
+    m_longRangeGates = false;
+    if (options.keyExists<bool>("long-range-gates"))
+    {
+        m_longRangeGates = options.get<bool>("long-range-gates");
+#ifdef TNQVM_MPI_ENABLED
+        if (m_longRangeGates)
+        {
+            xacc::warning("'long-range-gates' is not supported in MPI mode: ignored.");
+            m_longRangeGates = false;
+        }
+#endif
+        if (m_longRangeGates && m_aggregateEnabled)
+        {
+            xacc::warning("'long-range-gates' is not supported with 'agg-width': ignored.");
+            m_longRangeGates = false;
+        }
+        if (m_longRangeGates && !m_canonicalForm)
+        {
+            if (canonicalFormSet)
+            {
+                xacc::warning("'long-range-gates' requires the canonical form: 'canonical-form' is ignored.");
+            }
+            m_canonicalForm = true;
+        }
+    }
+    m_variationalCompression = false;
+    m_isCompressing = false;
+    if (options.keyExists<bool>("variational-compression"))
+    {
+        m_variationalCompression = options.get<bool>("variational-compression");
+#ifdef TNQVM_MPI_ENABLED
+        if (m_variationalCompression)
+        {
+            xacc::warning("'variational-compression' is not supported in MPI mode: ignored.");
+            m_variationalCompression = false;
+        }
+#endif
+        if (m_variationalCompression && !options.keyExists<int>("max-bond-dim"))
+        {
+            xacc::warning("'variational-compression' requires 'max-bond-dim': ignored.");
+            m_variationalCompression = false;
+        }
+        if (m_variationalCompression && !m_canonicalForm)
+        {
+            if (canonicalFormSet)
+            {
+                xacc::warning("'variational-compression' requires the canonical form: 'canonical-form' is ignored.");
+            }
+            m_canonicalForm = true;
+        }
+    }
+    // Gates are applied (locally truncated) at the working bond dimension,
+    // the MPS is compressed back to max-bond-dim once a bond reaches it.
+    m_workingBondDim = m_variationalCompression ? 2 * m_maxBondDim : m_maxBondDim;
+    if (m_variationalCompression && options.keyExists<int>("variational-bond-dim"))
+    {
+        m_workingBondDim = options.get<int>("variational-bond-dim");
+        if (m_workingBondDim <= m_maxBondDim)
+        {
+            xacc::error("Invalid 'variational-bond-dim' value: must be larger than 'max-bond-dim'.");
+        }
+    }
+    m_variationalSweeps = 2;
+    if (options.keyExists<int>("variational-sweeps"))
+    {
+        m_variationalSweeps = options.get<int>("variational-sweeps");
+    }
+    m_truncationInfo = TruncationInfo();
+    m_elementType = getExatnElementType();
+#ifdef TNQVM_MPI_ENABLED
+    // Independent random streams (measurement sampling) across MPI processes.
+    std::seed_seq seedSeq{ std::random_device{}(), static_cast<unsigned int>(exatn::getProcessRank()) };
+    m_randomEngine.seed(seedSeq);
+#else
+    m_randomEngine.seed(std::random_device{}());
+#endif
+    executionInfo.clear();
    
     m_buffer = std::move(buffer);
     m_qubitTensorNames.clear();
@@ -263,9 +541,9 @@ void ExatnMpsVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int
             auto tensor = iter->second.getTensor();
             const auto newTensorName = "Q" + std::to_string(iter->first - 1);
             iter->second.getTensor()->rename(newTensorName);
-            const bool created = exatn::createTensorSync(tensor, exatn::TensorElementType::COMPLEX64);
+            const bool created = exatn::createTensorSync(tensor, m_elementType);
             assert(created);
-            const bool initialized = exatn::initTensorDataSync(newTensorName, Q_ZERO_TENSOR_BODY);
+            const bool initialized = initTensorBody(newTensorName, m_elementType, Q_ZERO_TENSOR_BODY);
             assert(initialized);
         }
     }
@@ -388,45 +666,40 @@ void ExatnMpsVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int
 
     if (process_group.getSize() < m_buffer->size())
     {
-        const size_t lRange = (process_rank * m_buffer->size()) / process_group.getSize();
-        const size_t hRange = (process_rank != (process_group.getSize() - 1)) ? 
-            ((process_rank + 1) * m_buffer->size()) / process_group.getSize() - 1 :
-            m_buffer->size() - 1;
-        
-        m_qubitRange = std::make_pair(lRange, hRange);
+        // Initially, all sites (bond dimension 1) have the same cost.
+        updateQubitPartition(partitionSites(std::vector<double>(m_buffer->size(), 1.0), process_group.getSize()));
+        m_initialPartition.assign(m_rankFirstSites.begin(), m_rankFirstSites.end());
     }
     else
     {
         // Each qubit to one process
+        m_rankFirstSites.clear();
+        m_initialPartition.clear();
         m_qubitRange = std::make_pair(process_rank, process_rank);
+        for (int i = 0; i < m_buffer->size(); ++i) 
+        {
+            m_qubitIdxToRank.emplace(i, i);
+        }
     }
-
     // std::cout << "Process [" << process_rank << "]: handles qubit " << m_qubitRange.first << " to " << m_qubitRange.second << "\n";  
 
-    if (m_buffer->size() > process_group.getSize())
+    m_rebalanceInterval = 0;
+    if (options.keyExists<int>("mpi-rebalance-interval"))
     {
-        for (int rank = 0; rank < process_group.getSize(); ++rank)
-        {
-            const size_t lRange = rank * (m_buffer->size() / process_group.getSize());
-            const size_t hRange = (rank != (process_group.getSize() - 1)) ? 
-                (rank + 1) * (m_buffer->size() / process_group.getSize()) - 1 :
-                m_buffer->size() - 1;
-            for (int i = lRange; i <= hRange; ++i) 
-            {
-                if (i < m_buffer->size())
-                {
-                    m_qubitIdxToRank.emplace(i, rank);
-                }
-            } 
-        }
+        m_rebalanceInterval = options.get<int>("mpi-rebalance-interval");
     }
-    else
+    m_rebalanceThreshold = 1.25;
+    if (options.keyExists<double>("mpi-rebalance-threshold"))
     {
-        for (int i = 0; i < m_buffer->size(); ++i) 
+        m_rebalanceThreshold = options.get<double>("mpi-rebalance-threshold");
+        if (m_rebalanceThreshold < 1.0)
         {
-            m_qubitIdxToRank.emplace(i, i);
+            xacc::error("Invalid 'mpi-rebalance-threshold' value: must be at least 1.0.");
         }
     }
+    m_twoQubitGateCount = 0;
+    m_rebalanceEvents.clear();
+    m_lentSites.clear();
 
     const std::vector<int> qubitTensorDim(m_buffer->size(), 2);
     m_rootTensor = std::make_shared<exatn::Tensor>(ROOT_TENSOR_NAME, qubitTensorDim);
@@ -468,9 +741,9 @@ void ExatnMpsVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int
             auto tensor = iter->second.getTensor();
             const auto newTensorName = "Q" + std::to_string(iter->first - 1);
             iter->second.getTensor()->rename(newTensorName);
-            const bool created = exatn::createTensorSync(*m_selfProcessGroup, tensor, exatn::TensorElementType::COMPLEX64);
+            const bool created = exatn::createTensorSync(*m_selfProcessGroup, tensor, m_elementType);
             assert(created);
-            const bool initialized = exatn::initTensorDataSync(newTensorName, Q_ZERO_TENSOR_BODY);
+            const bool initialized = initTensorBody(newTensorName, m_elementType, Q_ZERO_TENSOR_BODY);
             assert(initialized);
         }
     }
@@ -493,20 +766,19 @@ void ExatnMpsVisitor::printStateVec()
     assert(evaledOk); 
 #endif
 
-    auto talsh_tensor = exatn::getLocalTensor(ket.getTensor(0)->getName()); 
+    auto talsh_tensor = exatn::getLocalTensor(ket.getTensor(0)->getName());
     if (talsh_tensor)
     {
-        const std::complex<double>* body_ptr;
-        const bool access_granted = talsh_tensor->getDataAccessHostConst(&body_ptr); 
+        std::vector<std::complex<double>> tensorData;
+        const bool access_granted = readTensorBody(*talsh_tensor, tensorData);
         if (!access_granted)
         {
             std::cout << "Failed to retrieve tensor data!!!\n";
         }
         else
         {
-            for (int i = 0; i < talsh_tensor->getVolume(); ++i)
+            for (const auto& elem : tensorData)
             {
-                const auto& elem = body_ptr[i];
                 std::cout << elem << "\n";
             }
         }
@@ -526,12 +798,19 @@ void ExatnMpsVisitor::finalize()
     // Always reset the logging level back to 0 when finished.
     exatn::resetClientLoggingLevel(0);
     exatn::resetRuntimeLoggingLevel(0);
+    syncTwoQubitGates();
 
     if (m_aggregateEnabled)
     {
-        m_aggregator.flushAll();    
-        evaluateTensorNetwork(*m_tensorNetwork, m_stateVec);
+        m_aggregator.flushAll();
     }
+    compressIfNeeded(true);
+
+    // Truncation summary
+    executionInfo.insert("discarded-weight", m_truncationInfo.discardedWeight);
+    executionInfo.insert("estimated-fidelity", m_truncationInfo.estimatedFidelity);
+    executionInfo.insert("bond-dim-history", m_truncationInfo.bondDimHistory);
+    executionInfo.insert("max-pending-sites", static_cast<int>(m_maxPendingSites));
 
     if (m_buffer->size() < MAX_NUMBER_QUBITS_FOR_STATE_VEC) 
     {
@@ -558,33 +837,10 @@ void ExatnMpsVisitor::finalize()
 
         if (!m_measureQubits.empty())
         {
-            const auto calcExpValueZ = [](const std::vector<size_t>& in_bits, const std::vector<std::complex<double>>& in_stateVec) {
-                const auto hasEvenParity = [](size_t x, const std::vector<size_t>& in_qubitIndices) -> bool {
-                    size_t count = 0;
-                    for (const auto& bitIdx : in_qubitIndices)
-                    {
-                        if (x & (1ULL << bitIdx))
-                        {
-                            count++;
-                        }
-                    }
-                    return (count % 2) == 0;
-                };
-
-
-                double result = 0.0;
-                for(uint64_t i = 0; i < in_stateVec.size(); ++i)
-                {
-                    result += (hasEvenParity(i, in_bits) ? 1.0 : -1.0) * std::norm(in_stateVec[i]);
-                }
-
-                return result;
-            };
-
             // No shots, just add exp-val-z
             if (m_shotCount < 1)
             {
-                const double exp_val_z = calcExpValueZ(m_measureQubits, tensorData);
+                const double exp_val_z = CalcExpValueZ(m_measureQubits, tensorData);
                 m_buffer->addExtraInfo("exp-val-z", exp_val_z);
             }
             else
@@ -620,6 +876,7 @@ void ExatnMpsVisitor::finalize()
         const bool qTensorDestroyed = exatn::destroyTensor("Q" + std::to_string(i));
         assert(qTensorDestroyed);
     }
+    m_tensorPool.clear();
 
     const auto finalizeEnd = std::chrono::system_clock::now();
     getStatInstance("Finalize").addSample(finalizeStart, finalizeEnd);
@@ -627,6 +884,10 @@ void ExatnMpsVisitor::finalize()
     // Debug:
     // printAllStats();
 #else
+    executionInfo.insert("mpi-initial-partition", m_initialPartition);
+    executionInfo.insert("mpi-rebalance-events", m_rebalanceEvents);
+    // All the qubit tensors must be back on their owners.
+    returnAllLentSites();
     for (const auto& [qubitIdx, rank] : m_qubitIdxToRank)
     {
         const std::string qubitTensorName = "Q" + std::to_string(qubitIdx); 
@@ -640,29 +901,27 @@ void ExatnMpsVisitor::finalize()
         assert(broadcastOk);
     }
 
-    // Only run bitstring sampling on root
-    if (m_rank == 0)
-    {
-        // Update the tensor network to take into
-        // account the updated tensors.
-        rebuildTensorNetwork();
+    // All processes now have the whole MPS: update the tensor network to take into account the updated tensors.
+    rebuildTensorNetwork();
+    // Measurement shots are split across all the processes (each one with its own random stream),
+    // the samples are then gathered on rank 0.
+    const size_t nbProcesses = exatn::getDefaultProcessGroup().getSize();
+    const auto getLocalShotRange = [&](size_t in_totalShots) {
+        return std::make_pair(m_rank * in_totalShots / nbProcesses, (m_rank + 1) * in_totalShots / nbProcesses);
+    };
 
-        // const auto stateVecNorm = computeStateVectorNorm(*m_tensorNetwork, exatn::getCurrentProcessGroup());
-        // Small-circuit case: just reconstruct the full wavefunction
-        if (m_buffer->size() < MAX_NUMBER_QUBITS_FOR_STATE_VEC) 
-        {
-            // DEBUG:
-            // printStateVec();
-            exatn::TensorNetwork ket(*m_tensorNetwork);
-            ket.rename("MPSket");
-            const bool evaledOk = exatn::evaluateSync(*m_selfProcessGroup, ket);
-            assert(evaledOk); 
-            const auto tensorData = getTensorData(ket.getTensor(0)->getName());
-            // Simulate measurement by full tensor contraction (to get the state vector)
-            // we can also implement repetitive bit count sampling 
-            // (will require many contractions but don't require large memory allocation) 
-            // DEBUG:
-            // printStateVec();
+    // Small-circuit case: just reconstruct the full wavefunction
+    if (m_buffer->size() < MAX_NUMBER_QUBITS_FOR_STATE_VEC) 
+    {
+        // DEBUG:
+        // printStateVec();
+        exatn::TensorNetwork ket(*m_tensorNetwork);
+        ket.rename("MPSket");
+        const bool evaledOk = exatn::evaluateSync(*m_selfProcessGroup, ket);
+        assert(evaledOk); 
+        const auto tensorData = getTensorData(ket.getTensor(0)->getName());
+        if (m_rank == 0)
+        {
             // Print state vector norm:
             const double norm = [&](){
                 double sum = 0;
@@ -673,52 +932,59 @@ void ExatnMpsVisitor::finalize()
                 return sum;
             }();
             m_buffer->addExtraInfo("norm", norm);
+        }
 
-            if (!m_measureQubits.empty())
+        if (!m_measureQubits.empty())
+        {
+            // No shots, just add exp-val-z
+            if (m_shotCount < 1)
             {
-                const auto calcExpValueZ = [](const std::vector<size_t>& in_bits, const std::vector<std::complex<double>>& in_stateVec) {
-                    const auto hasEvenParity = [](size_t x, const std::vector<size_t>& in_qubitIndices) -> bool {
-                        size_t count = 0;
-                        for (const auto& bitIdx : in_qubitIndices)
-                        {
-                            if (x & (1ULL << bitIdx))
-                            {
-                                count++;
-                            }
-                        }
-                        return (count % 2) == 0;
-                    };
-
-
-                    double result = 0.0;
-                    for(uint64_t i = 0; i < in_stateVec.size(); ++i)
-                    {
-                        result += (hasEvenParity(i, in_bits) ? 1.0 : -1.0) * std::norm(in_stateVec[i]);
-                    }
-
-                    return result;
-                };
-
-                // No shots, just add exp-val-z
-                if (m_shotCount < 1)
+                if (m_rank == 0)
                 {
-                    const double exp_val_z = calcExpValueZ(m_measureQubits, tensorData);
+                    const double exp_val_z = CalcExpValueZ(m_measureQubits, tensorData);
                     m_buffer->addExtraInfo("exp-val-z", exp_val_z);
                 }
-                else
+            }
+            else
+            {
+                // Sample basis states from the cumulative distribution of the state vector
+                // (same distribution as measuring the qubits one by one).
+                std::vector<double> cumulativeProbs(tensorData.size());
+                double sum = 0.0;
+                for (size_t i = 0; i < tensorData.size(); ++i)
+                {
+                    sum += std::norm(tensorData[i]);
+                    cumulativeProbs[i] = sum;
+                }
+                std::uniform_real_distribution<double> probDist(0.0, cumulativeProbs.back());
+                const auto [firstShot, lastShot] = getLocalShotRange(m_shotCount);
+                std::vector<std::vector<uint8_t>> localSamples;
+                localSamples.reserve(lastShot - firstShot);
+                for (size_t shot = firstShot; shot < lastShot; ++shot)
                 {
-                    addMeasureBitStringProbability(m_measureQubits, tensorData, m_shotCount);
+                    const auto iter = std::upper_bound(cumulativeProbs.begin(), cumulativeProbs.end(), probDist(m_randomEngine));
+                    const size_t stateIdx = std::min<size_t>(std::distance(cumulativeProbs.begin(), iter), cumulativeProbs.size() - 1);
+                    std::vector<uint8_t> bitString;
+                    for (const auto& qubitIdx : m_measureQubits)
+                    {
+                        bitString.emplace_back((stateIdx >> qubitIdx) & 1);
+                    }
+                    localSamples.emplace_back(std::move(bitString));
                 }
+                gatherMeasureSamples(localSamples, firstShot, m_shotCount);
             }
         }
-        else
+    }
+    else
+    {
+        // Large circuit
+        // Calculates the amplitude of a specific bitstring
+        // or the partial (slice) wave function.
+        // The open indices are denoted by "-1" value.
+        if (options.keyExists<std::vector<int>>("bitstring"))
         {
-            // Large circuit
-            // std::cout << "Final norm: " << stateVecNorm << "\n";
-            // Calculates the amplitude of a specific bitstring
-            // or the partial (slice) wave function.
-            // The open indices are denoted by "-1" value.
-            if (options.keyExists<std::vector<int>>("bitstring"))
+            // Only run on root
+            if (m_rank == 0)
             {
                 std::vector<int> bitString = options.get<std::vector<int>>("bitstring");
                 if (bitString.size() != m_buffer->size())
@@ -764,25 +1030,23 @@ void ExatnMpsVisitor::finalize()
                     m_buffer->addExtraInfo("amplitude-real-vec", amplReal);
                     m_buffer->addExtraInfo("amplitude-imag-vec", amplImag);  
                 }
-            } 
-            else if (!m_measureQubits.empty())
+            }
+        } 
+        else if (!m_measureQubits.empty())
+        {
+            if (m_rank == 0)
             {
                 std::cout << "Simulating bit string by MPS tensor contraction\n";
-                m_shotCount = (m_shotCount < 1) ? 1 : m_shotCount;
-                for (int i = 0; i < m_shotCount; ++i)
-                {
-                    const auto convertToBitString = [](const std::vector<uint8_t>& in_bitVec){
-                        std::string result;
-                        for (const auto& bit : in_bitVec)
-                        {
-                            result.append(std::to_string(bit));
-                        }
-                        return result;
-                    };
-
-                    m_buffer->appendMeasurement(convertToBitString(getMeasureSample(m_measureQubits)));
-                }
             }
+            m_shotCount = (m_shotCount < 1) ? 1 : m_shotCount;
+            const auto [firstShot, lastShot] = getLocalShotRange(m_shotCount);
+            std::vector<std::vector<uint8_t>> localSamples;
+            localSamples.reserve(lastShot - firstShot);
+            for (size_t shot = firstShot; shot < lastShot; ++shot)
+            {
+                localSamples.emplace_back(getMeasureSample(m_measureQubits));
+            }
+            gatherMeasureSamples(localSamples, firstShot, m_shotCount);
         }
     }
 
@@ -1040,6 +1304,12 @@ const double ExatnMpsVisitor::getExpectationValueZ(std::shared_ptr<CompositeInst
             nextInst->accept(this);
         }
     }
+    if (m_aggregateEnabled)
+    {
+        m_aggregator.flushAll();
+    }
+    syncTwoQubitGates();
+    compressIfNeeded(true);
     
     exatn::TensorNetwork ket(*m_tensorNetwork);
     ket.rename("MPSket");
@@ -1066,106 +1336,421 @@ void ExatnMpsVisitor::onFlush(const AggregatedGroup& in_group)
     {
         return;
     }
-    // DEBUG:
-    // std::cout << "Flushing qubit line ";
-    // for (const auto& id : in_group.qubitIdx)
-    // {
-    //     std::cout << id << ", ";
-    // }
-    // std::cout << "|| Number of gates = " << in_group.instructions.size() << "\n";
 
-    // for (const auto& inst : in_group.instructions)
-    // {
-    //     std::cout << inst->toString() << "\n";
-    // }
-    // std::cout << "=============================================\n";
-
-    // Construct tensor network
-    // exatn::numerics::TensorNetwork aggregatedGateTensor("AggregatedTensorNetwork" + std::to_string(m_aggregatedGroupCounter));
-    auto& aggregatedGateTensor = *m_tensorNetwork;
-    
     m_aggregatedGroupCounter++;
-    GateTensorConstructor tensorConstructor;
-    for (const auto& inst : in_group.instructions)
+    // Split the group into runs of contiguous qubits:
+    // (nearest-neighbor) gates never straddle two runs, hence each run is an independent block.
+    std::vector<size_t> sortedQubits(in_group.qubitIdx.begin(), in_group.qubitIdx.end());
+    std::sort(sortedQubits.begin(), sortedQubits.end());
+    std::vector<std::vector<size_t>> qubitRuns;
+    for (const auto& qubitIdx : sortedQubits)
     {
-        const auto gateTensor = tensorConstructor.getGateTensor(*inst);
-        const std::string& uniqueGateTensorName = gateTensor.uniqueName;
-        if (m_registeredGateTensors.find(uniqueGateTensorName) == m_registeredGateTensors.end())
+        if (qubitRuns.empty() || qubitIdx != qubitRuns.back().back() + 1)
         {
-            m_registeredGateTensors.emplace(uniqueGateTensorName);
-            // Create the tensor
-            const bool created = exatn::createTensor(
-                uniqueGateTensorName, exatn::TensorElementType::COMPLEX64, gateTensor.tensorShape);
-            assert(created);
-            // Init tensor body data
-            exatn::initTensorData(uniqueGateTensorName, gateTensor.tensorData);
-            const bool registered = exatn::registerTensorIsometry(uniqueGateTensorName, gateTensor.tensorIsometry.first, gateTensor.tensorIsometry.second);
+            qubitRuns.emplace_back();
+        }
+        qubitRuns.back().emplace_back(qubitIdx);
+    }
+
+    for (const auto& qubitRun : qubitRuns)
+    {
+        std::vector<xacc::Instruction*> blockGates;
+        for (const auto& inst : in_group.instructions)
+        {
+            if (std::find(qubitRun.begin(), qubitRun.end(), inst->bits()[0]) != qubitRun.end())
+            {
+                for (const auto& bit : inst->bits())
+                {
+                    assert(std::find(qubitRun.begin(), qubitRun.end(), bit) != qubitRun.end());
+                }
+                blockGates.emplace_back(inst);
+            }
         }
 
-        // Because the qubit location and gate pairing are of different integer types,
-        // we need to reconstruct the qubit vector.
-        std::vector<unsigned int> gatePairing;
-        for (const auto& qbitLoc : inst->bits()) 
+        if (!blockGates.empty())
         {
-            gatePairing.emplace_back(qbitLoc);
+            applyBlockGate(qubitRun, blockGates);
         }
-        std::reverse(gatePairing.begin(), gatePairing.end());
-        m_tensorIdCounter++;
-        // Append the tensor for this gate to the network
-        aggregatedGateTensor.appendTensorGate(
-            m_tensorIdCounter,
-            // Get the gate tensor data which must have been initialized.
-            exatn::getTensor(uniqueGateTensorName),
-            // which qubits that the gate is acting on
-            gatePairing
-        );
     }
-
-    // DEBUG:
-    // std::cout << "AGGREGATED TENSOR NETWORK:\n";
-    // aggregatedGateTensor.printIt();
 }
 
-void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
+void ExatnMpsVisitor::applyBlockGate(const std::vector<size_t>& in_sites, const std::vector<xacc::Instruction*>& in_gates)
 {
-    const auto gateStart = std::chrono::system_clock::now();
-    if (in_gateInstruction.bits().size() == 2)
+    const auto blockStart = std::chrono::system_clock::now();
+    const size_t nbSites = in_sites.size();
+
+    // Step 1: multi-site operator (2^w x 2^w), first site is the most significant bit.
+    const uint64_t opDim = 1ULL << nbSites;
+    GateMatrixType blockOp(opDim, std::vector<std::complex<double>>(opDim, 0.0));
+    for (uint64_t i = 0; i < opDim; ++i)
     {
-        return applyTwoQubitGate(in_gateInstruction);
+        blockOp[i][i] = 1.0;
+    }
+    for (const auto& inst : in_gates)
+    {
+        const auto gateTensor = GateTensorConstructor::getGateTensor(*inst);
+        const size_t gateDim = 1ULL << inst->bits().size();
+        assert(gateTensor.tensorData.size() == gateDim * gateDim);
+        GateMatrixType gateMatrix(gateDim);
+        for (size_t row = 0; row < gateDim; ++row)
+        {
+            gateMatrix[row].assign(gateTensor.tensorData.begin() + row * gateDim, gateTensor.tensorData.begin() + (row + 1) * gateDim);
+        }
+        const std::vector<size_t> gateQubits(inst->bits().begin(), inst->bits().end());
+        blockOp = MultiplyGateMatrices(ExpandGateMatrix(gateMatrix, gateQubits, in_sites), blockOp);
     }
 
-#ifndef TNQVM_MPI_ENABLED
-    // Single qubit only in this path
-    assert(in_gateInstruction.bits().size() == 1);
-    const auto gateTensor = GateTensorConstructor::getGateTensor(in_gateInstruction);
-    const std::string& uniqueGateTensorName = in_gateInstruction.name();
-    // Create the tensor
-    const bool created = exatn::createTensorSync(uniqueGateTensorName, exatn::TensorElementType::COMPLEX64, gateTensor.tensorShape);
-    assert(created);
-    // Init tensor body data
-    const bool initialized = exatn::initTensorDataSync(uniqueGateTensorName, gateTensor.tensorData);
-    assert(initialized);
-    // m_tensorNetwork->printIt();
-    // Contract gate tensor to the qubit tensor
-    const auto contractGateTensor = [](int in_qIdx, const std::string& in_gateTensorName){
-        // Pattern: 
-        // (1) Boundary qubits (2 legs): Result(a, b) = Qi(a, i) * G (i, b)
-        // (2) Middle qubits (3 legs): Result(a, b, c) = Qi(a, b, i) * G (i, c)
-        // (3) Single qubit (1 leg):  Result(a) = Q0(i) * G (i, a)
-        const std::string qubitTensorName = "Q" + std::to_string(in_qIdx); 
-        auto qubitTensor =  exatn::getTensor(qubitTensorName);
-        assert(qubitTensor->getRank() == 1 || qubitTensor->getRank() == 2 || qubitTensor->getRank() == 3);
-        auto gateTensor =  exatn::getTensor(in_gateTensorName);
-        assert(gateTensor->getRank() == 2);
+    applyBlockOperator(in_sites, blockOp);
+    const auto blockEnd = std::chrono::system_clock::now();
+    getStatInstance("Block Gate").addSample(blockStart, blockEnd);
+}
 
-        const std::string RESULT_TENSOR_NAME = "Result";
-        // Result tensor always has the same shape as the qubit tensor
-        const bool resultTensorCreated = exatn::createTensorSync(RESULT_TENSOR_NAME, 
-                                                                exatn::TensorElementType::COMPLEX64, 
-                                                                qubitTensor->getShape());
-        assert(resultTensorCreated);
-        const bool resultTensorInitialized = exatn::initTensorSync(RESULT_TENSOR_NAME, 0.0);
-        assert(resultTensorInitialized);
+void ExatnMpsVisitor::applyBlockOperator(const std::vector<size_t>& in_sites, const std::vector<std::vector<std::complex<double>>>& in_op)
+{
+    const size_t nbSites = in_sites.size();
+    const size_t firstSite = in_sites.front();
+    const size_t lastSite = in_sites.back();
+    assert(lastSite - firstSite + 1 == nbSites);
+    const size_t nbQubits = m_buffer->size();
+    const uint64_t opDim = 1ULL << nbSites;
+    assert(in_op.size() == opDim);
+
+    // Step 2: merge the site tensors: Theta(left bond, p_first, ..., p_last, right bond)
+    // The orthogonality center is moved to the first site so that the split below is locally optimal.
+    // Note: a single-site block (unitary) doesn't change the canonical form.
+    if (nbSites > 1)
+    {
+        moveOrthoCenter(firstSite);
+    }
+    exatn::sync();
+    const size_t leftBondDim = (firstSite > 0) ? exatn::getTensor("Q" + std::to_string(firstSite))->getDimExtent(0) : 1;
+    const size_t rightBondDim = (lastSite < nbQubits - 1) ? exatn::getTensor("Q" + std::to_string(lastSite))->getDimExtents().back() : 1;
+    std::vector<std::complex<double>> theta = getTensorData("Q" + std::to_string(firstSite));
+    for (size_t site = firstSite + 1; site <= lastSite; ++site)
+    {
+        // Column-major: Theta (rows x bond) * Q(site) (bond x cols)
+        const auto siteData = getTensorData("Q" + std::to_string(site));
+        const size_t bondDim = exatn::getTensor("Q" + std::to_string(site))->getDimExtent(0);
+        const size_t nbRows = theta.size() / bondDim;
+        const size_t nbCols = siteData.size() / bondDim;
+        std::vector<std::complex<double>> merged(nbRows * nbCols, 0.0);
+        for (size_t col = 0; col < nbCols; ++col)
+        {
+            for (size_t k = 0; k < bondDim; ++k)
+            {
+                const auto siteElem = siteData[k + col * bondDim];
+                for (size_t row = 0; row < nbRows; ++row)
+                {
+                    merged[row + col * nbRows] += theta[row + k * nbRows] * siteElem;
+                }
+            }
+        }
+        theta = std::move(merged);
+    }
+    assert(theta.size() == leftBondDim * opDim * rightBondDim);
+
+    // Step 3: apply the operator to the physical legs.
+    // In Theta, the first site is the fastest physical leg, i.e. the least significant bit: reverse the bits.
+    std::vector<uint64_t> opIdx(opDim, 0);
+    for (uint64_t physIdx = 0; physIdx < opDim; ++physIdx)
+    {
+        for (size_t k = 0; k < nbSites; ++k)
+        {
+            opIdx[physIdx] |= ((physIdx >> k) & 1ULL) << (nbSites - 1 - k);
+        }
+    }
+    std::vector<std::complex<double>> newTheta(theta.size(), 0.0);
+    for (size_t rightIdx = 0; rightIdx < rightBondDim; ++rightIdx)
+    {
+        for (size_t leftIdx = 0; leftIdx < leftBondDim; ++leftIdx)
+        {
+            const auto offset = [&](uint64_t in_physIdx) {
+                return leftIdx + leftBondDim * (in_physIdx + opDim * rightIdx);
+            };
+            for (uint64_t row = 0; row < opDim; ++row)
+            {
+                std::complex<double> sum = 0.0;
+                for (uint64_t col = 0; col < opDim; ++col)
+                {
+                    sum += in_op[opIdx[row]][opIdx[col]] * theta[offset(col)];
+                }
+                newTheta[offset(row)] = sum;
+            }
+        }
+    }
+
+    // Step 4: split Theta back into site tensors (left-to-right sweep).
+    const auto siteShape = [&](size_t in_site, size_t in_leftDim, size_t in_rightDim) {
+        std::vector<exatn::DimExtent> shape;
+        if (in_site > 0)
+        {
+            shape.emplace_back(in_leftDim);
+        }
+        shape.emplace_back(2);
+        if (in_site < nbQubits - 1)
+        {
+            shape.emplace_back(in_rightDim);
+        }
+        return shape;
+    };
+
+    size_t currentLeftDim = leftBondDim;
+    for (size_t site = firstSite; site < lastSite; ++site)
+    {
+        const size_t nbRows = currentLeftDim * 2;
+        const size_t nbCols = newTheta.size() / nbRows;
+        std::vector<std::complex<double>> siteData;
+        std::vector<std::complex<double>> remainder;
+        const size_t bondDim = decomposeSiteMatrix(newTheta, nbRows, nbCols, siteData, remainder, site);
+        resetTensor("Q" + std::to_string(site), m_elementType, siteShape(site, currentLeftDim, bondDim), siteData);
+        newTheta = std::move(remainder);
+        currentLeftDim = bondDim;
+    }
+    resetTensor("Q" + std::to_string(lastSite), m_elementType, siteShape(lastSite, currentLeftDim, rightBondDim), newTheta);
+    if (nbSites > 1)
+    {
+        m_orthoCenter = lastSite;
+    }
+
+    rebuildTensorNetwork();
+    compressIfNeeded(false);
+}
+
+void ExatnMpsVisitor::applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix)
+{
+#ifdef TNQVM_MPI_ENABLED
+    xacc::error("Generic k-qubit gates are not supported in MPI mode.");
+#else
+    if (in_qubits.empty() || (1ULL << in_qubits.size()) != in_matrix.size())
+    {
+        xacc::error("Gate matrix dimension doesn't match the number of qubits.");
+    }
+    for (const auto& row : in_matrix)
+    {
+        if (row.size() != in_matrix.size())
+        {
+            xacc::error("Invalid gate matrix: the matrix must be square.");
+        }
+    }
+    validateGateQubits(in_qubits, m_buffer->size());
+    const auto gateStart = std::chrono::system_clock::now();
+    // Gates are applied in order: flush all pending (aggregated/asynchronous) gates first.
+    if (m_aggregateEnabled)
+    {
+        m_aggregator.flushAll();
+    }
+    syncTwoQubitGates();
+
+    // The operator acts on all the sites between the min and max qubits (identity on the sites in between).
+    const size_t firstSite = *std::min_element(in_qubits.begin(), in_qubits.end());
+    const size_t lastSite = *std::max_element(in_qubits.begin(), in_qubits.end());
+    if (lastSite >= m_buffer->size())
+    {
+        xacc::error("Invalid qubit index " + std::to_string(lastSite) + ".");
+    }
+    std::vector<size_t> sites;
+    for (size_t site = firstSite; site <= lastSite; ++site)
+    {
+        sites.emplace_back(site);
+    }
+    if (std::set<size_t>(in_qubits.begin(), in_qubits.end()).size() != in_qubits.size())
+    {
+        xacc::error("Invalid gate: duplicate qubit indices.");
+    }
+    // Note: the merged tensor grows as 2^(number of sites), i.e. long-range generic gates are expensive.
+    applyBlockOperator(sites, ExpandGateMatrix(in_matrix, in_qubits, sites));
+    const auto gateEnd = std::chrono::system_clock::now();
+    getStatInstance("Generic Gate").addSample(gateStart, gateEnd);
+#endif
+}
+
+size_t ExatnMpsVisitor::decomposeSiteMatrix(const std::vector<std::complex<double>>& in_matrix, size_t in_rows, size_t in_cols,
+                                            std::vector<std::complex<double>>& out_left, std::vector<std::complex<double>>& out_right, size_t in_bondIdx)
+{
+    const auto start = std::chrono::system_clock::now();
+    const size_t fullBondDim = std::min(in_rows, in_cols);
+    // SVD (ExaTN) with the singular values absorbed to the right:
+    // the rows of the right factor (S * V^H) have norms equal to the singular values.
+    const std::string matrixTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{in_rows, in_cols});
+    const std::string leftTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{in_rows, fullBondDim});
+    const std::string rightTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{fullBondDim, in_cols});
+    const bool initialized = exatn::initTensorDataSync(matrixTensorName, in_matrix);
+    assert(initialized);
+    const bool svdOk = exatn::decomposeTensorSVDRSync(matrixTensorName + "(a,b)=" + leftTensorName + "(a,c)*" + rightTensorName + "(c,b)");
+    assert(svdOk);
+    const auto leftData = getTensorData(leftTensorName);
+    const auto rightData = getTensorData(rightTensorName);
+    m_tensorPool.releaseScratchTensor(matrixTensorName);
+    m_tensorPool.releaseScratchTensor(leftTensorName);
+    m_tensorPool.releaseScratchTensor(rightTensorName);
+    if (!needsTruncation(fullBondDim, in_rows, in_cols, in_bondIdx))
+    {
+        // No truncation: isometric split (left: U, right: S * V^H)
+        out_left = leftData;
+        out_right = rightData;
+        m_truncationInfo.bondDimHistory[in_bondIdx].emplace_back(fullBondDim);
+        const auto end = std::chrono::system_clock::now();
+        getStatInstance("Isometric Split").addSample(start, end);
+        return fullBondDim;
+    }
+
+    std::vector<double> singularValues(fullBondDim, 0.0);
+    for (size_t col = 0; col < in_cols; ++col)
+    {
+        for (size_t row = 0; row < fullBondDim; ++row)
+        {
+            singularValues[row] += std::norm(rightData[row + col * fullBondDim]);
+        }
+    }
+    for (auto& val : singularValues)
+    {
+        val = std::sqrt(val);
+    }
+
+    const size_t bondDim = selectBondDim(singularValues, in_rows, in_cols, in_bondIdx);
+    if (bondDim < fullBondDim)
+    {
+        std::stringstream logSs;
+        logSs << "[SVD] Bond " << in_bondIdx << " dim: " << fullBondDim << " -> " << bondDim;
+        xacc::info(logSs.str());
+    }
+
+    // Column-major: keep the first bondDim columns (left) and rows (right).
+    out_left.assign(leftData.begin(), leftData.begin() + in_rows * bondDim);
+    out_right.resize(bondDim * in_cols);
+    for (size_t col = 0; col < in_cols; ++col)
+    {
+        for (size_t row = 0; row < bondDim; ++row)
+        {
+            out_right[row + col * bondDim] = rightData[row + col * fullBondDim];
+        }
+    }
+    const auto end = std::chrono::system_clock::now();
+    getStatInstance("SVD Split and Truncate").addSample(start, end);
+    return bondDim;
+}
+
+size_t ExatnMpsVisitor::getMemoryBoundBondDim(size_t in_rows, size_t in_cols, size_t in_bondIdx) const
+{
+    if (m_maxMemoryMb <= 0.0)
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    // Memory of the other site tensors (sites in_bondIdx and in_bondIdx + 1 are being replaced).
+    size_t otherElements = 0;
+    for (size_t i = 0; i < m_buffer->size(); ++i)
+    {
+        if (i != in_bondIdx && i != in_bondIdx + 1)
+        {
+            otherElements += exatn::getTensor("Q" + std::to_string(i))->getVolume();
+        }
+    }
+    const double maxElements = m_maxMemoryMb * 1024.0 * 1024.0 / sizeof(std::complex<double>);
+    const double availableElements = maxElements - static_cast<double>(otherElements);
+    // New site tensors: (in_rows x chi) and (chi x in_cols)
+    const double bondDim = std::floor(availableElements / static_cast<double>(in_rows + in_cols));
+    return bondDim < 1.0 ? 1 : static_cast<size_t>(bondDim);
+}
+
+bool ExatnMpsVisitor::needsTruncation(size_t in_fullBondDim, size_t in_rows, size_t in_cols, size_t in_bondIdx) const
+{
+    // Note: the default cut-off (numeric_limits::min) never truncates in practice.
+    return (m_svdCutoff > std::numeric_limits<double>::min()) ||
+           (m_fidelityTarget < 1.0) ||
+           (in_fullBondDim > static_cast<size_t>(getBondDimLimit())) ||
+           (in_fullBondDim > getMemoryBoundBondDim(in_rows, in_cols, in_bondIdx));
+}
+
+size_t ExatnMpsVisitor::selectBondDim(const std::vector<double>& in_singularValues, size_t in_rows, size_t in_cols, size_t in_bondIdx)
+{
+    const size_t fullBondDim = in_singularValues.size();
+    assert(fullBondDim > 0);
+    // Discarded weight (squared singular values) when keeping the first k values.
+    std::vector<double> tailWeight(fullBondDim + 1, 0.0);
+    for (size_t i = fullBondDim; i > 0; --i)
+    {
+        tailWeight[i - 1] = tailWeight[i] + in_singularValues[i - 1] * in_singularValues[i - 1];
+    }
+    const double totalWeight = tailWeight[0];
+
+    // (1) Cut-off: the singular values are in descending order.
+    size_t bondDim = fullBondDim;
+    for (size_t i = 0; i < fullBondDim; ++i)
+    {
+        if (in_singularValues[i] < m_svdCutoff)
+        {
+            bondDim = std::max<size_t>(i, 1);
+            break;
+        }
+    }
+
+    // (2) Fidelity budget: the remaining budget (-log(F)) is spread across all the bonds,
+    // i.e. this truncation can use up to 1/(N - 1) of it.
+    if (m_fidelityTarget < 1.0 && totalWeight > 0.0)
+    {
+        const double totalBudget = -std::log(m_fidelityTarget);
+        const double remainingBudget = std::max(totalBudget + std::log(m_truncationInfo.estimatedFidelity), 0.0);
+        const size_t nbBonds = std::max<size_t>(m_buffer->size() - 1, 1);
+        const double maxDiscardedWeight = 1.0 - std::exp(-remainingBudget / nbBonds);
+        size_t fidelityBondDim = fullBondDim;
+        while (fidelityBondDim > 1 && tailWeight[fidelityBondDim - 1] / totalWeight <= maxDiscardedWeight)
+        {
+            --fidelityBondDim;
+        }
+        bondDim = std::min(bondDim, fidelityBondDim);
+    }
+
+    // (3) Hard limits: max bond dimension and memory cap.
+    bondDim = std::min(bondDim, static_cast<size_t>(getBondDimLimit()));
+    bondDim = std::min(bondDim, getMemoryBoundBondDim(in_rows, in_cols, in_bondIdx));
+    bondDim = std::max<size_t>(bondDim, 1);
+
+    // Canonical form: the discarded weight is the (local) infidelity of this truncation.
+    const double discardedWeight = totalWeight > 0.0 ? tailWeight[bondDim] / totalWeight : 0.0;
+    m_truncationInfo.discardedWeight += discardedWeight;
+    m_truncationInfo.estimatedFidelity *= (1.0 - discardedWeight);
+    m_truncationInfo.bondDimHistory[in_bondIdx].emplace_back(bondDim);
+    return bondDim;
+}
+
+void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
+{
+    const auto gateStart = std::chrono::system_clock::now();
+    if (in_gateInstruction.bits().size() == 2)
+    {
+        return applyTwoQubitGate(in_gateInstruction);
+    }
+
+#ifndef TNQVM_MPI_ENABLED
+    // Single qubit only in this path
+    assert(in_gateInstruction.bits().size() == 1);
+    // The qubit tensor is being updated by a two-qubit gate in flight.
+    if (m_pendingSites.find(in_gateInstruction.bits()[0]) != m_pendingSites.end())
+    {
+        syncTwoQubitGates();
+    }
+    const auto gateTensor = GateTensorConstructor::getGateTensor(in_gateInstruction);
+    // Gate tensor (created once, cached by the pool)
+    const std::string uniqueGateTensorName = m_tensorPool.getGateTensor(gateTensor.uniqueName, exatn::TensorShape(gateTensor.tensorShape), gateTensor.tensorData, m_elementType);
+    // m_tensorNetwork->printIt();
+    // Contract gate tensor to the qubit tensor
+    const auto contractGateTensor = [this](int in_qIdx, const std::string& in_gateTensorName){
+        // Pattern: 
+        // (1) Boundary qubits (2 legs): Result(a, b) = Qi(a, i) * G (i, b)
+        // (2) Middle qubits (3 legs): Result(a, b, c) = Qi(a, b, i) * G (i, c)
+        // (3) Single qubit (1 leg):  Result(a) = Q0(i) * G (i, a)
+        const std::string qubitTensorName = "Q" + std::to_string(in_qIdx); 
+        auto qubitTensor =  exatn::getTensor(qubitTensorName);
+        assert(qubitTensor->getRank() == 1 || qubitTensor->getRank() == 2 || qubitTensor->getRank() == 3);
+        auto gateTensor =  exatn::getTensor(in_gateTensorName);
+        assert(gateTensor->getRank() == 2);
+
+        // Result tensor always has the same shape as the qubit tensor
+        const std::string RESULT_TENSOR_NAME = m_tensorPool.acquireScratchTensor(qubitTensor->getShape(), m_elementType);
+        // Note: the contraction accumulates into the result tensor.
+        const bool resultTensorInitialized = exatn::initTensor(RESULT_TENSOR_NAME, 0.0);
+        assert(resultTensorInitialized);
         
         std::string patternStr;
         if (qubitTensor->getRank() == 1)
@@ -1194,29 +1779,18 @@ void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
         // std::cout << "Pattern string: " << patternStr << "\n";
         
         auto start = std::chrono::system_clock::now();
-        const bool contractOk = exatn::contractTensorsSync(patternStr, 1.0);
+        const bool contractOk = exatn::contractTensors(patternStr, 1.0);
         assert(contractOk);
+        // Copy the result back into the qubit tensor (on the device, ordered after the contraction by the runtime).
+        const std::string legs = patternStr.substr(RESULT_TENSOR_NAME.size(), patternStr.find('=') - RESULT_TENSOR_NAME.size());
+        const bool qubitTensorReset = exatn::initTensor(qubitTensorName, 0.0);
+        assert(qubitTensorReset);
+        const bool copyOk = exatn::addTensors(qubitTensorName + legs + "+=" + RESULT_TENSOR_NAME + legs, 1.0);
+        assert(copyOk);
         auto end = std::chrono::system_clock::now();
-        getStatInstance("Contract Single-Qubit Gate Tensor").addSample(start, end);
-        
-        std::vector<std::complex<double>> resultTensorData =  getTensorData(RESULT_TENSOR_NAME);
-        std::function<int(talsh::Tensor& in_tensor)> updateFunc = [&resultTensorData](talsh::Tensor& in_tensor){
-            std::complex<double> *elements;
-            
-            if (in_tensor.getDataAccessHost(&elements) && (in_tensor.getVolume() == resultTensorData.size())) 
-            {
-                for (int i = 0; i < in_tensor.getVolume(); ++i)
-                {
-                    elements[i] = resultTensorData[i];
-                }            
-            }
-
-            return 0;
-        };
-
-        exatn::numericalServer->transformTensorSync(qubitTensorName, std::make_shared<ExatnMpsVisitor::ExaTnTensorFunctor>(updateFunc));
-        const bool resultTensorDestroyed = exatn::destroyTensor(RESULT_TENSOR_NAME);
-        assert(resultTensorDestroyed);
+        getStatInstance("Submit Single-Qubit Gate Tensor").addSample(start, end);
+        // The scratch tensor is released once the site is synchronized.
+        m_pendingSingleQubitGates[in_qIdx].emplace_back(RESULT_TENSOR_NAME);
     };
 
 
@@ -1228,29 +1802,36 @@ void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
     // DEBUG:
     // printStateVec();
 
-    const bool destroyed = exatn::destroyTensor(uniqueGateTensorName);
-    assert(destroyed);
-    exatn::sync();
+    if (m_asyncTwoQubitGates)
+    {
+        m_maxPendingSites = std::max(m_maxPendingSites, m_pendingSites.size() + m_pendingSingleQubitGates.size());
+    }
+    else
+    {
+        syncSingleQubitGates(in_gateInstruction.bits()[0]);
+    }
 
     const auto gateEnd = std::chrono::system_clock::now();
     getStatInstance("One-qubit Gate Total").addSample(gateStart, gateEnd);
 #else
     // MPI path:
     const size_t bitIdx = in_gateInstruction.bits()[0];
-    if (indexInRange(bitIdx, m_qubitRange))
+    // Single-qubit gates are applied by the process currently holding the qubit tensor,
+    // i.e. a borrowed boundary tensor doesn't need to be sent back.
+    if (isHoldingSite(bitIdx))
     {
         xacc::info("Process [" + std::to_string(m_rank) + "]: Process gate: " + in_gateInstruction.toString());
         const auto gateTensor = GateTensorConstructor::getGateTensor(in_gateInstruction);
         const std::string& uniqueGateTensorName = in_gateInstruction.name();
         // Create the tensor
-        const bool created = exatn::createTensorSync(*m_selfProcessGroup, uniqueGateTensorName, exatn::TensorElementType::COMPLEX64, gateTensor.tensorShape);
+        const bool created = exatn::createTensorSync(*m_selfProcessGroup, uniqueGateTensorName, m_elementType, gateTensor.tensorShape);
         assert(created);
         // Init tensor body data
-        const bool initialized = exatn::initTensorDataSync(uniqueGateTensorName, gateTensor.tensorData);
+        const bool initialized = initTensorBody(uniqueGateTensorName, m_elementType, gateTensor.tensorData);
         assert(initialized);
         // m_tensorNetwork->printIt();
         // Contract gate tensor to the qubit tensor
-        const auto contractGateTensor = [](int in_qIdx, const std::string& in_gateTensorName, exatn::ProcessGroup& in_processGroup){
+        const auto contractGateTensor = [this](int in_qIdx, const std::string& in_gateTensorName, exatn::ProcessGroup& in_processGroup){
             // Pattern: 
             // (1) Boundary qubits (2 legs): Result(a, b) = Qi(a, i) * G (i, b)
             // (2) Middle qubits (3 legs): Result(a, b, c) = Qi(a, b, i) * G (i, c)
@@ -1264,7 +1845,7 @@ void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
             const std::string RESULT_TENSOR_NAME = "Result";
             // Result tensor always has the same shape as the qubit tensor
             const bool resultTensorCreated = exatn::createTensorSync(in_processGroup, RESULT_TENSOR_NAME, 
-                                                                    exatn::TensorElementType::COMPLEX64, 
+                                                                    m_elementType, 
                                                                     qubitTensor->getShape());
             assert(resultTensorCreated);
             const bool resultTensorInitialized = exatn::initTensorSync(RESULT_TENSOR_NAME, 0.0);
@@ -1299,16 +1880,7 @@ void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
             assert(contractOk);
             std::vector<std::complex<double>> resultTensorData =  getTensorData(RESULT_TENSOR_NAME);
             std::function<int(talsh::Tensor& in_tensor)> updateFunc = [&resultTensorData](talsh::Tensor& in_tensor){
-                std::complex<double> *elements;
-                
-                if (in_tensor.getDataAccessHost(&elements) && (in_tensor.getVolume() == resultTensorData.size())) 
-                {
-                    for (int i = 0; i < in_tensor.getVolume(); ++i)
-                    {
-                        elements[i] = resultTensorData[i];
-                    }            
-                }
-
+                writeTensorBody(in_tensor, resultTensorData);
                 return 0;
             };
 
@@ -1331,346 +1903,42 @@ void ExatnMpsVisitor::applyGate(xacc::Instruction& in_gateInstruction)
 void ExatnMpsVisitor::applyTwoQubitGate(xacc::Instruction& in_gateInstruction)
 {
 #ifndef TNQVM_MPI_ENABLED
-    exatn::sync();
-
-    const auto gateStart = std::chrono::system_clock::now();
-        
-    const int q1 = in_gateInstruction.bits()[0];
-    const int q2 = in_gateInstruction.bits()[1];
-    // Neighbors only
-    assert(std::abs(q1 - q2) == 1);
-    const std::string q1TensorName = "Q" + std::to_string(q1);
-    const std::string q2TensorName = "Q" + std::to_string(q2);
-
-    // Step 1: merge two tensor together
-    auto q1Tensor = exatn::getTensor(q1TensorName);
-    auto q2Tensor = exatn::getTensor(q2TensorName);
-    // std::cout << "Before merge:\n";
-    // m_tensorNetwork->printIt();
-    const auto getQubitTensorId = [&](const std::string& in_tensorName) {
-        const auto idsVec = m_tensorNetwork->getTensorIdsInNetwork(in_tensorName);
-        assert(idsVec.size() == 1);
-        return idsVec.front();
-    };
-    
-    // Merge Q2 into Q1 
-    const auto mergedTensorId = m_tensorNetwork->getMaxTensorId() + 1;
-    std::string mergeContractionPattern;
-    if (q1 < q2)
-    {
-        m_tensorNetwork->mergeTensors(getQubitTensorId(q1TensorName), getQubitTensorId(q2TensorName), mergedTensorId, &mergeContractionPattern);
-        mergeContractionPattern.replace(mergeContractionPattern.find("L"), 1, q1TensorName);
-        mergeContractionPattern.replace(mergeContractionPattern.find("R"), 1, q2TensorName);
-    }
-    else
+    const size_t q1 = in_gateInstruction.bits()[0];
+    const size_t q2 = in_gateInstruction.bits()[1];
+    // Site conflict with a gate in flight: wait for the current layer to complete.
+    if (m_pendingSites.find(q1) != m_pendingSites.end() || m_pendingSites.find(q2) != m_pendingSites.end())
     {
-        m_tensorNetwork->mergeTensors(getQubitTensorId(q2TensorName), getQubitTensorId(q1TensorName), mergedTensorId, &mergeContractionPattern);
-        mergeContractionPattern.replace(mergeContractionPattern.find("L"), 1, q2TensorName);
-        mergeContractionPattern.replace(mergeContractionPattern.find("R"), 1, q1TensorName);
+        syncTwoQubitGates();
     }
 
-    // std::cout << "After merge:\n";
-    // m_tensorNetwork->printIt();
-
-    auto mergedTensor =  m_tensorNetwork->getTensor(mergedTensorId);
-    mergedTensor->rename("D");
-    
-    // std::cout << "Contraction Pattern: " << mergeContractionPattern << "\n";
-    const bool mergedTensorCreated = exatn::createTensorSync(mergedTensor, exatn::TensorElementType::COMPLEX64);
-    assert(mergedTensorCreated);
-    const bool mergedTensorInitialized = exatn::initTensorSync(mergedTensor->getName(), 0.0);
-    assert(mergedTensorInitialized);
-    const bool mergedContractionOk = exatn::contractTensorsSync(mergeContractionPattern, 1.0);
-    assert(mergedContractionOk);
-    
-    // Step 2: contract the merged tensor with the gate
-    const auto gateTensor = GateTensorConstructor::getGateTensor(in_gateInstruction);
-    const std::string uniqueGateTensorName = in_gateInstruction.name();
-
-    // Create the tensor
-    const bool created = exatn::createTensorSync(uniqueGateTensorName, exatn::TensorElementType::COMPLEX64, gateTensor.tensorShape);
-    assert(created);
-    // Init tensor body data
-    const bool initialized = exatn::initTensorDataSync(uniqueGateTensorName, gateTensor.tensorData);
-    assert(initialized);
-    
-    assert(mergedTensor->getRank() >=2 && mergedTensor->getRank() <= 4);
-    const std::string RESULT_TENSOR_NAME = "Result";
-    // Result tensor always has the same shape as the *merged* qubit tensor
-    const bool resultTensorCreated = exatn::createTensorSync(RESULT_TENSOR_NAME, 
-                                                            exatn::TensorElementType::COMPLEX64, 
-                                                            mergedTensor->getShape());
-    assert(resultTensorCreated);
-    const bool resultTensorInitialized = exatn::initTensorSync(RESULT_TENSOR_NAME, 0.0);
-    assert(resultTensorInitialized);
-    
-    std::string patternStr;
-    if (mergedTensor->getRank() == 3)
-    {
-        // Pattern: Result(a,b,c) = D(i,j,c)*Gate(i,j,a,b)
-        if (q1 < q2)
-        {
-            if (q1 == 0)
-            {
-                patternStr = RESULT_TENSOR_NAME + "(a,b,c)=" + mergedTensor->getName() + "(i,j,c)*" + uniqueGateTensorName + "(j,i,b,a)";
-            }
-            else
-            {
-                patternStr = RESULT_TENSOR_NAME + "(a,b,c)=" + mergedTensor->getName() + "(a,i,j)*" + uniqueGateTensorName + "(j,i,c,b)";
-            }
-        }
-        else
-        {
-            if (q2 == 0)
-            {
-                patternStr = RESULT_TENSOR_NAME + "(a,b,c)=" + mergedTensor->getName() + "(i,j,c)*" + uniqueGateTensorName + "(i,j,a,b)";
-            }
-            else
-            {
-                patternStr = RESULT_TENSOR_NAME + "(a,b,c)=" + mergedTensor->getName() + "(a,i,j)*" + uniqueGateTensorName + "(i,j,b,c)";
-            }
-        }
-    }
-    else if (mergedTensor->getRank() == 4)
+    if (m_canonicalForm)
     {
-        if (q1 < q2)
+        // Canonical updates (orthogonality center shifts, compression) may touch any site.
+        while (!m_pendingSingleQubitGates.empty())
         {
-            patternStr = RESULT_TENSOR_NAME + "(a,b,c,d)=" + mergedTensor->getName() + "(a,i,j,d)*" + uniqueGateTensorName + "(j,i,c,b)";
+            syncSingleQubitGates(m_pendingSingleQubitGates.begin()->first);
         }
-        else
-        {
-            patternStr = RESULT_TENSOR_NAME + "(a,b,c,d)=" + mergedTensor->getName() + "(a,i,j,d)*" + uniqueGateTensorName + "(i,j,b,c)";
-        }
-    }
-    else if (mergedTensor->getRank() == 2)
-    {
-        // Only two-qubit in the qubit register
-        assert(m_buffer->size() == 2);
-        if (q1 < q2)
+        if (std::max(q1, q2) - std::min(q1, q2) > 1)
         {
-            patternStr = RESULT_TENSOR_NAME + "(a,b)=" + mergedTensor->getName() + "(i,j)*" + uniqueGateTensorName + "(j,i,b,a)";
+            assert(m_longRangeGates);
+            applyLongRangeGate(in_gateInstruction);
         }
         else
         {
-            patternStr = RESULT_TENSOR_NAME + "(a,b)=" + mergedTensor->getName() + "(i,j)*" + uniqueGateTensorName + "(i,j,a,b)";
+            applyTwoQubitGateCanonical(in_gateInstruction);
         }
+        compressIfNeeded(false);
+        return;
     }
-    
-    assert(!patternStr.empty());
-    // std::cout << "Gate contraction pattern: " << patternStr << "\n";
 
+    // Only the two sites of this gate need to be up-to-date.
+    syncSingleQubitGates(q1);
+    syncSingleQubitGates(q2);
+    submitTwoQubitGate(in_gateInstruction);
+    if (!m_asyncTwoQubitGates)
     {
-        auto start = std::chrono::system_clock::now();
-        const bool gateContractionOk = exatn::contractTensorsSync(patternStr, 1.0);
-        assert(gateContractionOk);
-        auto end = std::chrono::system_clock::now();
-        getStatInstance("Contract Two-Qubit Gate Tensor").addSample(start, end);
-    }
-    
-    const std::vector<std::complex<double>> resultTensorData =  getTensorData(RESULT_TENSOR_NAME);
-    std::function<int(talsh::Tensor& in_tensor)> updateFunc = [&resultTensorData](talsh::Tensor& in_tensor){
-        std::complex<double>* elements;
-        
-        if (in_tensor.getDataAccessHost(&elements) && (in_tensor.getVolume() == resultTensorData.size())) 
-        {
-            for (int i = 0; i < in_tensor.getVolume(); ++i)
-            {
-                elements[i] = resultTensorData[i];
-            }            
-        }
-
-        return 0;
-    };
-
-    exatn::numericalServer->transformTensorSync(mergedTensor->getName(), std::make_shared<ExatnMpsVisitor::ExaTnTensorFunctor>(updateFunc));
-    
-    // Destroy the temp. result tensor 
-    const bool resultTensorDestroyed = exatn::destroyTensor(RESULT_TENSOR_NAME);
-    assert(resultTensorDestroyed);
-
-    // Destroy gate tensor
-    const bool destroyed = exatn::destroyTensor(uniqueGateTensorName);
-    assert(destroyed);
-
-
-    const auto beforeSvd = std::chrono::system_clock::now();
-    getStatInstance("Two-qubit Gate: Before SVD").addSample(gateStart, beforeSvd);
-    
-    // Step 3: SVD the merged tensor back into two MPS qubit tensor
-    // Delete the two original qubit tensors
-    const auto getBondLegId = [&](int in_qubitIdx, int in_otherQubitIdx){
-        if (in_qubitIdx == 0)
-        {
-            return 1;
-        }
-        if(in_qubitIdx == (m_buffer->size() - 1))
-        {
-            return 0;
-        }
-
-        return (in_qubitIdx < in_otherQubitIdx) ? 2 : 0;
-    };
-
-    auto q1Shape = q1Tensor->getDimExtents();
-    auto q2Shape = q2Tensor->getDimExtents();
-    
-    const auto q1BondLegId = getBondLegId(q1, q2);
-    const auto q2BondLegId = getBondLegId(q2, q1);
-    assert(q1Shape[q1BondLegId] == q2Shape[q2BondLegId]);
-    int volQ1 = 1;
-    int volQ2 = 1;
-    for (int i = 0; i < q1Shape.size(); ++i)
-    {
-        if (i != q1BondLegId)
-        {
-            volQ1 *= q1Shape[i];
-        }
-    }
-
-    for (int i = 0; i < q2Shape.size(); ++i)
-    {
-        if (i != q2BondLegId)
-        {
-            volQ2 *= q2Shape[i];
-        }
-    }
-
-    const int newBondDim = std::min(volQ1, volQ2);
-    // Update bond dimension
-    q1Shape[q1BondLegId] = newBondDim;
-    q2Shape[q2BondLegId] = newBondDim;
-
-    // Destroy old qubit tensors
-    const bool q1Destroyed = exatn::destroyTensor(q1TensorName);
-    assert(q1Destroyed);
-    const bool q2Destroyed = exatn::destroyTensor(q2TensorName);
-    assert(q2Destroyed);
-    exatn::sync();
-    exatn::sync(mergedTensor->getName());
-
-    // Create two new tensors:
-    const bool q1Created = exatn::createTensorSync(q1TensorName, exatn::TensorElementType::COMPLEX64, q1Shape);
-    assert(q1Created);
-    
-    const bool q2Created = exatn::createTensorSync(q2TensorName, exatn::TensorElementType::COMPLEX64, q2Shape);
-    assert(q2Created);
-    exatn::sync(q1TensorName);
-    exatn::sync(q2TensorName);
-    exatn::sync(mergedTensor->getName());
-    
-    exatn::sync();
-
-    {
-        auto start = std::chrono::system_clock::now();
-        // SVD decomposition using the same pattern that was used to merge two tensors
-        const bool svdOk = exatn::decomposeTensorSVDLRSync(mergeContractionPattern);
-        assert(svdOk);
-        auto end = std::chrono::system_clock::now();
-        getStatInstance("Decompose Tensor SVD").addSample(start, end);
-    }
-
-    exatn::sync(q1TensorName);
-    exatn::sync(q2TensorName);
-
-    // Validate SVD tensors
-    // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
-    {
-        // Validate SVD tensors
-        // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
-        const auto calcMpsTensorNorm = [](const std::string& in_tensorName) {
-            double sumNorm = 0.0;
-            const bool normOk = exatn::computeNorm2Sync(in_tensorName, sumNorm);
-            return sumNorm;
-        };
-
-        const double q1NormAfter = calcMpsTensorNorm(q1TensorName);
-        const double q2NormAfter = calcMpsTensorNorm(q2TensorName);
-        if (std::fabs(q1NormAfter) < 1e-3 || std::fabs(q2NormAfter) < 1e-3)
-        {
-            std::cout << "[ERROR] Tensor norm validation failed!\n";
-            std::cout << in_gateInstruction.toString() << "\n";
-            std::cout << q1TensorName << " norm = " << q1NormAfter << "\n";
-            std::cout << q2TensorName << " norm = " << q2NormAfter << "\n";
-            std::cout << "Tensor SVD Pattern: " <<  mergeContractionPattern << "\n";
-            std::cout << "Merged Tensor: \n";
-            printTensorData(mergedTensor->getName());
-            std::cout << q1TensorName << "\n";
-            printTensorData(q1TensorName);
-            std::cout << q2TensorName << "\n";
-            printTensorData(q2TensorName);
-            // Crash in DEBUG to aid debugging.
-            assert(false);
-        }
-    }
-    
-    const auto buildTensorMap = [&](){
-        std::map<std::string, std::shared_ptr<exatn::Tensor>> tensorMap;
-        tensorMap.emplace(ROOT_TENSOR_NAME, m_rootTensor);
-        for (int i = 0; i < m_buffer->size(); ++i)
-        {
-            const std::string qTensorName = "Q" + std::to_string(i);
-            tensorMap.emplace(qTensorName, exatn::getTensor(qTensorName));
-        }
-        return tensorMap;
-    };
-    
-    const std::string rootVarNameList = [&](){
-        std::string result = "(";
-        for (int i = 0; i < m_buffer->size() - 1; ++i)
-        {
-            result += ("i" + std::to_string(i) + ",");
-        }
-        result += ("i" + std::to_string(m_buffer->size() - 1) + ")");
-        return result;
-    }();
-    
-    const auto qubitTensorVarNameList = [&](int in_qIdx) -> std::string {
-        if (in_qIdx == 0)
-        {
-            return "(i0,j0)";
-        } 
-        if (in_qIdx == m_buffer->size() - 1)
-        {
-            return "(j" + std::to_string(m_buffer->size() - 2) + ",i" + std::to_string(m_buffer->size() - 1) + ")";
-        }
-
-        return "(j" + std::to_string(in_qIdx-1) + ",i" + std::to_string(in_qIdx) + ",j" + std::to_string(in_qIdx)+ ")";
-    };
-    
-    const std::string mpsString = [&](){
-        std::string result = ROOT_TENSOR_NAME + rootVarNameList + "=";
-        for (int i = 0; i < m_buffer->size() - 1; ++i)
-        {
-            result += ("Q" + std::to_string(i) + qubitTensorVarNameList(i) + "*");
-        }
-        result += ("Q" + std::to_string(m_buffer->size() - 1) + qubitTensorVarNameList(m_buffer->size() - 1));
-        return result;
-    }();
-
-    // std::cout << "MPS: " << mpsString << "\n";
-    m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap()); 
-    
-    const auto afterSvd = std::chrono::system_clock::now();
-    getStatInstance("Two-qubit Gate: After SVD").addSample(gateStart, afterSvd);
-
-    {
-        auto start = std::chrono::system_clock::now();
-        // Truncate SVD tensors:
-        truncateSvdTensors(q1TensorName, q2TensorName, m_svdCutoff);  
-        auto end = std::chrono::system_clock::now();
-        getStatInstance("Truncate SVD Tensor").addSample(start, end);
+        syncTwoQubitGates();
     }
-    
-    // Rebuild the tensor network since the qubit tensors have been changed after SVD truncation
-    // e.g. we destroy the original tensors and replace with smaller dimension ones
-    m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap());  
-
-    const bool mergedTensorDestroyed = exatn::destroyTensor(mergedTensor->getName());
-    assert(mergedTensorDestroyed);
-
-    const auto gateEnd = std::chrono::system_clock::now();
-    getStatInstance("Two-qubit Gate Total").addSample(gateStart, gateEnd);
-    exatn::sync();
 #else
     // MPI
     // !! The two qubit tensors must exist in this process group !!
@@ -1716,7 +1984,7 @@ void ExatnMpsVisitor::applyTwoQubitGate(xacc::Instruction& in_gateInstruction)
         mergedTensor->rename("D");
         
         // std::cout << "Contraction Pattern: " << mergeContractionPattern << "\n";
-        const bool mergedTensorCreated = exatn::createTensorSync(*m_selfProcessGroup, mergedTensor, exatn::TensorElementType::COMPLEX64);
+        const bool mergedTensorCreated = exatn::createTensorSync(*m_selfProcessGroup, mergedTensor, m_elementType);
         assert(mergedTensorCreated);
         const bool mergedTensorInitialized = exatn::initTensorSync(mergedTensor->getName(), 0.0);
         assert(mergedTensorInitialized);
@@ -1728,17 +1996,17 @@ void ExatnMpsVisitor::applyTwoQubitGate(xacc::Instruction& in_gateInstruction)
         const std::string uniqueGateTensorName = in_gateInstruction.name();
 
         // Create the tensor
-        const bool created = exatn::createTensorSync(*m_selfProcessGroup, uniqueGateTensorName, exatn::TensorElementType::COMPLEX64, gateTensor.tensorShape);
+        const bool created = exatn::createTensorSync(*m_selfProcessGroup, uniqueGateTensorName, m_elementType, gateTensor.tensorShape);
         assert(created);
         // Init tensor body data
-        const bool initialized = exatn::initTensorDataSync(uniqueGateTensorName, gateTensor.tensorData);
+        const bool initialized = initTensorBody(uniqueGateTensorName, m_elementType, gateTensor.tensorData);
         assert(initialized);
         
         assert(mergedTensor->getRank() >=2 && mergedTensor->getRank() <= 4);
         const std::string RESULT_TENSOR_NAME = "Result";
         // Result tensor always has the same shape as the *merged* qubit tensor
         const bool resultTensorCreated = exatn::createTensorSync(*m_selfProcessGroup, RESULT_TENSOR_NAME, 
-                                                                exatn::TensorElementType::COMPLEX64, 
+                                                                m_elementType, 
                                                                 mergedTensor->getShape());
         assert(resultTensorCreated);
         const bool resultTensorInitialized = exatn::initTensorSync(RESULT_TENSOR_NAME, 0.0);
@@ -1806,16 +2074,7 @@ void ExatnMpsVisitor::applyTwoQubitGate(xacc::Instruction& in_gateInstruction)
         
         const std::vector<std::complex<double>> resultTensorData =  getTensorData(RESULT_TENSOR_NAME);
         std::function<int(talsh::Tensor& in_tensor)> updateFunc = [&resultTensorData](talsh::Tensor& in_tensor){
-            std::complex<double>* elements;
-            
-            if (in_tensor.getDataAccessHost(&elements) && (in_tensor.getVolume() == resultTensorData.size())) 
-            {
-                for (int i = 0; i < in_tensor.getVolume(); ++i)
-                {
-                    elements[i] = resultTensorData[i];
-                }            
-            }
-
+            writeTensorBody(in_tensor, resultTensorData);
             return 0;
         };
 
@@ -1854,239 +2113,1472 @@ void ExatnMpsVisitor::applyTwoQubitGate(xacc::Instruction& in_gateInstruction)
         int volQ2 = 1;
         for (int i = 0; i < q1Shape.size(); ++i)
         {
-            if (i != q1BondLegId)
-            {
-                volQ1 *= q1Shape[i];
-            }
+            if (i != q1BondLegId)
+            {
+                volQ1 *= q1Shape[i];
+            }
+        }
+
+        for (int i = 0; i < q2Shape.size(); ++i)
+        {
+            if (i != q2BondLegId)
+            {
+                volQ2 *= q2Shape[i];
+            }
+        }
+
+        const int newBondDim = std::min(volQ1, volQ2);
+        // Update bond dimension
+        q1Shape[q1BondLegId] = newBondDim;
+        q2Shape[q2BondLegId] = newBondDim;
+
+        // Destroy old qubit tensors
+        const bool q1Destroyed = exatn::destroyTensor(q1TensorName);
+        assert(q1Destroyed);
+        const bool q2Destroyed = exatn::destroyTensor(q2TensorName);
+        assert(q2Destroyed);
+        exatn::sync(mergedTensor->getName());
+
+        // Create two new tensors:
+        const bool q1Created = exatn::createTensorSync(*m_selfProcessGroup, q1TensorName, m_elementType, q1Shape);
+        assert(q1Created);
+        
+        const bool q2Created = exatn::createTensorSync(*m_selfProcessGroup, q2TensorName, m_elementType, q2Shape);
+        assert(q2Created);
+        exatn::sync(q1TensorName);
+        exatn::sync(q2TensorName);
+        exatn::sync(mergedTensor->getName());
+        
+        {
+            // SVD decomposition using the same pattern that was used to merge two tensors
+            // xacc::info("SVD: " + mergeContractionPattern);
+            // mergedTensor->printIt();
+            // exatn::getTensor(q1TensorName)->printIt();
+            // exatn::getTensor(q2TensorName)->printIt();
+            // printTensorData(mergedTensor->getName());
+            if (m_elementType == exatn::TensorElementType::COMPLEX32)
+            {
+                // Mixed precision: the split runs in double precision.
+                decomposeTensorSVDInDouble(mergeContractionPattern, mergedTensor->getName(), q1TensorName, q2TensorName);
+            }
+            else
+            {
+                const bool svdOk = exatn::decomposeTensorSVDLRSync(mergeContractionPattern);
+                assert(svdOk);
+            }
+        }
+
+        exatn::sync(q1TensorName);
+        exatn::sync(q2TensorName);
+
+        // Validate SVD tensors
+        // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
+        {
+            // Validate SVD tensors
+            // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
+            const auto calcMpsTensorNorm = [](const std::string& in_tensorName) {
+                double sumNorm = 0.0;
+                const bool normOk = exatn::computeNorm2Sync(in_tensorName, sumNorm);
+                return sumNorm;
+            };
+
+            const double q1NormAfter = calcMpsTensorNorm(q1TensorName);
+            const double q2NormAfter = calcMpsTensorNorm(q2TensorName);
+            if (std::fabs(q1NormAfter) < 1e-3 || std::fabs(q2NormAfter) < 1e-3)
+            {
+                std::cout << "[ERROR] Tensor norm validation failed!\n";
+                std::cout << in_gateInstruction.toString() << "\n";
+                std::cout << q1TensorName << " norm = " << q1NormAfter << "\n";
+                std::cout << q2TensorName << " norm = " << q2NormAfter << "\n";
+                std::cout << "Tensor SVD Pattern: " <<  mergeContractionPattern << "\n";
+                std::cout << "Merged Tensor: \n";
+                printTensorData(mergedTensor->getName());
+                std::cout << q1TensorName << "\n";
+                printTensorData(q1TensorName);
+                std::cout << q2TensorName << "\n";
+                printTensorData(q2TensorName);
+                // Crash in DEBUG to aid debugging.
+                assert(false);
+            }
+        }
+        
+        const auto buildTensorMap = [&](){
+            std::map<std::string, std::shared_ptr<exatn::Tensor>> tensorMap;
+            tensorMap.emplace(ROOT_TENSOR_NAME, m_rootTensor);
+            for (int i = 0; i < m_buffer->size(); ++i)
+            {
+                const std::string qTensorName = "Q" + std::to_string(i);
+                tensorMap.emplace(qTensorName, exatn::getTensor(qTensorName));
+            }
+            return tensorMap;
+        };
+        
+        const std::string rootVarNameList = [&](){
+            std::string result = "(";
+            for (int i = 0; i < m_buffer->size() - 1; ++i)
+            {
+                result += ("i" + std::to_string(i) + ",");
+            }
+            result += ("i" + std::to_string(m_buffer->size() - 1) + ")");
+            return result;
+        }();
+        
+        const auto qubitTensorVarNameList = [&](int in_qIdx) -> std::string {
+            if (in_qIdx == 0)
+            {
+                return "(i0,j0)";
+            } 
+            if (in_qIdx == m_buffer->size() - 1)
+            {
+                return "(j" + std::to_string(m_buffer->size() - 2) + ",i" + std::to_string(m_buffer->size() - 1) + ")";
+            }
+
+            return "(j" + std::to_string(in_qIdx-1) + ",i" + std::to_string(in_qIdx) + ",j" + std::to_string(in_qIdx)+ ")";
+        };
+        
+        const std::string mpsString = [&](){
+            std::string result = ROOT_TENSOR_NAME + rootVarNameList + "=";
+            for (int i = 0; i < m_buffer->size() - 1; ++i)
+            {
+                result += ("Q" + std::to_string(i) + qubitTensorVarNameList(i) + "*");
+            }
+            result += ("Q" + std::to_string(m_buffer->size() - 1) + qubitTensorVarNameList(m_buffer->size() - 1));
+            return result;
+        }();
+
+        // std::cout << "MPS: " << mpsString << "\n";
+        m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap()); 
+        {
+            // Truncate SVD tensors:
+            truncateSvdTensors(q1TensorName, q2TensorName, m_svdCutoff);  
+        }
+        
+        // Rebuild the tensor network since the qubit tensors have been changed after SVD truncation
+        // e.g. we destroy the original tensors and replace with smaller dimension ones
+        m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap());  
+
+        const bool mergedTensorDestroyed = exatn::destroyTensor(mergedTensor->getName());
+        assert(mergedTensorDestroyed);
+
+        // Validate norm:
+        // const auto normVec = computeStateVectorNorm(*m_tensorNetwork, *m_selfProcessGroup);
+        // xacc::info("Norm = " + std::to_string(normVec));
+    };
+
+    const int q1 = in_gateInstruction.bits()[0];
+    const int q2 = in_gateInstruction.bits()[1];
+    const int qMin = q1 < q2 ? q1 : q2;
+    const int qMax = q1 > q2 ? q1 : q2;
+
+    const size_t minOwner = m_qubitIdxToRank.at(qMin);
+    const size_t maxOwner = m_qubitIdxToRank.at(qMax);
+    if (minOwner == maxOwner)
+    {
+        // Both qubits in the range of a process: borrowed tensors must be sent back to the owner first.
+        returnLentSite(qMin);
+        returnLentSite(qMax);
+    }
+    else
+    {
+        // Boundary gate: the left process computes the gate, borrowing the right qubit tensor.
+        // The borrowed tensor is only sent back when the right process needs it,
+        // hence consecutive gates across the same boundary only need one exchange
+        // and the right process can carry on with its interior gates in the meantime.
+        returnLentSite(qMin);
+        if (m_lentSites.find(qMax) == m_lentSites.end())
+        {
+            lendSite(qMax);
+        }
+    }
+
+    if (minOwner == m_rank)
+    {
+        xacc::info("Process [" + std::to_string(m_rank) + "]: Process gate: " + in_gateInstruction.toString());
+        processTwoQubitGate();
+    }
+    else 
+    {
+        // Don't care: the gate is computed by another process.
+        xacc::info("Process [" + std::to_string(m_rank) + "]: Ignore gate: " + in_gateInstruction.toString());
+    }
+
+    // All processes visit all the gates, hence agree on when to rebalance.
+    ++m_twoQubitGateCount;
+    if (m_rebalanceInterval > 0 && m_rankFirstSites.size() > 1 && (m_twoQubitGateCount % m_rebalanceInterval == 0))
+    {
+        rebalanceQubitPartition();
+    }
+#endif
+}
+
+#ifdef TNQVM_MPI_ENABLED
+void ExatnMpsVisitor::gatherMeasureSamples(const std::vector<std::vector<uint8_t>>& in_localSamples, size_t in_firstShot, size_t in_totalShots)
+{
+    // Bit strings are packed into 32-bit words (exactly representable as double) of a (shots x words) tensor:
+    // each process fills in the rows of its own shots, then the tensor is sum-reduced across all processes.
+    const size_t nbBits = m_measureQubits.size();
+    const size_t nbWords = (nbBits + 31) / 32;
+    const std::string samplesTensorName = "MpsMeasureSamples";
+    std::vector<double> localData(in_totalShots * nbWords, 0.0);
+    for (size_t shot = 0; shot < in_localSamples.size(); ++shot)
+    {
+        assert(in_localSamples[shot].size() == nbBits);
+        for (size_t word = 0; word < nbWords; ++word)
+        {
+            uint64_t wordVal = 0;
+            for (size_t bit = 32 * word; bit < std::min(nbBits, 32 * (word + 1)); ++bit)
+            {
+                wordVal |= static_cast<uint64_t>(in_localSamples[shot][bit]) << (bit - 32 * word);
+            }
+            localData[(in_firstShot + shot) + in_totalShots * word] = wordVal;
+        }
+    }
+    const bool created = exatn::createTensor(samplesTensorName, exatn::TensorElementType::REAL64, exatn::TensorShape{in_totalShots, nbWords});
+    assert(created);
+    exatn::initTensorData(samplesTensorName, localData);
+    const bool allReduced = exatn::allreduceTensorSync(exatn::getDefaultProcessGroup(), samplesTensorName);
+    assert(allReduced);
+    if (m_rank == 0)
+    {
+        auto talsh_tensor = exatn::getLocalTensor(samplesTensorName);
+        const double* body_ptr;
+        const bool accessOk = talsh_tensor->getDataAccessHostConst(&body_ptr);
+        assert(accessOk);
+        for (size_t shot = 0; shot < in_totalShots; ++shot)
+        {
+            std::string bitString;
+            for (size_t bit = 0; bit < nbBits; ++bit)
+            {
+                const auto wordVal = static_cast<uint64_t>(body_ptr[shot + in_totalShots * (bit / 32)]);
+                bitString.append(std::to_string((wordVal >> (bit % 32)) & 1));
+            }
+            m_buffer->appendMeasurement(bitString);
+        }
+    }
+    const bool destroyed = exatn::destroyTensorSync(samplesTensorName);
+    assert(destroyed);
+}
+
+bool ExatnMpsVisitor::isHoldingSite(size_t in_siteIdx) const
+{
+    const size_t owner = m_qubitIdxToRank.at(in_siteIdx);
+    const bool lent = m_lentSites.find(in_siteIdx) != m_lentSites.end();
+    return lent ? (m_rank + 1 == owner) : (m_rank == owner);
+}
+
+void ExatnMpsVisitor::lendSite(size_t in_siteIdx)
+{
+    const size_t owner = m_qubitIdxToRank.at(in_siteIdx);
+    assert(owner > 0);
+    m_lentSites.emplace(in_siteIdx);
+    const std::string qubitTensorName = "Q" + std::to_string(in_siteIdx);
+    if (m_rank == owner)
+    {
+        // Send the tensor to the left process (no need to wait for the completion:
+        // this process won't touch the tensor until it is sent back).
+        assert(m_leftSharedProcessGroup);
+        unsigned int myLocalRank;
+        const bool checkRank = m_leftSharedProcessGroup->rankIsIn(m_rank, &myLocalRank);
+        assert(checkRank);
+        const bool broadcastOk = exatn::replicateTensor(*m_leftSharedProcessGroup, qubitTensorName, myLocalRank);
+        assert(broadcastOk);
+    }
+    else if (m_rank + 1 == owner)
+    {
+        // Receive the tensor from the right process
+        assert(m_rightSharedProcessGroup);
+        const bool qTensorDestroyed = exatn::destroyTensor(qubitTensorName);
+        assert(qTensorDestroyed);
+        unsigned int neighborLocalRank;
+        const bool checkRank = m_rightSharedProcessGroup->rankIsIn(owner, &neighborLocalRank);
+        assert(checkRank);
+        const bool broadcastOk = exatn::replicateTensorSync(*m_rightSharedProcessGroup, qubitTensorName, neighborLocalRank);
+        assert(broadcastOk);
+        // Update the tensor network to take into account the received tensor.
+        rebuildTensorNetwork();
+    }
+}
+
+void ExatnMpsVisitor::returnLentSite(size_t in_siteIdx)
+{
+    if (m_lentSites.erase(in_siteIdx) == 0)
+    {
+        return;
+    }
+    const size_t owner = m_qubitIdxToRank.at(in_siteIdx);
+    const std::string qubitTensorName = "Q" + std::to_string(in_siteIdx);
+    if (m_rank + 1 == owner)
+    {
+        // Send the (updated) tensor back to the owner
+        assert(m_rightSharedProcessGroup);
+        unsigned int myLocalRank;
+        const bool checkRank = m_rightSharedProcessGroup->rankIsIn(m_rank, &myLocalRank);
+        assert(checkRank);
+        const bool broadcastOk = exatn::replicateTensor(*m_rightSharedProcessGroup, qubitTensorName, myLocalRank);
+        assert(broadcastOk);
+    }
+    else if (m_rank == owner)
+    {
+        assert(m_leftSharedProcessGroup);
+        const bool qTensorDestroyed = exatn::destroyTensor(qubitTensorName);
+        assert(qTensorDestroyed);
+        unsigned int neighborLocalRank;
+        const bool checkRank = m_leftSharedProcessGroup->rankIsIn(m_rank - 1, &neighborLocalRank);
+        assert(checkRank);
+        const bool broadcastOk = exatn::replicateTensorSync(*m_leftSharedProcessGroup, qubitTensorName, neighborLocalRank);
+        assert(broadcastOk);
+        rebuildTensorNetwork();
+    }
+}
+
+void ExatnMpsVisitor::returnAllLentSites()
+{
+    // In ascending order: all processes agree on the order of the exchanges.
+    const std::vector<size_t> lentSites(m_lentSites.begin(), m_lentSites.end());
+    for (const auto& siteIdx : lentSites)
+    {
+        returnLentSite(siteIdx);
+    }
+}
+
+void ExatnMpsVisitor::updateQubitPartition(const std::vector<size_t>& in_rankFirstSites)
+{
+    m_rankFirstSites = in_rankFirstSites;
+    m_qubitIdxToRank.clear();
+    for (size_t rank = 0; rank < m_rankFirstSites.size(); ++rank)
+    {
+        const size_t lastSite = (rank + 1 < m_rankFirstSites.size()) ? m_rankFirstSites[rank + 1] - 1 : m_buffer->size() - 1;
+        for (size_t i = m_rankFirstSites[rank]; i <= lastSite; ++i)
+        {
+            m_qubitIdxToRank.emplace(i, rank);
+        }
+        if (rank == m_rank)
+        {
+            m_qubitRange = std::make_pair(m_rankFirstSites[rank], lastSite);
+        }
+    }
+}
+
+void ExatnMpsVisitor::rebalanceQubitPartition()
+{
+    const auto rebalanceStart = std::chrono::system_clock::now();
+    returnAllLentSites();
+    const size_t nbRanks = m_rankFirstSites.size();
+    // Site cost: volume of the site tensor (chi_left * chi_right * 2).
+    // Each process fills in the cost of the sites it owns, then the cost vector is all-reduced.
+    const std::string siteCostTensorName = "MpsSiteCosts";
+    std::vector<double> localCosts(m_buffer->size(), 0.0);
+    for (size_t i = m_qubitRange.first; i <= m_qubitRange.second; ++i)
+    {
+        localCosts[i] = exatn::getTensor("Q" + std::to_string(i))->getVolume();
+    }
+    const bool created = exatn::createTensor(siteCostTensorName, exatn::TensorElementType::REAL64, exatn::TensorShape{m_buffer->size()});
+    assert(created);
+    exatn::initTensorData(siteCostTensorName, localCosts);
+    const bool allReduced = exatn::allreduceTensorSync(exatn::getDefaultProcessGroup(), siteCostTensorName);
+    assert(allReduced);
+    std::vector<double> siteCosts;
+    {
+        auto talsh_tensor = exatn::getLocalTensor(siteCostTensorName);
+        const double* body_ptr;
+        if (talsh_tensor->getDataAccessHostConst(&body_ptr))
+        {
+            siteCosts.assign(body_ptr, body_ptr + talsh_tensor->getVolume());
+        }
+    }
+    const bool destroyed = exatn::destroyTensorSync(siteCostTensorName);
+    assert(destroyed);
+    assert(siteCosts.size() == m_buffer->size());
+
+    // Check the current load imbalance (max/mean rank load)
+    std::vector<double> rankLoads(nbRanks, 0.0);
+    for (const auto& [qubitIdx, rank] : m_qubitIdxToRank)
+    {
+        rankLoads[rank] += siteCosts[qubitIdx];
+    }
+    const double meanLoad = std::accumulate(rankLoads.begin(), rankLoads.end(), 0.0) / nbRanks;
+    const double imbalance = *std::max_element(rankLoads.begin(), rankLoads.end()) / meanLoad;
+    if (imbalance <= m_rebalanceThreshold)
+    {
+        return;
+    }
+
+    // Move the partition boundaries toward the balanced partition.
+    // A boundary can only move within its neighboring ranges, so that sites are only migrated between neighboring ranks.
+    const auto targetFirstSites = partitionSites(siteCosts, nbRanks);
+    std::vector<size_t> newFirstSites(m_rankFirstSites);
+    for (size_t rank = 1; rank < nbRanks; ++rank)
+    {
+        const size_t lowerBound = std::max(newFirstSites[rank - 1], m_rankFirstSites[rank - 1]) + 1;
+        const size_t upperBound = (rank + 1 < nbRanks ? m_rankFirstSites[rank + 1] : m_buffer->size()) - 1;
+        newFirstSites[rank] = std::min(std::max(targetFirstSites[rank], lowerBound), upperBound);
+    }
+    if (newFirstSites == m_rankFirstSites)
+    {
+        return;
+    }
+
+    // Migrate the boundary sites (in ascending order, hence each pair of neighbors agrees on the order of the exchanges).
+    for (size_t rank = 1; rank < nbRanks; ++rank)
+    {
+        const size_t oldBoundary = m_rankFirstSites[rank];
+        const size_t newBoundary = newFirstSites[rank];
+        if (oldBoundary == newBoundary || (m_rank != rank - 1 && m_rank != rank))
+        {
+            continue;
+        }
+        // Shared group of the (rank - 1, rank) pair
+        const auto& sharedGroup = (m_rank == rank) ? m_leftSharedProcessGroup : m_rightSharedProcessGroup;
+        assert(sharedGroup);
+        // Boundary moving left: sites go from (rank - 1) to rank, and vice versa.
+        const size_t senderRank = (newBoundary < oldBoundary) ? rank - 1 : rank;
+        unsigned int senderLocalRank;
+        const bool checkRank = sharedGroup->rankIsIn(senderRank, &senderLocalRank);
+        assert(checkRank);
+        for (size_t i = std::min(oldBoundary, newBoundary); i < std::max(oldBoundary, newBoundary); ++i)
+        {
+            const std::string qubitTensorName = "Q" + std::to_string(i);
+            if (m_rank != senderRank)
+            {
+                const bool qTensorDestroyed = exatn::destroyTensor(qubitTensorName);
+                assert(qTensorDestroyed);
+            }
+            const bool broadcastOk = exatn::replicateTensorSync(*sharedGroup, qubitTensorName, senderLocalRank);
+            assert(broadcastOk);
+        }
+    }
+
+    updateQubitPartition(newFirstSites);
+    rebuildTensorNetwork();
+    m_rebalanceEvents[m_twoQubitGateCount] = std::vector<int>(newFirstSites.begin(), newFirstSites.end());
+    xacc::info("Process [" + std::to_string(m_rank) + "]: Rebalanced MPS partition (load imbalance = " + std::to_string(imbalance) + "); handles qubit " + 
+        std::to_string(m_qubitRange.first) + " to " + std::to_string(m_qubitRange.second));
+    const auto rebalanceEnd = std::chrono::system_clock::now();
+    getStatInstance("Rebalance").addSample(rebalanceStart, rebalanceEnd);
+}
+#endif
+
+std::pair<std::string, std::string> ExatnMpsVisitor::submitTwoQubitGateContraction(xacc::Instruction& in_gateInstruction, std::string& out_svdPattern)
+{
+    const int q1 = in_gateInstruction.bits()[0];
+    const int q2 = in_gateInstruction.bits()[1];
+    // Neighbors only
+    assert(std::abs(q1 - q2) == 1);
+    const std::string q1TensorName = "Q" + std::to_string(q1);
+    const std::string q2TensorName = "Q" + std::to_string(q2);
+
+    // Step 1: merge two tensor together
+    const auto getQubitTensorId = [&](const std::string& in_tensorName) {
+        const auto idsVec = m_tensorNetwork->getTensorIdsInNetwork(in_tensorName);
+        assert(idsVec.size() == 1);
+        return idsVec.front();
+    };
+    
+    // Merge Q2 into Q1 
+    const auto mergedTensorId = m_tensorNetwork->getMaxTensorId() + 1;
+    std::string mergeContractionPattern;
+    if (q1 < q2)
+    {
+        m_tensorNetwork->mergeTensors(getQubitTensorId(q1TensorName), getQubitTensorId(q2TensorName), mergedTensorId, &mergeContractionPattern);
+        mergeContractionPattern.replace(mergeContractionPattern.find("L"), 1, q1TensorName);
+        mergeContractionPattern.replace(mergeContractionPattern.find("R"), 1, q2TensorName);
+    }
+    else
+    {
+        m_tensorNetwork->mergeTensors(getQubitTensorId(q2TensorName), getQubitTensorId(q1TensorName), mergedTensorId, &mergeContractionPattern);
+        mergeContractionPattern.replace(mergeContractionPattern.find("L"), 1, q2TensorName);
+        mergeContractionPattern.replace(mergeContractionPattern.find("R"), 1, q1TensorName);
+    }
+
+    auto mergedTensor =  m_tensorNetwork->getTensor(mergedTensorId);
+    // Scratch tensors of this gate: they stay reserved until the layer is synchronized,
+    // hence are unique among the gates in flight.
+    const std::string mergedTensorName = m_tensorPool.acquireScratchTensor(mergedTensor->getShape(), m_elementType);
+    mergedTensor->rename(mergedTensorName);
+    // The merge pattern is "D(...)=Q1(...)*Q2(...)": use the scratch tensor name instead.
+    assert(mergeContractionPattern.front() == 'D');
+    mergeContractionPattern.replace(0, 1, mergedTensorName);
+    
+    // Note: the contractions accumulate into the output tensors, hence zero them first.
+    const bool mergedTensorInitialized = exatn::initTensor(mergedTensorName, 0.0);
+    assert(mergedTensorInitialized);
+    const bool mergedContractionOk = exatn::contractTensors(mergeContractionPattern, 1.0);
+    assert(mergedContractionOk);
+    
+    // Step 2: contract the merged tensor with the gate
+    const auto gateTensor = GateTensorConstructor::getGateTensor(in_gateInstruction);
+    // Gate tensor (created once, cached by the pool)
+    const std::string uniqueGateTensorName = m_tensorPool.getGateTensor(gateTensor.uniqueName, exatn::TensorShape(gateTensor.tensorShape), gateTensor.tensorData, m_elementType);
+    
+    assert(mergedTensor->getRank() >=2 && mergedTensor->getRank() <= 4);
+    // Result tensor always has the same shape as the *merged* qubit tensor
+    const std::string resultTensorName = m_tensorPool.acquireScratchTensor(mergedTensor->getShape(), m_elementType);
+    const bool resultTensorInitialized = exatn::initTensor(resultTensorName, 0.0);
+    assert(resultTensorInitialized);
+    
+    std::string patternStr;
+    if (mergedTensor->getRank() == 3)
+    {
+        // Pattern: Result(a,b,c) = D(i,j,c)*Gate(i,j,a,b)
+        if (q1 < q2)
+        {
+            if (q1 == 0)
+            {
+                patternStr = resultTensorName + "(a,b,c)=" + mergedTensorName + "(i,j,c)*" + uniqueGateTensorName + "(j,i,b,a)";
+            }
+            else
+            {
+                patternStr = resultTensorName + "(a,b,c)=" + mergedTensorName + "(a,i,j)*" + uniqueGateTensorName + "(j,i,c,b)";
+            }
+        }
+        else
+        {
+            if (q2 == 0)
+            {
+                patternStr = resultTensorName + "(a,b,c)=" + mergedTensorName + "(i,j,c)*" + uniqueGateTensorName + "(i,j,a,b)";
+            }
+            else
+            {
+                patternStr = resultTensorName + "(a,b,c)=" + mergedTensorName + "(a,i,j)*" + uniqueGateTensorName + "(i,j,b,c)";
+            }
+        }
+    }
+    else if (mergedTensor->getRank() == 4)
+    {
+        if (q1 < q2)
+        {
+            patternStr = resultTensorName + "(a,b,c,d)=" + mergedTensorName + "(a,i,j,d)*" + uniqueGateTensorName + "(j,i,c,b)";
+        }
+        else
+        {
+            patternStr = resultTensorName + "(a,b,c,d)=" + mergedTensorName + "(a,i,j,d)*" + uniqueGateTensorName + "(i,j,b,c)";
+        }
+    }
+    else if (mergedTensor->getRank() == 2)
+    {
+        // Only two-qubit in the qubit register
+        assert(m_buffer->size() == 2);
+        if (q1 < q2)
+        {
+            patternStr = resultTensorName + "(a,b)=" + mergedTensorName + "(i,j)*" + uniqueGateTensorName + "(j,i,b,a)";
+        }
+        else
+        {
+            patternStr = resultTensorName + "(a,b)=" + mergedTensorName + "(i,j)*" + uniqueGateTensorName + "(i,j,a,b)";
+        }
+    }
+    
+    assert(!patternStr.empty());
+    const bool gateContractionOk = exatn::contractTensors(patternStr, 1.0);
+    assert(gateContractionOk);
+
+    // SVD decomposition using the same pattern that was used to merge two tensors
+    // (the result tensor has the same shape and leg order as the merged tensor).
+    out_svdPattern = mergeContractionPattern;
+    out_svdPattern.replace(0, mergedTensorName.size(), resultTensorName);
+    return std::make_pair(mergedTensorName, resultTensorName);
+}
+
+void ExatnMpsVisitor::decomposeTensorSVDInDouble(const std::string& in_svdPattern, const std::string& in_resultTensorName,
+                                                 const std::string& in_leftTensorName, const std::string& in_rightTensorName,
+                                                 SvdAbsorption in_absorption)
+{
+    const auto getDoubleTensorName = [](const std::string& in_tensorName) { return in_tensorName + "_F64"; };
+    std::string svdPattern = in_svdPattern;
+    for (const auto& tensorName : { in_resultTensorName, in_leftTensorName, in_rightTensorName })
+    {
+        // Tensor name (as a whole): preceded by the start of the pattern, '=' or '*'.
+        size_t pos = svdPattern.find(tensorName + "(");
+        while (pos != std::string::npos && pos != 0 && svdPattern[pos - 1] != '=' && svdPattern[pos - 1] != '*')
+        {
+            pos = svdPattern.find(tensorName + "(", pos + 1);
+        }
+        assert(pos != std::string::npos);
+        svdPattern.replace(pos, tensorName.size(), getDoubleTensorName(tensorName));
+
+        const auto tensorShape = exatn::getTensor(tensorName)->getShape();
+#ifdef TNQVM_MPI_ENABLED
+        const bool created = exatn::createTensorSync(*m_selfProcessGroup, getDoubleTensorName(tensorName), exatn::TensorElementType::COMPLEX64, tensorShape);
+#else
+        const bool created = exatn::createTensorSync(getDoubleTensorName(tensorName), exatn::TensorElementType::COMPLEX64, tensorShape);
+#endif
+        assert(created);
+    }
+
+    exatn::sync(in_resultTensorName);
+    const bool initialized = exatn::initTensorDataSync(getDoubleTensorName(in_resultTensorName), getTensorData(in_resultTensorName));
+    assert(initialized);
+    const bool svdOk = (in_absorption == SvdAbsorption::Left) ? exatn::decomposeTensorSVDLSync(svdPattern) :
+                       (in_absorption == SvdAbsorption::Right) ? exatn::decomposeTensorSVDRSync(svdPattern) :
+                                                                 exatn::decomposeTensorSVDLRSync(svdPattern);
+    assert(svdOk);
+    for (const auto& tensorName : { in_leftTensorName, in_rightTensorName })
+    {
+        const bool factorInitialized = initTensorBody(tensorName, m_elementType, getTensorData(getDoubleTensorName(tensorName)));
+        assert(factorInitialized);
+    }
+    for (const auto& tensorName : { in_resultTensorName, in_leftTensorName, in_rightTensorName })
+    {
+        const bool destroyed = exatn::destroyTensorSync(getDoubleTensorName(tensorName));
+        assert(destroyed);
+    }
+}
+
+void ExatnMpsVisitor::decomposeTensorSVDSync(const std::string& in_svdPattern, const std::string& in_resultTensorName,
+                                             const std::string& in_leftTensorName, const std::string& in_rightTensorName, SvdAbsorption in_absorption)
+{
+    if (m_elementType == exatn::TensorElementType::COMPLEX32)
+    {
+        decomposeTensorSVDInDouble(in_svdPattern, in_resultTensorName, in_leftTensorName, in_rightTensorName, in_absorption);
+        return;
+    }
+    const bool svdOk = (in_absorption == SvdAbsorption::Left) ? exatn::decomposeTensorSVDLSync(in_svdPattern) :
+                       (in_absorption == SvdAbsorption::Right) ? exatn::decomposeTensorSVDRSync(in_svdPattern) :
+                                                                 exatn::decomposeTensorSVDLRSync(in_svdPattern);
+    assert(svdOk);
+}
+
+void ExatnMpsVisitor::submitTwoQubitGate(xacc::Instruction& in_gateInstruction)
+{
+    const auto gateStart = std::chrono::system_clock::now();
+    // The SVD split (both factors truncated) doesn't preserve the canonical form.
+    m_orthoCenter = -1;
+    const int q1 = in_gateInstruction.bits()[0];
+    const int q2 = in_gateInstruction.bits()[1];
+    const std::string q1TensorName = "Q" + std::to_string(q1);
+    const std::string q2TensorName = "Q" + std::to_string(q2);
+    auto q1Tensor = exatn::getTensor(q1TensorName);
+    auto q2Tensor = exatn::getTensor(q2TensorName);
+    
+    // Step 1 and 2: merge the two qubit tensors and contract with the gate
+    std::string svdPattern;
+    const auto [mergedTensorName, resultTensorName] = submitTwoQubitGateContraction(in_gateInstruction, svdPattern);
+
+    // Step 3: SVD the result tensor back into two MPS qubit tensors
+    const auto getBondLegId = [&](int in_qubitIdx, int in_otherQubitIdx){
+        if (in_qubitIdx == 0)
+        {
+            return 1;
+        }
+        if(in_qubitIdx == (m_buffer->size() - 1))
+        {
+            return 0;
+        }
+
+        return (in_qubitIdx < in_otherQubitIdx) ? 2 : 0;
+    };
+
+    auto q1Shape = q1Tensor->getDimExtents();
+    auto q2Shape = q2Tensor->getDimExtents();
+    
+    const auto q1BondLegId = getBondLegId(q1, q2);
+    const auto q2BondLegId = getBondLegId(q2, q1);
+    assert(q1Shape[q1BondLegId] == q2Shape[q2BondLegId]);
+    int volQ1 = 1;
+    int volQ2 = 1;
+    for (int i = 0; i < q1Shape.size(); ++i)
+    {
+        if (i != q1BondLegId)
+        {
+            volQ1 *= q1Shape[i];
+        }
+    }
+
+    for (int i = 0; i < q2Shape.size(); ++i)
+    {
+        if (i != q2BondLegId)
+        {
+            volQ2 *= q2Shape[i];
+        }
+    }
+
+    const int newBondDim = std::min(volQ1, volQ2);
+    // Update bond dimension
+    q1Shape[q1BondLegId] = newBondDim;
+    q2Shape[q2BondLegId] = newBondDim;
+
+    // Replace the old qubit tensors (once the merge contraction has consumed them)
+    const bool q1Destroyed = exatn::destroyTensor(q1TensorName);
+    assert(q1Destroyed);
+    const bool q2Destroyed = exatn::destroyTensor(q2TensorName);
+    assert(q2Destroyed);
+    const bool q1Created = exatn::createTensor(q1TensorName, m_elementType, q1Shape);
+    assert(q1Created);
+    const bool q2Created = exatn::createTensor(q2TensorName, m_elementType, q2Shape);
+    assert(q2Created);
+
+    if (m_elementType == exatn::TensorElementType::COMPLEX32)
+    {
+        // Mixed precision: the split runs (synchronously) in double precision.
+        decomposeTensorSVDInDouble(svdPattern, resultTensorName, q1TensorName, q2TensorName);
+    }
+    else
+    {
+        const bool svdOk = exatn::decomposeTensorSVDLR(svdPattern);
+        assert(svdOk);
+    }
+
+    m_pendingSites.emplace(q1);
+    m_pendingSites.emplace(q2);
+    m_pendingTwoQubitGates.emplace_back(PendingTwoQubitGate{ q1TensorName, q2TensorName, in_gateInstruction.toString(), { mergedTensorName, resultTensorName } });
+    m_maxPendingSites = std::max(m_maxPendingSites, m_pendingSites.size() + m_pendingSingleQubitGates.size());
+    const auto gateEnd = std::chrono::system_clock::now();
+    getStatInstance("Two-qubit Gate Submit").addSample(gateStart, gateEnd);
+}
+
+void ExatnMpsVisitor::syncSingleQubitGates(size_t in_site)
+{
+    const auto iter = m_pendingSingleQubitGates.find(in_site);
+    if (iter == m_pendingSingleQubitGates.end())
+    {
+        return;
+    }
+
+    const bool synced = exatn::sync("Q" + std::to_string(in_site));
+    assert(synced);
+    for (const auto& scratchTensorName : iter->second)
+    {
+        m_tensorPool.releaseScratchTensor(scratchTensorName);
+    }
+    m_pendingSingleQubitGates.erase(iter);
+}
+
+void ExatnMpsVisitor::syncTwoQubitGates()
+{
+    if (m_pendingTwoQubitGates.empty() && m_pendingSingleQubitGates.empty())
+    {
+        return;
+    }
+
+    const auto syncStart = std::chrono::system_clock::now();
+    // Wait for all the pipelines of this layer.
+    exatn::sync();
+    for (const auto& [site, scratchTensorNames] : m_pendingSingleQubitGates)
+    {
+        for (const auto& scratchTensorName : scratchTensorNames)
+        {
+            m_tensorPool.releaseScratchTensor(scratchTensorName);
+        }
+    }
+    m_pendingSingleQubitGates.clear();
+    if (m_pendingTwoQubitGates.empty())
+    {
+        return;
+    }
+    // The scratch tensors of this layer can now be reused.
+    for (const auto& pendingGate : m_pendingTwoQubitGates)
+    {
+        for (const auto& scratchTensorName : pendingGate.scratchTensorNames)
+        {
+            m_tensorPool.releaseScratchTensor(scratchTensorName);
+        }
+    }
+
+    // Validate SVD tensors
+    // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
+    const auto calcMpsTensorNorm = [](const std::string& in_tensorName) {
+        double sumNorm = 0.0;
+        const bool normOk = exatn::computeNorm2Sync(in_tensorName, sumNorm);
+        return sumNorm;
+    };
+    for (const auto& pendingGate : m_pendingTwoQubitGates)
+    {
+        const double q1NormAfter = calcMpsTensorNorm(pendingGate.q1TensorName);
+        const double q2NormAfter = calcMpsTensorNorm(pendingGate.q2TensorName);
+        if (std::fabs(q1NormAfter) < 1e-3 || std::fabs(q2NormAfter) < 1e-3)
+        {
+            std::cout << "[ERROR] Tensor norm validation failed!\n";
+            std::cout << pendingGate.gateDescription << "\n";
+            std::cout << pendingGate.q1TensorName << " norm = " << q1NormAfter << "\n";
+            std::cout << pendingGate.q2TensorName << " norm = " << q2NormAfter << "\n";
+            std::cout << pendingGate.q1TensorName << "\n";
+            printTensorData(pendingGate.q1TensorName);
+            std::cout << pendingGate.q2TensorName << "\n";
+            printTensorData(pendingGate.q2TensorName);
+            // Crash in DEBUG to aid debugging.
+            assert(false);
+        }
+    }
+    
+    // The qubit tensors have been replaced by the SVD results.
+    rebuildTensorNetwork();
+    {
+        auto start = std::chrono::system_clock::now();
+        // Truncate SVD tensors:
+        for (const auto& pendingGate : m_pendingTwoQubitGates)
+        {
+            truncateSvdTensors(pendingGate.q1TensorName, pendingGate.q2TensorName, m_svdCutoff);  
+        }
+        auto end = std::chrono::system_clock::now();
+        getStatInstance("Truncate SVD Tensor").addSample(start, end);
+    }
+    
+    // Rebuild the tensor network since the qubit tensors have been changed after SVD truncation
+    // e.g. we destroy the original tensors and replace with smaller dimension ones
+    rebuildTensorNetwork();
+    
+    m_pendingTwoQubitGates.clear();
+    m_pendingSites.clear();
+    const auto syncEnd = std::chrono::system_clock::now();
+    getStatInstance("Two-qubit Gate Layer Sync").addSample(syncStart, syncEnd);
+}
+
+void ExatnMpsVisitor::applyTwoQubitGateCanonical(xacc::Instruction& in_gateInstruction)
+{
+    const auto gateStart = std::chrono::system_clock::now();
+    const size_t leftSite = std::min(in_gateInstruction.bits()[0], in_gateInstruction.bits()[1]);
+    const size_t rightSite = leftSite + 1;
+    assert(std::max(in_gateInstruction.bits()[0], in_gateInstruction.bits()[1]) == rightSite);
+    const std::string leftTensorName = "Q" + std::to_string(leftSite);
+    const std::string rightTensorName = "Q" + std::to_string(rightSite);
+    // With the orthogonality center on the left site, the singular values of
+    // the merged two-site tensor are the Schmidt coefficients of the bond.
+    moveOrthoCenter(leftSite);
+
+    std::string svdPattern;
+    const auto [mergedTensorName, resultTensorName] = submitTwoQubitGateContraction(in_gateInstruction, svdPattern);
+    exatn::sync();
+
+    auto leftShape = exatn::getTensor(leftTensorName)->getDimExtents();
+    auto rightShape = exatn::getTensor(rightTensorName)->getDimExtents();
+    // The bond is the last leg of the left tensor and the first leg of the right tensor.
+    const size_t leftVol = exatn::getTensor(leftTensorName)->getVolume() / leftShape.back();
+    const size_t rightVol = exatn::getTensor(rightTensorName)->getVolume() / rightShape.front();
+    const size_t fullBondDim = std::min(leftVol, rightVol);
+    if (!needsTruncation(fullBondDim, leftVol, rightVol, leftSite))
+    {
+        // No truncation: split on the device, the left site is an isometry (U), the right site gets S * V^H.
+        const auto start = std::chrono::system_clock::now();
+        leftShape.back() = fullBondDim;
+        rightShape.front() = fullBondDim;
+        for (const auto& [tensorName, shape] : { std::make_pair(leftTensorName, leftShape), std::make_pair(rightTensorName, rightShape) })
+        {
+            const bool destroyed = exatn::destroyTensorSync(tensorName);
+            assert(destroyed);
+            const bool created = exatn::createTensorSync(tensorName, m_elementType, shape);
+            assert(created);
+        }
+        decomposeTensorSVDSync(svdPattern, resultTensorName, leftTensorName, rightTensorName, SvdAbsorption::Right);
+        m_truncationInfo.bondDimHistory[leftSite].emplace_back(fullBondDim);
+        const auto end = std::chrono::system_clock::now();
+        getStatInstance("Isometric Split").addSample(start, end);
+    }
+    else
+    {
+        std::vector<std::complex<double>> leftData;
+        std::vector<std::complex<double>> rightData;
+        const size_t bondDim = decomposeSiteMatrix(getTensorData(resultTensorName), leftVol, rightVol, leftData, rightData, leftSite);
+        leftShape.back() = bondDim;
+        rightShape.front() = bondDim;
+        resetTensor(leftTensorName, m_elementType, leftShape, leftData);
+        resetTensor(rightTensorName, m_elementType, rightShape, rightData);
+    }
+
+    m_tensorPool.releaseScratchTensor(mergedTensorName);
+    m_tensorPool.releaseScratchTensor(resultTensorName);
+    m_orthoCenter = rightSite;
+    rebuildTensorNetwork();
+    const auto gateEnd = std::chrono::system_clock::now();
+    getStatInstance("Two-qubit Gate (Canonical)").addSample(gateStart, gateEnd);
+}
+
+void ExatnMpsVisitor::applyLongRangeGate(xacc::Instruction& in_gateInstruction)
+{
+    const auto gateStart = std::chrono::system_clock::now();
+    const size_t leftSite = std::min(in_gateInstruction.bits()[0], in_gateInstruction.bits()[1]);
+    const size_t rightSite = std::max(in_gateInstruction.bits()[0], in_gateInstruction.bits()[1]);
+    const size_t nbQubits = m_buffer->size();
+    assert(rightSite > leftSite + 1);
+
+    // Step 1: operator Schmidt decomposition of the gate: U = sum_k A_k (left site) x B_k (right site)
+    // Gate matrix (row-major), bits()[0] is the most significant bit.
+    const auto gateTensor = GateTensorConstructor::getGateTensor(in_gateInstruction);
+    assert(gateTensor.tensorData.size() == 16);
+    const bool leftIsFirst = (in_gateInstruction.bits()[0] == leftSite);
+    const auto gateElement = [&](size_t in_outLeft, size_t in_outRight, size_t in_inLeft, size_t in_inRight) {
+        const size_t row = leftIsFirst ? (2 * in_outLeft + in_outRight) : (2 * in_outRight + in_outLeft);
+        const size_t col = leftIsFirst ? (2 * in_inLeft + in_inRight) : (2 * in_inRight + in_inLeft);
+        return gateTensor.tensorData[4 * row + col];
+    };
+    // Column-major 4 x 4 matrix M((out_left, in_left), (out_right, in_right)) = A * B, B = S * V^H
+    std::vector<std::complex<double>> opMatrix(16);
+    for (size_t inRight = 0; inRight < 2; ++inRight)
+    {
+        for (size_t outRight = 0; outRight < 2; ++outRight)
+        {
+            for (size_t inLeft = 0; inLeft < 2; ++inLeft)
+            {
+                for (size_t outLeft = 0; outLeft < 2; ++outLeft)
+                {
+                    opMatrix[(outLeft + 2 * inLeft) + 4 * (outRight + 2 * inRight)] = gateElement(outLeft, outRight, inLeft, inRight);
+                }
+            }
+        }
+    }
+    const std::string opTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{4, 4});
+    const std::string opLeftTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{4, 4});
+    const std::string opRightTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{4, 4});
+    const bool opInitialized = exatn::initTensorDataSync(opTensorName, opMatrix);
+    assert(opInitialized);
+    const bool svdOk = exatn::decomposeTensorSVDRSync(opTensorName + "(a,b)=" + opLeftTensorName + "(a,c)*" + opRightTensorName + "(c,b)");
+    assert(svdOk);
+    const auto opLeft = getTensorData(opLeftTensorName);
+    const auto opRight = getTensorData(opRightTensorName);
+    m_tensorPool.releaseScratchTensor(opTensorName);
+    m_tensorPool.releaseScratchTensor(opLeftTensorName);
+    m_tensorPool.releaseScratchTensor(opRightTensorName);
+    // Operator Schmidt rank (e.g. 2 for controlled gates): the rows of B have norms equal to the singular values.
+    std::vector<double> opSingularValues(4, 0.0);
+    for (size_t col = 0; col < 4; ++col)
+    {
+        for (size_t row = 0; row < 4; ++row)
+        {
+            opSingularValues[row] += std::norm(opRight[row + 4 * col]);
+        }
+    }
+    for (auto& val : opSingularValues)
+    {
+        val = std::sqrt(val);
+    }
+    const double maxSingularValue = *std::max_element(opSingularValues.begin(), opSingularValues.end());
+    size_t mpoBondDim = 0;
+    for (const auto& val : opSingularValues)
+    {
+        if (val > 1e-12 * maxSingularValue)
+        {
+            ++mpoBondDim;
+        }
+    }
+    assert(mpoBondDim >= 1);
+
+    // Step 2: apply the MPO string (A_k, delta_k, ..., delta_k, B_k) to the sites [leftSite, rightSite].
+    // The orthogonality center is moved to the left site first: the compression sweeps below are then optimal.
+    moveOrthoCenter(leftSite);
+    exatn::sync();
+    const auto siteShape = [&](size_t in_site, size_t in_leftDim, size_t in_rightDim) {
+        std::vector<exatn::DimExtent> shape;
+        if (in_site > 0)
+        {
+            shape.emplace_back(in_leftDim);
+        }
+        shape.emplace_back(2);
+        if (in_site < nbQubits - 1)
+        {
+            shape.emplace_back(in_rightDim);
+        }
+        return shape;
+    };
+    for (size_t site = leftSite; site <= rightSite; ++site)
+    {
+        const std::string tensorName = "Q" + std::to_string(site);
+        const auto shape = exatn::getTensor(tensorName)->getDimExtents();
+        // Site tensor (left bond, physical, right bond): column-major, a missing (boundary) bond has dimension 1.
+        const size_t leftDim = (site > 0) ? shape.front() : 1;
+        const size_t rightDim = (site < nbQubits - 1) ? shape.back() : 1;
+        const auto siteData = getTensorData(tensorName);
+        // The MPO bond index (k) is the fastest index of the enlarged bonds.
+        const size_t newLeftDim = (site == leftSite) ? leftDim : leftDim * mpoBondDim;
+        const size_t newRightDim = (site == rightSite) ? rightDim : rightDim * mpoBondDim;
+        std::vector<std::complex<double>> newData(newLeftDim * 2 * newRightDim, 0.0);
+        for (size_t k = 0; k < mpoBondDim; ++k)
+        {
+            for (size_t rightIdx = 0; rightIdx < rightDim; ++rightIdx)
+            {
+                for (size_t outPhys = 0; outPhys < 2; ++outPhys)
+                {
+                    for (size_t inPhys = 0; inPhys < 2; ++inPhys)
+                    {
+                        // A_k(out, in) = A((out, in), k), B_k(out, in) = B(k, (out, in)), identity in between.
+                        std::complex<double> opElement;
+                        if (site == leftSite)
+                        {
+                            opElement = opLeft[(outPhys + 2 * inPhys) + 4 * k];
+                        }
+                        else if (site == rightSite)
+                        {
+                            opElement = opRight[k + 4 * (outPhys + 2 * inPhys)];
+                        }
+                        else
+                        {
+                            opElement = (outPhys == inPhys) ? 1.0 : 0.0;
+                        }
+                        if (opElement == 0.0)
+                        {
+                            continue;
+                        }
+                        for (size_t leftIdx = 0; leftIdx < leftDim; ++leftIdx)
+                        {
+                            const size_t newLeftIdx = (site == leftSite) ? leftIdx : (k + mpoBondDim * leftIdx);
+                            const size_t newRightIdx = (site == rightSite) ? rightIdx : (k + mpoBondDim * rightIdx);
+                            newData[newLeftIdx + newLeftDim * (outPhys + 2 * newRightIdx)] += opElement * siteData[leftIdx + leftDim * (inPhys + 2 * rightIdx)];
+                        }
+                    }
+                }
+            }
+        }
+        resetTensor(tensorName, m_elementType, siteShape(site, newLeftDim, newRightDim), newData);
+    }
+
+    // Step 3: compression: isometric sweep (left-to-right), then truncating sweep (right-to-left) back to the left site.
+    for (size_t site = leftSite; site < rightSite; ++site)
+    {
+        shiftOrthoCenterRight(site);
+    }
+    for (size_t site = rightSite; site > leftSite; --site)
+    {
+        shiftOrthoCenterLeft(site, true);
+    }
+    m_orthoCenter = leftSite;
+    rebuildTensorNetwork();
+    const auto gateEnd = std::chrono::system_clock::now();
+    getStatInstance("Long-range Gate (MPO)").addSample(gateStart, gateEnd);
+}
+
+void ExatnMpsVisitor::moveOrthoCenter(size_t in_siteIdx)
+{
+    if (m_orthoCenter == static_cast<int>(in_siteIdx))
+    {
+        return;
+    }
+
+    const auto start = std::chrono::system_clock::now();
+    exatn::sync();
+    if (m_orthoCenter < 0)
+    {
+        // Unknown: sweep from both ends.
+        for (size_t i = 0; i < in_siteIdx; ++i)
+        {
+            shiftOrthoCenterRight(i);
         }
-
-        for (int i = 0; i < q2Shape.size(); ++i)
+        for (size_t i = m_buffer->size() - 1; i > in_siteIdx; --i)
         {
-            if (i != q2BondLegId)
-            {
-                volQ2 *= q2Shape[i];
-            }
+            shiftOrthoCenterLeft(i);
+        }
+    }
+    else
+    {
+        for (size_t i = m_orthoCenter; i < in_siteIdx; ++i)
+        {
+            shiftOrthoCenterRight(i);
         }
+        for (size_t i = m_orthoCenter; i > in_siteIdx; --i)
+        {
+            shiftOrthoCenterLeft(i);
+        }
+    }
+    m_orthoCenter = in_siteIdx;
+    // Bond dimensions may have changed.
+    rebuildTensorNetwork();
+    const auto end = std::chrono::system_clock::now();
+    getStatInstance("Move Orthogonality Center").addSample(start, end);
+}
 
-        const int newBondDim = std::min(volQ1, volQ2);
-        // Update bond dimension
-        q1Shape[q1BondLegId] = newBondDim;
-        q2Shape[q2BondLegId] = newBondDim;
+void ExatnMpsVisitor::shiftOrthoCenterRight(size_t in_siteIdx)
+{
+    // Q(i) = U * (S * V^H) (U is an isometry); Q(i + 1) = (S * V^H) * Q(i + 1)
+    // Q(i) as a matrix: (all other legs) x (right bond, i.e. the last leg).
+    const std::string tensorName = "Q" + std::to_string(in_siteIdx);
+    const std::string nextTensorName = "Q" + std::to_string(in_siteIdx + 1);
+    auto shape = exatn::getTensor(tensorName)->getDimExtents();
+    auto nextShape = exatn::getTensor(nextTensorName)->getDimExtents();
+    const size_t bondDim = shape.back();
+    assert(bondDim == nextShape.front());
+    const size_t nbRows = exatn::getTensor(tensorName)->getVolume() / bondDim;
+    const size_t newBondDim = std::min(nbRows, bondDim);
+    shape.back() = newBondDim;
+    nextShape.front() = newBondDim;
+    const std::string isometryTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(shape), m_elementType);
+    const std::string remainderTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{newBondDim, bondDim}, m_elementType);
+    const std::string newNextTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(nextShape), m_elementType);
+    // Leg labels: site legs (s*), old bond (b) and new bond (c).
+    const std::string siteLegs = getLegLabels("s", shape.size() - 1);
+    const std::string nextLegs = getLegLabels("t", nextShape.size() - 1);
+    decomposeTensorSVDSync(tensorName + "(" + siteLegs + "b)=" + isometryTensorName + "(" + siteLegs + "c)*" + remainderTensorName + "(c,b)",
+                           tensorName, isometryTensorName, remainderTensorName, SvdAbsorption::Right);
+    const bool initialized = exatn::initTensorSync(newNextTensorName, 0.0);
+    assert(initialized);
+    const bool contracted = exatn::contractTensorsSync(newNextTensorName + "(c" + getTrailingLegs(nextLegs) + ")=" + remainderTensorName + "(c,b)*" +
+                                                   nextTensorName + "(b" + getTrailingLegs(nextLegs) + ")", 1.0);
+    assert(contracted);
+    resetTensorFrom(tensorName, m_elementType, shape, isometryTensorName);
+    resetTensorFrom(nextTensorName, m_elementType, nextShape, newNextTensorName);
+    for (const auto& scratchTensorName : { isometryTensorName, remainderTensorName, newNextTensorName })
+    {
+        m_tensorPool.releaseScratchTensor(scratchTensorName);
+    }
+}
 
-        // Destroy old qubit tensors
-        const bool q1Destroyed = exatn::destroyTensor(q1TensorName);
-        assert(q1Destroyed);
-        const bool q2Destroyed = exatn::destroyTensor(q2TensorName);
-        assert(q2Destroyed);
-        exatn::sync(mergedTensor->getName());
+void ExatnMpsVisitor::shiftOrthoCenterLeft(size_t in_siteIdx, bool in_truncate)
+{
+    // Q(i) = (U * S) * V^H (V^H has orthonormal rows); Q(i - 1) = Q(i - 1) * (U * S)
+    // Q(i) as a matrix: (left bond, i.e. the first leg) x (all other legs).
+    const std::string tensorName = "Q" + std::to_string(in_siteIdx);
+    const std::string prevTensorName = "Q" + std::to_string(in_siteIdx - 1);
+    auto shape = exatn::getTensor(tensorName)->getDimExtents();
+    auto prevShape = exatn::getTensor(prevTensorName)->getDimExtents();
+    const size_t bondDim = shape.front();
+    assert(bondDim == prevShape.back());
+    const size_t nbCols = exatn::getTensor(tensorName)->getVolume() / bondDim;
+    if (in_truncate && needsTruncation(std::min(nbCols, bondDim), nbCols, bondDim, in_siteIdx - 1))
+    {
+        // The kept bond dimension depends on the singular values (host-side selection).
+        shiftOrthoCenterLeftTruncated(in_siteIdx);
+        return;
+    }
+    if (in_truncate)
+    {
+        m_truncationInfo.bondDimHistory[in_siteIdx - 1].emplace_back(std::min(nbCols, bondDim));
+    }
 
-        // Create two new tensors:
-        const bool q1Created = exatn::createTensorSync(*m_selfProcessGroup, q1TensorName, exatn::TensorElementType::COMPLEX64, q1Shape);
-        assert(q1Created);
-        
-        const bool q2Created = exatn::createTensorSync(*m_selfProcessGroup, q2TensorName, exatn::TensorElementType::COMPLEX64, q2Shape);
-        assert(q2Created);
-        exatn::sync(q1TensorName);
-        exatn::sync(q2TensorName);
-        exatn::sync(mergedTensor->getName());
-        
+    const size_t newBondDim = std::min(nbCols, bondDim);
+    shape.front() = newBondDim;
+    prevShape.back() = newBondDim;
+    const std::string isometryTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(shape), m_elementType);
+    const std::string remainderTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{bondDim, newBondDim}, m_elementType);
+    const std::string newPrevTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(prevShape), m_elementType);
+    // Leg labels: site legs (s*), old bond (b) and new bond (c).
+    const std::string siteLegs = getLegLabels("s", shape.size() - 1);
+    const std::string prevLegs = getLegLabels("t", prevShape.size() - 1);
+    decomposeTensorSVDSync(tensorName + "(b" + getTrailingLegs(siteLegs) + ")=" + remainderTensorName + "(b,c)*" + isometryTensorName + "(c" + getTrailingLegs(siteLegs) + ")",
+                           tensorName, remainderTensorName, isometryTensorName, SvdAbsorption::Left);
+    const bool initialized = exatn::initTensorSync(newPrevTensorName, 0.0);
+    assert(initialized);
+    const bool contracted = exatn::contractTensorsSync(newPrevTensorName + "(" + prevLegs + "c)=" + prevTensorName + "(" + prevLegs + "b)*" +
+                                                   remainderTensorName + "(b,c)", 1.0);
+    assert(contracted);
+    resetTensorFrom(tensorName, m_elementType, shape, isometryTensorName);
+    resetTensorFrom(prevTensorName, m_elementType, prevShape, newPrevTensorName);
+    for (const auto& scratchTensorName : { isometryTensorName, remainderTensorName, newPrevTensorName })
+    {
+        m_tensorPool.releaseScratchTensor(scratchTensorName);
+    }
+}
+
+void ExatnMpsVisitor::shiftOrthoCenterLeftTruncated(size_t in_siteIdx)
+{
+    // Truncated SVD of the adjoint: Q(i)^H = U * (S * V^H) => Q(i) ~ (V * S) * U^H, keeping the selected bond dimension.
+    // Q(i) as a matrix: (left bond, i.e. the first leg) x (all other legs).
+    const std::string tensorName = "Q" + std::to_string(in_siteIdx);
+    const std::string prevTensorName = "Q" + std::to_string(in_siteIdx - 1);
+    auto shape = exatn::getTensor(tensorName)->getDimExtents();
+    auto prevShape = exatn::getTensor(prevTensorName)->getDimExtents();
+    const size_t bondDim = shape.front();
+    assert(bondDim == prevShape.back());
+    const size_t nbCols = exatn::getTensor(tensorName)->getVolume() / bondDim;
+    const size_t prevNbRows = exatn::getTensor(prevTensorName)->getVolume() / bondDim;
+    const auto tensorData = getTensorData(tensorName);
+    std::vector<std::complex<double>> adjointData(tensorData.size());
+    for (size_t col = 0; col < nbCols; ++col)
+    {
+        for (size_t row = 0; row < bondDim; ++row)
         {
-            // SVD decomposition using the same pattern that was used to merge two tensors
-            // xacc::info("SVD: " + mergeContractionPattern);
-            // mergedTensor->printIt();
-            // exatn::getTensor(q1TensorName)->printIt();
-            // exatn::getTensor(q2TensorName)->printIt();
-            // printTensorData(mergedTensor->getName());
-            const bool svdOk = exatn::decomposeTensorSVDLRSync(mergeContractionPattern);
-            assert(svdOk);
+            adjointData[col + row * nbCols] = std::conj(tensorData[row + col * bondDim]);
         }
-
-        exatn::sync(q1TensorName);
-        exatn::sync(q2TensorName);
-
-        // Validate SVD tensors
-        // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
+    }
+    std::vector<std::complex<double>> qMat;
+    std::vector<std::complex<double>> rMat;
+    const size_t newBondDim = decomposeSiteMatrix(adjointData, nbCols, bondDim, qMat, rMat, in_siteIdx - 1);
+    std::vector<std::complex<double>> newData(newBondDim * nbCols);
+    for (size_t col = 0; col < nbCols; ++col)
+    {
+        for (size_t row = 0; row < newBondDim; ++row)
         {
-            // Validate SVD tensors
-            // TODO: this should be eventually removed once we are confident with the ExaTN numerical backend.
-            const auto calcMpsTensorNorm = [](const std::string& in_tensorName) {
-                double sumNorm = 0.0;
-                const bool normOk = exatn::computeNorm2Sync(in_tensorName, sumNorm);
-                return sumNorm;
-            };
-
-            const double q1NormAfter = calcMpsTensorNorm(q1TensorName);
-            const double q2NormAfter = calcMpsTensorNorm(q2TensorName);
-            if (std::fabs(q1NormAfter) < 1e-3 || std::fabs(q2NormAfter) < 1e-3)
-            {
-                std::cout << "[ERROR] Tensor norm validation failed!\n";
-                std::cout << in_gateInstruction.toString() << "\n";
-                std::cout << q1TensorName << " norm = " << q1NormAfter << "\n";
-                std::cout << q2TensorName << " norm = " << q2NormAfter << "\n";
-                std::cout << "Tensor SVD Pattern: " <<  mergeContractionPattern << "\n";
-                std::cout << "Merged Tensor: \n";
-                printTensorData(mergedTensor->getName());
-                std::cout << q1TensorName << "\n";
-                printTensorData(q1TensorName);
-                std::cout << q2TensorName << "\n";
-                printTensorData(q2TensorName);
-                // Crash in DEBUG to aid debugging.
-                assert(false);
-            }
+            newData[row + col * newBondDim] = std::conj(qMat[col + row * nbCols]);
         }
-        
-        const auto buildTensorMap = [&](){
-            std::map<std::string, std::shared_ptr<exatn::Tensor>> tensorMap;
-            tensorMap.emplace(ROOT_TENSOR_NAME, m_rootTensor);
-            for (int i = 0; i < m_buffer->size(); ++i)
-            {
-                const std::string qTensorName = "Q" + std::to_string(i);
-                tensorMap.emplace(qTensorName, exatn::getTensor(qTensorName));
-            }
-            return tensorMap;
-        };
-        
-        const std::string rootVarNameList = [&](){
-            std::string result = "(";
-            for (int i = 0; i < m_buffer->size() - 1; ++i)
-            {
-                result += ("i" + std::to_string(i) + ",");
-            }
-            result += ("i" + std::to_string(m_buffer->size() - 1) + ")");
-            return result;
-        }();
-        
-        const auto qubitTensorVarNameList = [&](int in_qIdx) -> std::string {
-            if (in_qIdx == 0)
-            {
-                return "(i0,j0)";
-            } 
-            if (in_qIdx == m_buffer->size() - 1)
+    }
+    // Column-major: Q(i - 1) (prevNbRows x bondDim) * (S * V^H)^H (bondDim x newBondDim)
+    const auto prevData = getTensorData(prevTensorName);
+    std::vector<std::complex<double>> newPrevData(prevNbRows * newBondDim, 0.0);
+    for (size_t col = 0; col < newBondDim; ++col)
+    {
+        for (size_t k = 0; k < bondDim; ++k)
+        {
+            const auto lElem = std::conj(rMat[col + k * newBondDim]);
+            for (size_t row = 0; row < prevNbRows; ++row)
             {
-                return "(j" + std::to_string(m_buffer->size() - 2) + ",i" + std::to_string(m_buffer->size() - 1) + ")";
+                newPrevData[row + col * prevNbRows] += prevData[row + k * prevNbRows] * lElem;
             }
+        }
+    }
+    shape.front() = newBondDim;
+    prevShape.back() = newBondDim;
+    resetTensor(tensorName, m_elementType, shape, newData);
+    resetTensor(prevTensorName, m_elementType, prevShape, newPrevData);
+}
 
-            return "(j" + std::to_string(in_qIdx-1) + ",i" + std::to_string(in_qIdx) + ",j" + std::to_string(in_qIdx)+ ")";
-        };
-        
-        const std::string mpsString = [&](){
-            std::string result = ROOT_TENSOR_NAME + rootVarNameList + "=";
-            for (int i = 0; i < m_buffer->size() - 1; ++i)
-            {
-                result += ("Q" + std::to_string(i) + qubitTensorVarNameList(i) + "*");
-            }
-            result += ("Q" + std::to_string(m_buffer->size() - 1) + qubitTensorVarNameList(m_buffer->size() - 1));
-            return result;
-        }();
+int ExatnMpsVisitor::getBondDimLimit() const
+{
+    // Variational compression: gates are applied at the (larger) working bond dimension.
+    return (m_variationalCompression && !m_isCompressing) ? m_workingBondDim : m_maxBondDim;
+}
 
-        // std::cout << "MPS: " << mpsString << "\n";
-        m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap()); 
+void ExatnMpsVisitor::compressIfNeeded(bool in_force)
+{
+    if (!m_variationalCompression || m_isCompressing || m_buffer->size() < 2)
+    {
+        return;
+    }
+    size_t maxBondDim = 0;
+    for (size_t i = 0; i < m_buffer->size() - 1; ++i)
+    {
+        maxBondDim = std::max<size_t>(maxBondDim, exatn::getTensor("Q" + std::to_string(i))->getDimExtents().back());
+    }
+    if (maxBondDim > static_cast<size_t>(m_maxBondDim) &&
+        (in_force || maxBondDim >= static_cast<size_t>(m_workingBondDim)))
+    {
+        compressVariational();
+    }
+}
+
+void ExatnMpsVisitor::compressVariational()
+{
+    const auto start = std::chrono::system_clock::now();
+    const size_t nbQubits = m_buffer->size();
+    m_isCompressing = true;
+
+    // All the site tensors (psi, phi), environments and intermediates stay on the device (ExaTN tensors).
+    const auto siteTensorName = [](size_t in_site) { return "Q" + std::to_string(in_site); };
+    // Site tensor legs (left bond, physical, right bond): the boundary sites have no outer bond.
+    const auto siteLegs = [nbQubits](size_t in_site, const std::string& in_left, const std::string& in_phys, const std::string& in_right) {
+        std::string legs = "(";
+        if (in_site > 0)
         {
-            // Truncate SVD tensors:
-            truncateSvdTensors(q1TensorName, q2TensorName, m_svdCutoff);  
+            legs += in_left + ",";
         }
-        
-        // Rebuild the tensor network since the qubit tensors have been changed after SVD truncation
-        // e.g. we destroy the original tensors and replace with smaller dimension ones
-        m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap());  
-
-        const bool mergedTensorDestroyed = exatn::destroyTensor(mergedTensor->getName());
-        assert(mergedTensorDestroyed);
-
-        // Validate norm:
-        // const auto normVec = computeStateVectorNorm(*m_tensorNetwork, *m_selfProcessGroup);
-        // xacc::info("Norm = " + std::to_string(normVec));
+        legs += in_phys;
+        if (in_site < nbQubits - 1)
+        {
+            legs += "," + in_right;
+        }
+        return legs + ")";
+    };
+    const auto siteShape = [nbQubits](size_t in_site, size_t in_leftDim, size_t in_rightDim) {
+        std::vector<exatn::DimExtent> shape;
+        if (in_site > 0)
+        {
+            shape.emplace_back(in_leftDim);
+        }
+        shape.emplace_back(2);
+        if (in_site < nbQubits - 1)
+        {
+            shape.emplace_back(in_rightDim);
+        }
+        return shape;
+    };
+    // Note: the contractions accumulate into the output tensors, hence zero them first.
+    const auto acquireZeroTensor = [this](const std::vector<exatn::DimExtent>& in_shape) {
+        const std::string tensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(in_shape), m_elementType);
+        const bool initialized = exatn::initTensorSync(tensorName, 0.0);
+        assert(initialized);
+        return tensorName;
+    };
+    const auto contract = [](const std::string& in_pattern) {
+        const bool contracted = exatn::contractTensorsSync(in_pattern, 1.0);
+        assert(contracted);
+    };
+    const auto copy = [](const std::string& in_pattern) {
+        const bool copied = exatn::addTensorsSync(in_pattern, 1.0);
+        assert(copied);
+    };
+    // <in_bra|in_ket> of two tensors with the same legs
+    const auto innerProduct = [&](const std::string& in_bra, const std::string& in_ket, const std::string& in_legs) {
+        const std::string scalarTensorName = acquireZeroTensor({});
+        contract(scalarTensorName + "()=" + in_bra + "+" + in_legs + "*" + in_ket + in_legs);
+        const auto value = getTensorData(scalarTensorName);
+        m_tensorPool.releaseScratchTensor(scalarTensorName);
+        assert(value.size() == 1);
+        return value.front();
     };
 
-    const int q1 = in_gateInstruction.bits()[0];
-    const int q2 = in_gateInstruction.bits()[1];
-    const int qMin = q1 < q2 ? q1 : q2;
-    const int qMax = q1 > q2 ? q1 : q2;
+    // (1) Target MPS (psi): left-canonical form, i.e. the orthogonality center is the last site.
+    moveOrthoCenter(nbQubits - 1);
+    // Bond dimensions: bondDims[i] is the left bond of site i (bondDims[0] = bondDims[N] = 1).
+    std::vector<std::string> psiSites(nbQubits);
+    std::vector<size_t> psiBondDims(nbQubits + 1, 1);
+    for (size_t i = 0; i < nbQubits; ++i)
+    {
+        const auto shape = exatn::getTensor(siteTensorName(i))->getDimExtents();
+        if (i < nbQubits - 1)
+        {
+            psiBondDims[i + 1] = shape.back();
+        }
+        psiSites[i] = acquireZeroTensor(shape);
+        const std::string legs = siteLegs(i, "l", "p", "r");
+        copy(psiSites[i] + legs + "+=" + siteTensorName(i) + legs);
+    }
+    const double psiNorm = std::real(innerProduct(psiSites.back(), psiSites.back(), siteLegs(nbQubits - 1, "l", "p", "r")));
 
-    if (indexInRange(q1, m_qubitRange) && indexInRange(q2, m_qubitRange))
+    // (2) Initial guess (phi, i.e. the site tensors from now on): SVD truncation (right-to-left sweep) to max-bond-dim.
+    const TruncationInfo truncationInfoBefore = m_truncationInfo;
+    for (size_t i = nbQubits - 1; i > 0; --i)
     {
-        // Both qubits in range: process the gate
-        xacc::info("Process [" + std::to_string(m_rank) + "]: Process gate: " + in_gateInstruction.toString());
-        processTwoQubitGate();
+        shiftOrthoCenterLeft(i, true);
     }
-    else if (indexInRange(qMin, m_qubitRange)) 
+    m_orthoCenter = 0;
+    std::vector<size_t> phiBondDims(nbQubits + 1, 1);
+    for (size_t i = 0; i < nbQubits - 1; ++i)
     {
-        // Left qubit in range -> this process will compute the gate
-        // Receive q2 data from next subgroup
-        xacc::info("Process [" + std::to_string(m_rank) + "]: Wait data to process gate: " + in_gateInstruction.toString());
-        // MPI sync here: 
-        // Get tensor data:
-        // Tensor that needs to be received:
-        const std::string qubitTensorName = "Q" + std::to_string(qMax); 
+        phiBondDims[i + 1] = exatn::getTensor(siteTensorName(i))->getDimExtents().back();
+    }
 
-        const bool qMaxDestroyed = exatn::destroyTensor(qubitTensorName);
-        assert(qMaxDestroyed);
-        // Must have right shared group
-        assert(m_rightSharedProcessGroup);
+    // (3) Variational sweeps (single-site fitting): phi is in mixed-canonical form w.r.t. site i,
+    // hence the optimal site tensor is the target MPS contracted with the left and right environments
+    // (<phi|psi> of all the other sites). Environments: (phi bond x psi bond) tensors,
+    // leftEnvs[i]: left bond of site i (none for the first site), rightEnvs[i]: right bond of site i (none for the last site).
+    std::vector<std::string> leftEnvs(nbQubits);
+    std::vector<std::string> rightEnvs(nbQubits);
+    const auto replaceEnv = [this](std::string& io_env, const std::string& in_newEnv) {
+        if (!io_env.empty())
         {
-            unsigned int neighborRank;
-            const bool checkRankPre = m_rightSharedProcessGroup->rankIsIn(m_rank + 1, &neighborRank);
-            assert(checkRankPre);
-            const bool preBroadCastOk = exatn::replicateTensorSync(*m_rightSharedProcessGroup, qubitTensorName, neighborRank);
-            assert(preBroadCastOk);
+            m_tensorPool.releaseScratchTensor(io_env);
         }
-        
-        // Update the tensor network to take into
-        // account the updated tensor.
-        rebuildTensorNetwork();
-        // Now, the *remote* tensor has been initialized, process gate as normal:
-        // Apply gate
-        processTwoQubitGate();
-        // Done: Send tensor to the neighbor process
-        // Send tensor forward
-        auto updatedTensor = exatn::getTensor(qubitTensorName);
+        io_env = in_newEnv;
+    };
+    // Right environment of site i - 1 from the right environment of site i: R'(a,b) = phi+(a,p,c) * psi(b,p,r) * R(c,r)
+    const auto updateRightEnv = [&](size_t in_site) {
+        std::string psiContracted = psiSites[in_site];
+        if (in_site < nbQubits - 1)
+        {
+            psiContracted = acquireZeroTensor({ psiBondDims[in_site], 2, phiBondDims[in_site + 1] });
+            contract(psiContracted + "(b,p,c)=" + psiSites[in_site] + "(b,p,r)*" + rightEnvs[in_site] + "(c,r)");
+        }
+        const std::string newEnv = acquireZeroTensor({ phiBondDims[in_site], psiBondDims[in_site] });
+        contract(newEnv + "(a,b)=" + siteTensorName(in_site) + "+" + siteLegs(in_site, "a", "p", "c") + "*" + psiContracted + siteLegs(in_site, "b", "p", "c"));
+        if (psiContracted != psiSites[in_site])
+        {
+            m_tensorPool.releaseScratchTensor(psiContracted);
+        }
+        replaceEnv(rightEnvs[in_site - 1], newEnv);
+    };
+    // Left environment x psi site: (phi left bond, physical, psi right bond)
+    const auto contractLeftEnv = [&](size_t in_site) {
+        const std::string result = acquireZeroTensor(siteShape(in_site, phiBondDims[in_site], psiBondDims[in_site + 1]));
+        if (in_site == 0)
+        {
+            copy(result + siteLegs(0, "a", "p", "r") + "+=" + psiSites[0] + siteLegs(0, "a", "p", "r"));
+        }
+        else
+        {
+            contract(result + siteLegs(in_site, "a", "p", "r") + "=" + leftEnvs[in_site] + "(a,b)*" + psiSites[in_site] + siteLegs(in_site, "b", "p", "r"));
+        }
+        return result;
+    };
+    // Optimal site tensor: (phi left bond, physical, phi right bond)
+    const auto optimalSite = [&](size_t in_site, const std::string& in_leftContracted) {
+        const std::string result = acquireZeroTensor(siteShape(in_site, phiBondDims[in_site], phiBondDims[in_site + 1]));
+        if (in_site == nbQubits - 1)
+        {
+            copy(result + siteLegs(in_site, "a", "p", "c") + "+=" + in_leftContracted + siteLegs(in_site, "a", "p", "c"));
+        }
+        else
         {
-            unsigned int myLocalRank;
-            const bool checkRankPost = m_rightSharedProcessGroup->rankIsIn(m_rank, &myLocalRank);
-            assert(checkRankPost);
-            const bool postBroadCastOk = exatn::replicateTensorSync(*m_rightSharedProcessGroup, qubitTensorName, 0);
-            assert(postBroadCastOk);
+            contract(result + siteLegs(in_site, "a", "p", "c") + "=" + in_leftContracted + siteLegs(in_site, "a", "p", "r") + "*" + rightEnvs[in_site] + "(c,r)");
         }
+        return result;
+    };
+    // Fidelity |<phi|psi>|^2 / (<phi|phi><psi|psi>) with the orthogonality center at site 0.
+    const auto computeFidelity = [&]() {
+        const std::string leftContracted = contractLeftEnv(0);
+        const std::string optimal = optimalSite(0, leftContracted);
+        const std::string legs = siteLegs(0, "a", "p", "c");
+        const auto overlap = innerProduct(siteTensorName(0), optimal, legs);
+        const double phiNorm = std::real(innerProduct(siteTensorName(0), siteTensorName(0), legs));
+        m_tensorPool.releaseScratchTensor(leftContracted);
+        m_tensorPool.releaseScratchTensor(optimal);
+        return (phiNorm > 0.0 && psiNorm > 0.0) ? std::norm(overlap) / (phiNorm * psiNorm) : 0.0;
+    };
+
+    for (size_t i = nbQubits - 1; i > 0; --i)
+    {
+        updateRightEnv(i);
     }
-    else if (indexInRange(qMax, m_qubitRange))
+    const double svdFidelity = computeFidelity();
+    double fidelity = svdFidelity;
+    for (int sweep = 0; sweep < m_variationalSweeps; ++sweep)
     {
-        // Right qubit in range, delegate the compute:
-        const std::string qubitTensorName = "Q" + std::to_string(qMax); 
-        // Send tensor data to the left
-        xacc::info("Process [" + std::to_string(m_rank) + "]: Send tensor data to process gate: " + in_gateInstruction.toString());
-        // Must have a left shared sub-group
-        assert(m_leftSharedProcessGroup);
+        // Left-to-right: optimize then split off the isometry (the remainder is superseded by the next optimization).
+        for (size_t i = 0; i < nbQubits - 1; ++i)
         {
-            unsigned int myLocalRank;
-            const bool checkRankPre = m_leftSharedProcessGroup->rankIsIn(m_rank, &myLocalRank);
-            assert(checkRankPre);
-            const bool preBroadCastOk = exatn::replicateTensorSync(*m_leftSharedProcessGroup, qubitTensorName, myLocalRank);
-            assert(preBroadCastOk);
+            const std::string leftContracted = contractLeftEnv(i);
+            const std::string optimal = optimalSite(i, leftContracted);
+            const size_t newBondDim = std::min(2 * phiBondDims[i], phiBondDims[i + 1]);
+            const auto newShape = siteShape(i, phiBondDims[i], newBondDim);
+            const std::string isometryTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(newShape), m_elementType);
+            const std::string remainderTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{ newBondDim, phiBondDims[i + 1] }, m_elementType);
+            decomposeTensorSVDSync(optimal + siteLegs(i, "a", "p", "c") + "=" + isometryTensorName + siteLegs(i, "a", "p", "d") + "*" + remainderTensorName + "(d,c)",
+                                   optimal, isometryTensorName, remainderTensorName, SvdAbsorption::Right);
+            phiBondDims[i + 1] = newBondDim;
+            resetTensorFrom(siteTensorName(i), m_elementType, newShape, isometryTensorName);
+            // Left environment of site i + 1: L'(c,r) = phi+(a,p,c) * (L * psi)(a,p,r)
+            const std::string newEnv = acquireZeroTensor({ phiBondDims[i + 1], psiBondDims[i + 1] });
+            contract(newEnv + "(c,r)=" + siteTensorName(i) + "+" + siteLegs(i, "a", "p", "c") + "*" + leftContracted + siteLegs(i, "a", "p", "r"));
+            replaceEnv(leftEnvs[i + 1], newEnv);
+            for (const auto& scratchTensorName : { leftContracted, optimal, isometryTensorName, remainderTensorName })
+            {
+                m_tensorPool.releaseScratchTensor(scratchTensorName);
+            }
         }
+        // Right-to-left: optimize then split off the row isometry.
+        for (size_t i = nbQubits - 1; i > 0; --i)
+        {
+            const std::string leftContracted = contractLeftEnv(i);
+            const std::string optimal = optimalSite(i, leftContracted);
+            const size_t newBondDim = std::min(phiBondDims[i], 2 * phiBondDims[i + 1]);
+            const auto newShape = siteShape(i, newBondDim, phiBondDims[i + 1]);
+            const std::string isometryTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape(newShape), m_elementType);
+            const std::string remainderTensorName = m_tensorPool.acquireScratchTensor(exatn::TensorShape{ phiBondDims[i], newBondDim }, m_elementType);
+            decomposeTensorSVDSync(optimal + siteLegs(i, "a", "p", "c") + "=" + remainderTensorName + "(a,d)*" + isometryTensorName + siteLegs(i, "d", "p", "c"),
+                                   optimal, remainderTensorName, isometryTensorName, SvdAbsorption::Left);
+            phiBondDims[i] = newBondDim;
+            resetTensorFrom(siteTensorName(i), m_elementType, newShape, isometryTensorName);
+            updateRightEnv(i);
+            for (const auto& scratchTensorName : { leftContracted, optimal, isometryTensorName, remainderTensorName })
+            {
+                m_tensorPool.releaseScratchTensor(scratchTensorName);
+            }
+        }
+        {
+            const std::string leftContracted = contractLeftEnv(0);
+            const std::string optimal = optimalSite(0, leftContracted);
+            resetTensorFrom(siteTensorName(0), m_elementType, siteShape(0, 1, phiBondDims[1]), optimal);
+            m_tensorPool.releaseScratchTensor(leftContracted);
+            m_tensorPool.releaseScratchTensor(optimal);
+        }
+        const double newFidelity = computeFidelity();
+        const bool converged = (newFidelity - fidelity) < 1e-10;
+        fidelity = newFidelity;
+        if (converged)
+        {
+            break;
+        }
+    }
 
-        // Update tensor data in this process
-        const bool qMaxDestroyed = exatn::destroyTensor(qubitTensorName);
-        assert(qMaxDestroyed);
-
-        // Wait to receive tensor back (sync)
+    for (const auto& tensorNames : { psiSites, leftEnvs, rightEnvs })
+    {
+        for (const auto& tensorName : tensorNames)
         {
-            unsigned int neighborLocalRank;
-            const bool checkRankPost = m_leftSharedProcessGroup->rankIsIn(m_rank - 1, &neighborLocalRank);
-            assert(checkRankPost);
-            const bool postBroadCastOk = exatn::replicateTensorSync(*m_leftSharedProcessGroup, qubitTensorName, 0);
-            assert(postBroadCastOk);
+            if (!tensorName.empty())
+            {
+                m_tensorPool.releaseScratchTensor(tensorName);
+            }
         }
-        
-        // Update the tensor network to take into
-        // account the updated tensor.
-        rebuildTensorNetwork();
     }
-    else 
+    // The orthogonality center of phi is site 0.
+    m_orthoCenter = 0;
+    rebuildTensorNetwork();
+
+    // The SVD truncation stats (discarded weights) are superseded by the fidelity of the compressed MPS.
+    // Note: bond dimension history of the initial SVD sweep is kept.
+    m_truncationInfo.discardedWeight = truncationInfoBefore.discardedWeight + (1.0 - fidelity);
+    m_truncationInfo.estimatedFidelity = truncationInfoBefore.estimatedFidelity * fidelity;
+    m_isCompressing = false;
     {
-        // Don't care: both tensors are not in range
-        xacc::info("Process [" + std::to_string(m_rank) + "]: Ignore gate: " + in_gateInstruction.toString());
+        std::stringstream logSs;
+        logSs << "[Variational] Compressed MPS fidelity: " << svdFidelity << " (SVD) -> " << fidelity;
+        xacc::info(logSs.str());
     }
-#endif
+    const auto end = std::chrono::system_clock::now();
+    getStatInstance("Variational Compression").addSample(start, end);
 }
 
 void ExatnMpsVisitor::evaluateTensorNetwork(exatn::numerics::TensorNetwork& io_tensorNetwork, std::vector<std::complex<double>>& out_stateVec)
@@ -2098,13 +3590,7 @@ void ExatnMpsVisitor::evaluateTensorNetwork(exatn::numerics::TensorNetwork& io_t
     exatn::sync();
 
     std::function<int(talsh::Tensor& in_tensor)> accessFunc = [&out_stateVec](talsh::Tensor& in_tensor){
-        out_stateVec.reserve(in_tensor.getVolume());
-        std::complex<double> *elements;
-        if (in_tensor.getDataAccessHost(&elements)) 
-        {
-            out_stateVec.assign(elements, elements + in_tensor.getVolume());
-        }
-
+        readTensorBody(in_tensor, out_stateVec);
         return 0;
     };
 
@@ -2208,12 +3694,12 @@ std::vector<uint8_t> ExatnMpsVisitor::getMeasureSample(const std::vector<size_t>
                     {0.0, 0.0}};
 
                 const std::string tensorName = "COLLAPSE_0_" + std::to_string(measIdx);
-                const bool created = exatn::createTensor(tensorName, exatn::TensorElementType::COMPLEX64, exatn::TensorShape{2, 2});
+                const bool created = exatn::createTensor(tensorName, m_elementType, exatn::TensorShape{2, 2});
                 assert(created);
                 tensorsToDestroy.emplace_back(tensorName);
                 const bool registered = exatn::registerTensorIsometry(tensorName, {0}, {1});
                 assert(registered);
-                const bool initialized = exatn::initTensorData(tensorName, COLLAPSE_0);
+                const bool initialized = initTensorBody(tensorName, m_elementType, COLLAPSE_0, false);
                 assert(initialized);
                 tensorIdCounter++;
                 const bool appended = ket.appendTensorGate(tensorIdCounter, exatn::getTensor(tensorName), {qId});
@@ -2230,12 +3716,12 @@ std::vector<uint8_t> ExatnMpsVisitor::getMeasureSample(const std::vector<size_t>
                     {1.0 / resultProbs[measIdx], 0.0}};
 
                 const std::string tensorName = "COLLAPSE_1_" + std::to_string(measIdx);
-                const bool created = exatn::createTensor(tensorName, exatn::TensorElementType::COMPLEX64, exatn::TensorShape{2, 2});
+                const bool created = exatn::createTensor(tensorName, m_elementType, exatn::TensorShape{2, 2});
                 assert(created);
                 tensorsToDestroy.emplace_back(tensorName);
                 const bool registered = exatn::registerTensorIsometry(tensorName, {0}, {1});
                 assert(registered);
-                const bool initialized = exatn::initTensorData(tensorName, COLLAPSE_1);
+                const bool initialized = initTensorBody(tensorName, m_elementType, COLLAPSE_1, false);
                 assert(initialized);
                 tensorIdCounter++;
                 const bool appended = ket.appendTensorGate(tensorIdCounter, exatn::getTensor(tensorName), {qId});
@@ -2263,24 +3749,25 @@ std::vector<uint8_t> ExatnMpsVisitor::getMeasureSample(const std::vector<size_t>
         }
 
         // Evaluate
-        if (exatn::evaluateSync(combinedNetwork)) 
+#ifdef TNQVM_MPI_ENABLED
+        // Each process samples its own share of the shots: evaluate locally.
+        const bool evaluated = exatn::evaluateSync(*m_selfProcessGroup, combinedNetwork);
+#else
+        const bool evaluated = exatn::evaluateSync(combinedNetwork);
+#endif
+        if (evaluated) 
         {
             exatn::sync();
             auto talsh_tensor = exatn::getLocalTensor(combinedNetwork.getTensor(0)->getName());
             const auto tensorVolume = talsh_tensor->getVolume();
             // Single qubit density matrix
             assert(tensorVolume == 4);
-            const std::complex<double>* body_ptr;
-            if (talsh_tensor->getDataAccessHostConst(&body_ptr)) 
-            {
-                resultRDM.assign(body_ptr, body_ptr + tensorVolume);
-            }
+            readTensorBody(*talsh_tensor, resultRDM);
             // Debug: print out RDM data
             {
                 std::cout << "RDM @q" << qubitIdx << " = [";
-                for (int i = 0; i < talsh_tensor->getVolume(); ++i) 
+                for (const auto& element : resultRDM)
                 {
-                    const std::complex<double> element = body_ptr[i];
                     std::cout << element;
                 }
                 std::cout << "]\n";
@@ -2296,7 +3783,7 @@ std::vector<uint8_t> ExatnMpsVisitor::getMeasureSample(const std::vector<size_t>
             assert(std::fabs(1.0 - prob_0 - prob_1) < 1e-12);
 
             // Generate a random number
-            const double randProbPick = generateRandomProbability();
+            const double randProbPick = std::uniform_real_distribution<double>(0.0, 1.0)(m_randomEngine);
             // If radom number < probability of 0 state -> pick zero, and vice versa.
             resultBitString.emplace_back(randProbPick <= prob_0 ? 0 : 1);
             resultProbs.emplace_back(randProbPick <= prob_0 ? prob_0 : prob_1);
@@ -2409,11 +3896,11 @@ void ExatnMpsVisitor::truncateSvdTensors(const std::string& in_leftTensorName, c
         
         // Create two new tensors:
         const std::string newLhsTensorName = in_leftTensorName + "_" + std::to_string(lhsTensor->getTensorHash());
-        const bool newLhsCreated = exatn::createTensorSync(newLhsTensorName, exatn::TensorElementType::COMPLEX64, leftShape);
+        const bool newLhsCreated = exatn::createTensorSync(newLhsTensorName, m_elementType, leftShape);
         assert(newLhsCreated);
 
         const std::string newRhsTensorName = in_rightTensorName + "_" + std::to_string(rhsTensor->getTensorHash());
-        const bool newRhsCreated = exatn::createTensorSync(newRhsTensorName, exatn::TensorElementType::COMPLEX64, rightShape);
+        const bool newRhsCreated = exatn::createTensorSync(newRhsTensorName, m_elementType, rightShape);
         assert(newRhsCreated);
 
         // Take the slices:
@@ -2429,19 +3916,17 @@ void ExatnMpsVisitor::truncateSvdTensors(const std::string& in_leftTensorName, c
         assert(rhsDestroyed);
         
         // Rename new tensors to the old name
-        const auto renameNumericTensor = [](const std::string& oldTensorName, const std::string& newTensorName){
+        const auto renameNumericTensor = [this](const std::string& oldTensorName, const std::string& newTensorName){
             auto tensor = exatn::getTensor(oldTensorName);
             assert(tensor);
-            auto talsh_tensor = exatn::getLocalTensor(oldTensorName); 
+            auto talsh_tensor = exatn::getLocalTensor(oldTensorName);
             assert(talsh_tensor);
-            const std::complex<double>* body_ptr;
-            const bool access_granted = talsh_tensor->getDataAccessHostConst(&body_ptr); 
-            assert(access_granted);
             std::vector<std::complex<double>> newData;
-            newData.assign(body_ptr, body_ptr + talsh_tensor->getVolume());
-            const bool newTensorCreated = exatn::createTensorSync(newTensorName, exatn::TensorElementType::COMPLEX64, tensor->getShape());
+            const bool access_granted = readTensorBody(*talsh_tensor, newData);
+            assert(access_granted);
+            const bool newTensorCreated = exatn::createTensorSync(newTensorName, m_elementType, tensor->getShape());
             assert(newTensorCreated);
-            const bool newTensorInitialized = exatn::initTensorDataSync(newTensorName, newData);
+            const bool newTensorInitialized = initTensorBody(newTensorName, m_elementType, newData);
             assert(newTensorInitialized);
             // Destroy the two original tensor:
             const bool tensorDestroyed = exatn::destroyTensorSync(oldTensorName);
@@ -2459,7 +3944,6 @@ void ExatnMpsVisitor::truncateSvdTensors(const std::string& in_leftTensorName, c
     }
 }
 
-#ifdef TNQVM_MPI_ENABLED
 void ExatnMpsVisitor::rebuildTensorNetwork()
 {
     const auto buildTensorMap = [&](){
@@ -2507,7 +3991,6 @@ void ExatnMpsVisitor::rebuildTensorNetwork()
     }();
     m_tensorNetwork = std::make_shared<exatn::TensorNetwork>(m_tensorNetwork->getName(), mpsString, buildTensorMap()); 
 }
-#endif
 
 std::vector<std::complex<double>> ExatnMpsVisitor::computeWaveFuncSlice(
     const exatn::TensorNetwork& in_tensorNetwork, const std::vector<int>& bitString,
@@ -2524,35 +4007,35 @@ std::vector<std::complex<double>> ExatnMpsVisitor::computeWaveFuncSlice(
       const std::string braQubitName = "QB" + std::to_string(i);
       if (bitVal == 0) {
         const bool created = exatn::createTensor(
-            in_processGroup, braQubitName, exatn::TensorElementType::COMPLEX64,
+            in_processGroup, braQubitName, m_elementType,
             exatn::TensorShape{2});
         assert(created);
         // Bit = 0
-        const bool initialized = exatn::initTensorData(
-            braQubitName,
-            std::vector<std::complex<double>>{{1.0, 0.0}, {0.0, 0.0}});
+        const bool initialized = initTensorBody(
+            braQubitName, m_elementType,
+            std::vector<std::complex<double>>{{1.0, 0.0}, {0.0, 0.0}}, false);
         assert(initialized);
         pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
       } else if (bitVal == 1) {
         const bool created = exatn::createTensor(
-            in_processGroup, braQubitName, exatn::TensorElementType::COMPLEX64,
+            in_processGroup, braQubitName, m_elementType,
             exatn::TensorShape{2});
         assert(created);
         // Bit = 1
-        const bool initialized = exatn::initTensorData(
-            braQubitName,
-            std::vector<std::complex<double>>{{0.0, 0.0}, {1.0, 0.0}});
+        const bool initialized = initTensorBody(
+            braQubitName, m_elementType,
+            std::vector<std::complex<double>>{{0.0, 0.0}, {1.0, 0.0}}, false);
         assert(initialized);
         pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
       } else if (bitVal == -1) {
         // Add an Id tensor
         const bool created = exatn::createTensor(
-            in_processGroup, braQubitName, exatn::TensorElementType::COMPLEX64,
+            in_processGroup, braQubitName, m_elementType,
             exatn::TensorShape{2, 2});
         assert(created);
-        const bool initialized = exatn::initTensorData(
-            braQubitName, std::vector<std::complex<double>>{
-                              {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}});
+        const bool initialized = initTensorBody(
+            braQubitName, m_elementType, std::vector<std::complex<double>>{
+                              {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}}, false);
         assert(initialized);
         pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
         nbOpenLegs++;
@@ -2583,10 +4066,7 @@ std::vector<std::complex<double>> ExatnMpsVisitor::computeWaveFuncSlice(
       exatn::sync();
       auto talsh_tensor =
           exatn::getLocalTensor(combinedTensorNetwork.getTensor(0)->getName());
-      const std::complex<double> *body_ptr;
-      if (talsh_tensor->getDataAccessHostConst(&body_ptr)) {
-        waveFnSlice.assign(body_ptr, body_ptr + talsh_tensor->getVolume());
-      }
+      readTensorBody(*talsh_tensor, waveFnSlice);
     }
   }
   // Destroy bra tensors
@@ -2616,9 +4096,9 @@ double ExatnMpsVisitor::computeStateVectorNorm(const exatn::numerics::TensorNetw
       auto talsh_tensor =
           exatn::getLocalTensor(combinedTensorNetwork.getTensor(0)->getName());
       assert(talsh_tensor->getVolume() ==  1);  
-      const std::complex<double> *body_ptr;
-      if (talsh_tensor->getDataAccessHostConst(&body_ptr)) {
-        norm = *body_ptr;
+      std::vector<std::complex<double>> normData;
+      if (readTensorBody(*talsh_tensor, normData)) {
+        norm = normData[0];
       }
     }
     // std::cout << "Norm: " << norm.real() << " , " << norm.imag() << "\n";
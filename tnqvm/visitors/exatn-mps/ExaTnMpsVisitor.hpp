@@ -2,10 +2,19 @@
 
 #include "TNQVMVisitor.hpp"
 #include "GateTensorAggregator.hpp"
+#include "ExaTnTensorPool.hpp"
 #include "tensor_network.hpp"
+#include <random>
+#include <set>
 
 // MPS visitor:
 // Name: "exatn-mps"
+// Tensor element floating-point precision (float/double) can be specified using:
+// "exatn-mps:float" or "exatn-mps:double"
+// Default is *double* if not provided.
+// In single-precision mode, the MPS tensors (and their contractions) are stored in float
+// while the two-qubit gate decompositions (SVD) are still computed in double (mixed precision).
+// (Hence, with canonical-form = false, the two-qubit gate SVDs are synchronous in single-precision mode.)
 // Supported initialization keys:
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
 // |  Initialization Parameter   |                  Parameter Description                                 |    type     |         default          |
@@ -17,6 +26,52 @@
 // | mpi-communicator            | The MPI communicator to initialize ExaTN runtime with.                 |    void*    | <unused>                 |
 // |                             | If not provided, by default, ExaTN will use `MPI_COMM_WORLD`.          |             |                          |
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | async-gates                 | Submit gates on disjoint sites asynchronously (layer-wise); a site is  |    bool     | true                     |
+// |                             | only synchronized when a later gate conflicts with it. Two-qubit gates |             |                          |
+// |                             | are only submitted asynchronously if canonical-form is false.          |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | canonical-form              | Keep the MPS in mixed-canonical form (tracking its orthogonality       |    bool     | false                    |
+// |                             | center); two-qubit gates are split into an isometry and a remainder    |             |                          |
+// |                             | (ExaTN SVD, on the device) unless truncation is needed.                |             |                          |
+// |                             | Gates are then applied sequentially (async-gates is not used).         |             |                          |
+// |                             | Turned on by fidelity-target, max-mps-memory-mb, long-range-gates and  |             |                          |
+// |                             | variational-compression.                                               |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | agg-width                   | Aggregate gates into blocks of (up to) this number of qubits; each     |    int      | <unused>                 |
+// |                             | block is applied with one merge-and-split sweep (non-MPI only).        |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | fidelity-target             | Target overall fidelity: the truncation error budget is spread across  |    double   | 1.0 (no budget)          |
+// |                             | the bonds as the circuit is simulated (requires canonical-form;        |             |                          |
+// |                             | non-MPI).                                                              |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | max-mps-memory-mb           | Memory cap (MB) of the MPS tensors: bond dimensions are truncated to   |    double   | no limit                 |
+// |                             | stay below this limit (requires canonical-form; non-MPI).              |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | long-range-gates            | Apply two-qubit gates on non-adjacent qubits directly (MPO string)     |    bool     | false                    |
+// |                             | instead of SWAP chains (requires canonical-form; non-MPI, no agg-width)|             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | variational-compression     | Apply gates at a larger bond dimension (variational-bond-dim), then    |    bool     | false                    |
+// |                             | compress the MPS back to max-bond-dim with variational sweeps once a   |             |                          |
+// |                             | bond reaches it (requires max-bond-dim and canonical-form; non-MPI).   |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | variational-bond-dim        | Working bond dimension of variational-compression.                     |    int      | 2 * max-bond-dim         |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | variational-sweeps          | Max number of (left-to-right-to-left) sweeps of each variational       |    int      | 2                        |
+// |                             | compression.                                                           |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | mpi-rebalance-interval      | Number of two-qubit gates between two load-balancing checks of the MPI |    int      | 0                        |
+// |                             | qubit partition: boundary sites are migrated between neighboring ranks |             |                          |
+// |                             | to balance the site costs (bond dimensions) (MPI only, 0 = disabled).  |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | mpi-rebalance-threshold     | Load imbalance (max/mean rank cost) that triggers the rebalancing.     |    double   | 1.25                     |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// Execution info (getExecutionInfo):
+// - "discarded-weight" (double): sum of the discarded weights (squared singular values) of all truncations.
+// - "estimated-fidelity" (double): product of (1 - discarded weight) over all truncations.
+// - "bond-dim-history" (std::map<int, std::vector<int>>): bond index => bond dimension after each update.
+// - "max-pending-sites" (int): max number of sites with gates in flight at the same time (async-gates).
+// - "mpi-initial-partition" (std::vector<int>, MPI only): first qubit of each rank before any rebalancing (empty if one qubit per rank).
+// - "mpi-rebalance-events" (std::map<int, std::vector<int>>, MPI only): two-qubit gate count => first qubit of each rank after rebalancing.
 
 namespace tnqvm {
 class ExatnMpsVisitor : public TNQVMVisitor, public IAggregatorListener
@@ -33,6 +88,9 @@ public:
     virtual const std::string name() const override { return "exatn-mps"; }
     virtual const std::string description() const override { return "ExaTN MPS Visitor"; }
     virtual std::shared_ptr<TNQVMVisitor> clone() override { return std::make_shared<ExatnMpsVisitor>(); }
+    virtual bool supportLongRangeGates() const override { return m_longRangeGates; }
+    // Element type of the MPS tensors
+    virtual exatn::TensorElementType getExatnElementType() const { return exatn::TensorElementType::COMPLEX64; }
 
     // one-qubit gates
     virtual void visit(Identity& in_IdentityGate) override;
@@ -55,6 +113,8 @@ public:
     virtual void visit(fSim& in_fsimGate) override;
     // others
     virtual void visit(Measure& in_MeasureGate) override;
+    // Generic k-qubit gate: applied as a block operator on the range of sites spanned by the qubits.
+    virtual void applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix) override;
 
     virtual const double getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function) override;
     virtual void onFlush(const AggregatedGroup& in_group) override;
@@ -81,6 +141,64 @@ private:
     void addMeasureBitStringProbability(const std::vector<size_t>& in_bits, const std::vector<std::complex<double>>& in_stateVec, int in_shotCount);
     void applyGate(xacc::Instruction& in_gateInstruction);
     void applyTwoQubitGate(xacc::Instruction& in_gateInstruction);
+    // Submits the merge/contract/SVD pipeline of a two-qubit gate without waiting for its completion.
+    // Gates on disjoint sites (i.e. a circuit layer) are thus processed concurrently by the ExaTN runtime.
+    void submitTwoQubitGate(xacc::Instruction& in_gateInstruction);
+    // Waits for all the submitted two-qubit gates, then truncates their SVD bonds.
+    // Called when a gate touches a site that is still in flight (and before any evaluation of the MPS).
+    void syncTwoQubitGates();
+    // Waits for the single-qubit gates in flight on a site (if any) and releases their scratch tensors.
+    void syncSingleQubitGates(size_t in_site);
+    // Merges the two site tensors of a two-qubit gate and contracts the gate tensor in (asynchronously).
+    // Returns the (scratch) merged and result tensor names; out_svdPattern is the pattern to split the result tensor.
+    std::pair<std::string, std::string> submitTwoQubitGateContraction(xacc::Instruction& in_gateInstruction, std::string& out_svdPattern);
+    // Where the singular values of an SVD split go: left factor, right factor or both (square roots).
+    enum class SvdAbsorption { Left, Right, Both };
+    // Mixed precision (single-precision MPS): runs the SVD split in_svdPattern ("Result(..)=Left(..)*Right(..)")
+    // on double-precision copies of its tensors, then writes the factors back into the (already created) Left and Right tensors.
+    void decomposeTensorSVDInDouble(const std::string& in_svdPattern, const std::string& in_resultTensorName,
+                                    const std::string& in_leftTensorName, const std::string& in_rightTensorName,
+                                    SvdAbsorption in_absorption = SvdAbsorption::Both);
+    // SVD split in_svdPattern of existing tensors on the device (synchronous), in double precision if needed.
+    void decomposeTensorSVDSync(const std::string& in_svdPattern, const std::string& in_resultTensorName,
+                                const std::string& in_leftTensorName, const std::string& in_rightTensorName, SvdAbsorption in_absorption);
+    // Canonical form: moves the orthogonality center to the left site of the gate,
+    // then splits the two-site tensor into an isometry and a remainder on the device (no truncation needed)
+    // or with a truncated SVD (locally optimal truncation).
+    // The orthogonality center is the right site afterward.
+    void applyTwoQubitGateCanonical(xacc::Instruction& in_gateInstruction);
+    // Long-range two-qubit gate (canonical form): the gate is decomposed (operator Schmidt decomposition)
+    // into an MPO string spanning the sites in between, which is applied to the MPS then compressed
+    // with one isometric (left-to-right) and one truncating (right-to-left) sweep.
+    void applyLongRangeGate(xacc::Instruction& in_gateInstruction);
+    // Moves the orthogonality center to the given site (sweeps of isometric splits).
+    void moveOrthoCenter(size_t in_siteIdx);
+    // Moves the orthogonality center from site i to site i + 1 (or i - 1).
+    // The site tensor is split (ExaTN SVD, on the device) into an isometry and a remainder,
+    // which is contracted into the neighboring site tensor.
+    void shiftOrthoCenterRight(size_t in_siteIdx);
+    // If in_truncate, the bond is truncated (SVD) as needed while shifting left.
+    void shiftOrthoCenterLeft(size_t in_siteIdx, bool in_truncate = false);
+    // Left shift that truncates the bond (the kept bond dimension is selected from the singular values on the host).
+    void shiftOrthoCenterLeftTruncated(size_t in_siteIdx);
+    // Block (TEBD-style) gate: contracts the gates (acting on a contiguous range of sites) into a single operator,
+    // then applies it to the merged site tensors and splits them back with one left-to-right sweep.
+    void applyBlockGate(const std::vector<size_t>& in_sites, const std::vector<xacc::Instruction*>& in_gates);
+    // Applies a (2^w x 2^w) operator, first site is the most significant bit, to the contiguous sites:
+    // merges the site tensors, applies the operator then splits them back (sequential SVD splits).
+    void applyBlockOperator(const std::vector<size_t>& in_sites, const std::vector<std::vector<std::complex<double>>>& in_op);
+    // Splits a (column-major) matrix into left (isometry) and right factors (ExaTN SVD, truncated if needed)
+    // across bond in_bondIdx, i.e. between site in_bondIdx and in_bondIdx + 1. Returns the bond dimension.
+    size_t decomposeSiteMatrix(const std::vector<std::complex<double>>& in_matrix, size_t in_rows, size_t in_cols,
+                               std::vector<std::complex<double>>& out_left, std::vector<std::complex<double>>& out_right, size_t in_bondIdx);
+    // Is truncation (SVD) required for this split?
+    bool needsTruncation(size_t in_fullBondDim, size_t in_rows, size_t in_cols, size_t in_bondIdx) const;
+    // Max bond dimension so that the MPS stays below the memory cap after splitting bond in_bondIdx
+    // into (in_rows x chi) and (chi x in_cols) site tensors.
+    size_t getMemoryBoundBondDim(size_t in_rows, size_t in_cols, size_t in_bondIdx) const;
+    // Selects the bond dimension to keep (cut-off, fidelity budget, max bond dimension and memory cap)
+    // given the (descending) singular values of the bond, and records the truncation stats.
+    size_t selectBondDim(const std::vector<double>& in_singularValues, size_t in_rows, size_t in_cols, size_t in_bondIdx);
     // Get a sample measurement bit string:
     // In this function, we get RDM by opening one qubit line at a time (same order as the provided list).
     // Then, we contract the whole tensor network to get the RDM for that qubit.
@@ -92,6 +210,18 @@ private:
     void truncateSvdTensors(const std::string& in_leftTensorName, const std::string& in_rightTensorName, double in_eps = std::numeric_limits<double>::min());
     std::vector<std::complex<double>> computeWaveFuncSlice(const exatn::numerics::TensorNetwork& in_tensorNetwork, const std::vector<int>& bitString, const exatn::ProcessGroup& in_processGroup) const; 
     double computeStateVectorNorm(const exatn::numerics::TensorNetwork& in_tensorNetwork, const exatn::ProcessGroup& in_processGroup) const; 
+    // Rebuild the tensor network (m_tensorNetwork) from individual MPS tensors:
+    // e.g. after bond dimension changes.
+    void rebuildTensorNetwork();
+    // Bond dimension limit of the current truncation:
+    // max-bond-dim, or the working bond dimension while applying gates with variational compression.
+    int getBondDimLimit() const;
+    // Variational compression: compresses the MPS if a bond has reached the working bond dimension
+    // (or if in_force, e.g. before measurement, if any bond is larger than max-bond-dim).
+    void compressIfNeeded(bool in_force);
+    // Compresses the MPS to max-bond-dim: SVD truncation (initial guess) then single-site
+    // variational sweeps maximizing the overlap with the uncompressed MPS.
+    void compressVariational();
 
 private:
     TensorAggregator m_aggregator;
@@ -108,10 +238,50 @@ private:
     bool m_aggregateEnabled; 
     double m_svdCutoff;
     int m_maxBondDim;
+    struct PendingTwoQubitGate
+    {
+        std::string q1TensorName;
+        std::string q2TensorName;
+        std::string gateDescription;
+        // Scratch tensors (from m_tensorPool) reserved by this gate
+        std::vector<std::string> scratchTensorNames;
+    };
+    // Two-qubit gates that have been submitted but not synchronized yet.
+    std::vector<PendingTwoQubitGate> m_pendingTwoQubitGates;
+    // Qubit sites touched by the pending two-qubit gates.
+    std::unordered_set<size_t> m_pendingSites;
+    // Single-qubit gates that have been submitted but not synchronized yet:
+    // site => scratch tensors (from m_tensorPool) holding the gate contraction results.
+    std::unordered_map<size_t, std::vector<std::string>> m_pendingSingleQubitGates;
+    // Max number of sites with gates in flight (execution info)
+    size_t m_maxPendingSites;
+    bool m_asyncTwoQubitGates;
+    // Max number of gate tensors to keep in m_tensorPool
+    static constexpr size_t MAX_CACHED_GATE_TENSORS = 256;
+    // Reusable scratch and gate tensors
+    ExaTnTensorPool m_tensorPool;
+    bool m_canonicalForm;
+    // Site of the orthogonality center (-1: unknown, i.e. not in canonical form)
+    int m_orthoCenter;
+    double m_fidelityTarget;
+    double m_maxMemoryMb;
+    exatn::TensorElementType m_elementType;
+    bool m_longRangeGates;
+    bool m_variationalCompression;
+    int m_workingBondDim;
+    int m_variationalSweeps;
+    // Set during compressVariational (truncate to max-bond-dim)
+    bool m_isCompressing;
+    struct TruncationInfo
+    {
+        double discardedWeight = 0.0;
+        double estimatedFidelity = 1.0;
+        std::map<int, std::vector<int>> bondDimHistory;
+    };
+    TruncationInfo m_truncationInfo;
+    // Random engine of the measurement sampling
+    std::mt19937_64 m_randomEngine;
 #ifdef TNQVM_MPI_ENABLED
-    // Rebuild the tensor network (m_tensorNetwork) from individual MPS tensors:
-    // e.g. after bond dimension changes.
-    void rebuildTensorNetwork();
     // Min-max qubit range (inclusive) that this process handles 
     std::pair<size_t, size_t> m_qubitRange;
     // The self process group that the current process belongs to.
@@ -123,6 +293,47 @@ private:
     size_t m_rank;
     // Map from qubit indices to MPI rank which owns the qubit tensor.
     std::unordered_map<size_t, size_t> m_qubitIdxToRank;
+    // First qubit index of each rank (contiguous partition),
+    // empty if each qubit is handled by one process.
+    std::vector<size_t> m_rankFirstSites;
+    // Load-balancing of the qubit partition:
+    int m_rebalanceInterval;
+    double m_rebalanceThreshold;
+    size_t m_twoQubitGateCount;
+    std::vector<int> m_initialPartition;
+    std::map<int, std::vector<int>> m_rebalanceEvents;
+    // Gathers the measurement samples of all processes (in shot order) to the buffer of rank 0.
+    // Collective: must be called by all processes.
+    void gatherMeasureSamples(const std::vector<std::vector<uint8_t>>& in_localSamples, size_t in_firstShot, size_t in_totalShots);
+    // Boundary qubit tensors currently lent by their owner to the left neighbor process
+    // (to compute gates across the boundary), tracked by all processes.
+    std::set<size_t> m_lentSites;
+    // Returns true if this process holds the (up-to-date) tensor of the given qubit.
+    bool isHoldingSite(size_t in_siteIdx) const;
+    // Sends a boundary qubit tensor from its owner to the left neighbor process, or back.
+    // Collective: must be called by all processes (only the pair of neighbors communicates).
+    void lendSite(size_t in_siteIdx);
+    void returnLentSite(size_t in_siteIdx);
+    void returnAllLentSites();
+    // Sets the qubit partition (m_qubitRange and m_qubitIdxToRank) from the first qubit index of each rank.
+    void updateQubitPartition(const std::vector<size_t>& in_rankFirstSites);
+    // Migrates boundary sites between neighboring ranks if the site costs (tensor volumes) are imbalanced.
+    // Collective: must be called by all processes.
+    void rebalanceQubitPartition();
 #endif
 };
+
+class DoublePrecisionExatnMpsVisitor : public ExatnMpsVisitor
+{
+    virtual const std::string name() const override { return "exatn-mps:double"; }
+    virtual exatn::TensorElementType getExatnElementType() const override { return exatn::TensorElementType::COMPLEX64; }
+    virtual std::shared_ptr<TNQVMVisitor> clone() override { return std::make_shared<DoublePrecisionExatnMpsVisitor>(); }
+};
+
+class SinglePrecisionExatnMpsVisitor : public ExatnMpsVisitor
+{
+    virtual const std::string name() const override { return "exatn-mps:float"; }
+    virtual exatn::TensorElementType getExatnElementType() const override { return exatn::TensorElementType::COMPLEX32; }
+    virtual std::shared_ptr<TNQVMVisitor> clone() override { return std::make_shared<SinglePrecisionExatnMpsVisitor>(); }
+};
 } 
\ No newline at end of file
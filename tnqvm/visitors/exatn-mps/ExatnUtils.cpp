@@ -1,17 +1,28 @@
 #include "ExatnUtils.hpp"
 #include "base/Gates.hpp"
+#include <cassert>
+#include <cmath>
+
+namespace {
+// Shape (2, ..., 2) and isometry ({0, ..., k - 1}, {k, ..., 2k - 1}) of a k-qubit gate tensor.
+void setGateTensorLegs(tnqvm::GateTensor& io_tensor, size_t in_nbQubits)
+{
+    io_tensor.tensorShape.assign(2 * in_nbQubits, 2);
+    io_tensor.tensorIsometry.first.clear();
+    io_tensor.tensorIsometry.second.clear();
+    for (unsigned int i = 0; i < in_nbQubits; ++i)
+    {
+        io_tensor.tensorIsometry.first.emplace_back(i);
+        io_tensor.tensorIsometry.second.emplace_back(in_nbQubits + i);
+    }
+}
+}
 
 namespace tnqvm {
 GateTensor GateTensorConstructor::getGateTensor(xacc::Instruction& in_gate)
 {
     GateTensor resultTensor;
-    static const std::vector<int> SINGLE_QUBIT_SHAPE{2, 2};
-    static const std::vector<int> TWO_QUBIT_SHAPE{2, 2, 2, 2};
-    static const std::pair<std::vector<unsigned int>,  std::vector<unsigned int>> SINGLE_QUBIT_ISO{{0}, {1}};
-    static const std::pair<std::vector<unsigned int>,  std::vector<unsigned int>> TWO_QUBIT_ISO{{0, 1}, {2, 3}};
-    
-    resultTensor.tensorShape = (in_gate.nRequiredBits() == 1 ? SINGLE_QUBIT_SHAPE : TWO_QUBIT_SHAPE);
-    resultTensor.tensorIsometry = (in_gate.nRequiredBits() == 1 ? SINGLE_QUBIT_ISO : TWO_QUBIT_ISO);
+    setGateTensorLegs(resultTensor, in_gate.nRequiredBits());
     
     const auto generateGateName = [](xacc::Instruction& in_quantumGate)->std::string {
         if (in_quantumGate.getParameters().empty())
@@ -55,6 +66,8 @@ GateTensor GateTensorConstructor::getGateTensor(xacc::Instruction& in_gate)
             case CommonGates::X: return GetGateMatrix<CommonGates::X>();
             case CommonGates::Y: return GetGateMatrix<CommonGates::Y>();
             case CommonGates::Z: return GetGateMatrix<CommonGates::Z>();
+            case CommonGates::S: return GetGateMatrix<CommonGates::S>();
+            case CommonGates::Sdg: return GetGateMatrix<CommonGates::Sdg>();
             case CommonGates::T: return GetGateMatrix<CommonGates::T>();
             case CommonGates::Tdg:
               return GetGateMatrix<CommonGates::Tdg>();
@@ -65,10 +78,17 @@ GateTensor GateTensorConstructor::getGateTensor(xacc::Instruction& in_gate)
                   in_gate.getParameter(2).as<double>());
             case CommonGates::CNOT:
               return GetGateMatrix<CommonGates::CNOT>();
+            case CommonGates::CZ: return GetGateMatrix<CommonGates::CZ>();
+            case CommonGates::CPhase: return GetGateMatrix<CommonGates::CPhase>(in_gate.getParameter(0).as<double>());
+            case CommonGates::CY: return GetGateMatrix<CommonGates::CY>();
+            case CommonGates::CH: return GetGateMatrix<CommonGates::CH>();
+            case CommonGates::CRZ: return GetGateMatrix<CommonGates::CRZ>(in_gate.getParameter(0).as<double>());
             case CommonGates::Swap: return GetGateMatrix<CommonGates::Swap>();
             case CommonGates::iSwap: return GetGateMatrix<CommonGates::iSwap>();
             case CommonGates::fSim: return GetGateMatrix<CommonGates::fSim>(in_gate.getParameter(0).as<double>(), in_gate.getParameter(1).as<double>());
-            default: return GetGateMatrix<CommonGates::I>();
+            default:
+              xacc::error("Gate '" + in_gate.name() + "' has no gate tensor.");
+              return GetGateMatrix<CommonGates::I>();
         }
     };
     
@@ -90,4 +110,32 @@ GateTensor GateTensorConstructor::getGateTensor(xacc::Instruction& in_gate)
 
     return resultTensor;
 }
-}
\ No newline at end of file
+
+GateTensor GateTensorConstructor::getGateTensor(const std::string& in_name, const std::vector<std::vector<std::complex<double>>>& in_matrix)
+{
+    size_t nbQubits = 0;
+    while ((1ULL << nbQubits) < in_matrix.size())
+    {
+        ++nbQubits;
+    }
+    if (nbQubits == 0 || (1ULL << nbQubits) != in_matrix.size())
+    {
+        xacc::error("Invalid gate matrix: the dimension must be a power of two.");
+    }
+
+    GateTensor resultTensor;
+    resultTensor.uniqueName = in_name;
+    setGateTensorLegs(resultTensor, nbQubits);
+    resultTensor.tensorData.reserve(in_matrix.size() * in_matrix.size());
+    for (const auto& row : in_matrix)
+    {
+        if (row.size() != in_matrix.size())
+        {
+            xacc::error("Invalid gate matrix: the matrix must be square.");
+        }
+        resultTensor.tensorData.insert(resultTensor.tensorData.end(), row.begin(), row.end());
+    }
+    return resultTensor;
+}
+
+}
@@ -19,6 +19,9 @@ public:
     const std::string name() const override { return "default"; }
     const std::string description() const override { return ""; }
     static GateTensor getGateTensor(xacc::Instruction& in_gate);
+    // Generic k-qubit gate tensor (rank 2k) from a (2^k x 2^k) unitary matrix,
+    // in_matrix basis: the first qubit is the most significant bit.
+    static GateTensor getGateTensor(const std::string& in_name, const std::vector<std::vector<std::complex<double>>>& in_matrix);
 };
 
 // Stat utilities
@@ -63,6 +63,9 @@ public:
         {
             flush(m_pendingGroup);
         }
+        // All qubit lines are free again (e.g. more gates can be added after an intermediate flush).
+        m_qubitToGroup.clear();
+        m_pendingGroup = AggregatedGroup();
     }
 
 private:
@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 #include "xacc.hpp"
 #include "xacc_service.hpp"
+#include "TNQVMVisitor.hpp"
 
 
 TEST(MpsGateTester, checkSimple) 
@@ -498,6 +499,205 @@ TEST(MpsGateTester, testGrover)
     // } 
 }
 
+// Two-qubit gates on disjoint sites (one circuit layer) are processed concurrently.
+TEST(MpsGateTester, checkAsyncGateLayer) 
+{
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testBellPairs(qbit q) {
+        H(q[0]);
+        H(q[2]);
+        H(q[4]);
+        CNOT(q[0], q[1]);
+        CNOT(q[2], q[3]);
+        CNOT(q[4], q[5]);
+        Swap(q[1], q[2]);
+        Swap(q[3], q[4]);
+        Swap(q[1], q[2]);
+        Swap(q[3], q[4]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+        Measure(q[4]);
+        Measure(q[5]);
+    })", nullptr);
+
+    for (const bool asyncGates : { true, false })
+    {
+        auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("shots", 1000), std::make_pair("async-gates", asyncGates)});
+        auto qubitReg = xacc::qalloc(6);
+        accelerator->execute(qubitReg, ir->getComposites()[0]);
+        qubitReg->print();
+        // Three Bell pairs: (0, 1), (2, 3), (4, 5)
+        const auto measurements = qubitReg->getMeasurementCounts();
+        EXPECT_EQ(measurements.size(), 8);
+        for (const auto& [bitString, count] : measurements)
+        {
+            EXPECT_EQ(bitString[0], bitString[1]);
+            EXPECT_EQ(bitString[2], bitString[3]);
+            EXPECT_EQ(bitString[4], bitString[5]);
+        }
+        // Asynchronous: the three CNOT gates of the layer are in flight together (six sites)
+        // until the Swap gates force the layer synchronization.
+        const int maxPendingSites = accelerator->getExecutionInfo().get<int>("max-pending-sites");
+        if (asyncGates)
+        {
+            EXPECT_EQ(maxPendingSites, 6);
+        }
+        else
+        {
+            EXPECT_LE(maxPendingSites, 2);
+        }
+    }
+
+    // Single-qubit gates on disjoint sites stay pending until the final synchronization.
+    auto singleQubitIr = xasmCompiler->compile(R"(__qpu__ void testSingleQubitLayer(qbit q) {
+        H(q[0]);
+        X(q[1]);
+        H(q[2]);
+        Rx(q[3], 0.5);
+        H(q[3]);
+        Y(q[4]);
+        Measure(q[1]);
+    })", nullptr);
+    for (const bool asyncGates : { true, false })
+    {
+        auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("shots", 100), std::make_pair("async-gates", asyncGates)});
+        auto qubitReg = xacc::qalloc(5);
+        accelerator->execute(qubitReg, singleQubitIr->getComposites()[0]);
+        const auto measurements = qubitReg->getMeasurementCounts();
+        ASSERT_EQ(measurements.size(), 1);
+        EXPECT_EQ(measurements.begin()->first, "1");
+        EXPECT_EQ(accelerator->getExecutionInfo().get<int>("max-pending-sites"), asyncGates ? 5 : 0);
+    }
+}
+
+// Aggregated (block) gates must give the same state as gate-by-gate application.
+TEST(MpsGateTester, checkBlockGates) 
+{
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testBlockGates(qbit q) {
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        Rx(q[2], 0.3);
+        CNOT(q[1], q[2]);
+        Ry(q[4], 1.2);
+        CNOT(q[4], q[3]);
+        CNOT(q[2], q[3]);
+        H(q[1]);
+        CNOT(q[3], q[4]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+        Measure(q[4]);
+    })", nullptr);
+
+    auto referenceAcc = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps")});
+    auto referenceReg = xacc::qalloc(5);
+    referenceAcc->execute(referenceReg, ir->getComposites()[0]);
+    const double expectedExpVal = referenceReg->getExpectationValueZ();
+    for (const int aggWidth : { 2, 3, 4 })
+    {
+        auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("agg-width", aggWidth)});
+        auto qubitReg = xacc::qalloc(5);
+        accelerator->execute(qubitReg, ir->getComposites()[0]);
+        EXPECT_NEAR(qubitReg->getExpectationValueZ(), expectedExpVal, 1e-6);
+    }
+}
+
+// Single-precision MPS tensors (mixed-precision decompositions) must agree with the double-precision result.
+TEST(MpsGateTester, checkSinglePrecision) 
+{
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testSinglePrecision(qbit q) {
+        H(q[0]);
+        Ry(q[1], 0.7);
+        CNOT(q[0], q[1]);
+        Rx(q[2], 1.1);
+        CNOT(q[1], q[2]);
+        CZ(q[2], q[3]);
+        H(q[3]);
+        CNOT(q[3], q[4]);
+        Rz(q[4], 0.4);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+        Measure(q[4]);
+    })", nullptr);
+
+    auto doubleAcc = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps:double")});
+    auto doubleReg = xacc::qalloc(5);
+    doubleAcc->execute(doubleReg, ir->getComposites()[0]);
+    for (const bool canonicalForm : { true, false })
+    {
+        auto floatAcc = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps:float"), std::make_pair("canonical-form", canonicalForm)});
+        auto floatReg = xacc::qalloc(5);
+        floatAcc->execute(floatReg, ir->getComposites()[0]);
+        EXPECT_NEAR(floatReg->getExpectationValueZ(), doubleReg->getExpectationValueZ(), 1e-4);
+    }
+}
+
+// Long-range gates applied as MPO strings must match the SWAP-chain (nearest-neighbor transform) result.
+TEST(MpsGateTester, checkLongRangeGates) 
+{
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testLongRangeGates(qbit q) {
+        H(q[0]);
+        Ry(q[2], 0.8);
+        CNOT(q[0], q[4]);
+        Rx(q[3], 1.3);
+        CZ(q[3], q[0]);
+        CPhase(q[1], q[5], 0.6);
+        H(q[5]);
+        Swap(q[5], q[2]);
+        CNOT(q[4], q[1]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+        Measure(q[4]);
+        Measure(q[5]);
+    })", nullptr);
+
+    auto referenceAcc = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps")});
+    auto referenceReg = xacc::qalloc(6);
+    referenceAcc->execute(referenceReg, ir->getComposites()[0]);
+    auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("long-range-gates", true)});
+    auto qubitReg = xacc::qalloc(6);
+    accelerator->execute(qubitReg, ir->getComposites()[0]);
+    EXPECT_NEAR(qubitReg->getExpectationValueZ(), referenceReg->getExpectationValueZ(), 1e-6);
+}
+
+TEST(MpsGateTester, checkGenericGateMatrix) 
+{
+    // Toffoli gate as an 8x8 matrix (first qubit is the MSB)
+    std::vector<std::vector<std::complex<double>>> toffoliMat(8, std::vector<std::complex<double>>(8, 0.0));
+    for (size_t i = 0; i < 6; ++i)
+    {
+        toffoliMat[i][i] = 1.0;
+    }
+    toffoliMat[6][7] = 1.0;
+    toffoliMat[7][6] = 1.0;
+
+    auto gateRegistry = xacc::getIRProvider("quantum");
+    auto visitor = xacc::getService<tnqvm::TNQVMVisitor>("exatn-mps")->clone();
+    auto qubitReg = xacc::qalloc(5);
+    visitor->initialize(qubitReg, -1);
+    gateRegistry->createInstruction("X", std::vector<std::size_t>{0})->accept(visitor);
+    gateRegistry->createInstruction("X", std::vector<std::size_t>{2})->accept(visitor);
+    // Non-adjacent qubits (identity on q1), target (q3) is the LSB.
+    visitor->applyGateMatrix({ 0, 2, 3 }, toffoliMat);
+    // Unsorted qubits: controls q3, q4 (not set), target q1.
+    visitor->applyGateMatrix({ 3, 4, 1 }, toffoliMat);
+    gateRegistry->createInstruction("Measure", std::vector<std::size_t>{3})->accept(visitor);
+    gateRegistry->createInstruction("Measure", std::vector<std::size_t>{4})->accept(visitor);
+    visitor->finalize();
+    // q3 = 1, q4 = 0
+    EXPECT_NEAR(qubitReg->getExpectationValueZ(), -1.0, 1e-9);
+}
+
 int main(int argc, char **argv) 
 {
   xacc::Initialize();
@@ -83,6 +83,53 @@ TEST(MpsOverMpiTester, checkSimple)
     }
 }
 
+TEST(MpsOverMpiTester, checkRebalance) 
+{    
+    // Rebalance after every two-qubit gate (any imbalance):
+    // the edge sites are cheaper than the bulk ones, hence boundary sites are migrated.
+    auto qpu = xacc::getAccelerator("tnqvm", { std::make_pair("tnqvm-visitor", "exatn-mps"), 
+                                               std::make_pair("shots", 1000),
+                                               std::make_pair("mpi-rebalance-interval", 1), 
+                                               std::make_pair("mpi-rebalance-threshold", 1.0) });
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testGhzRebalance(qbit q) {
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        CNOT(q[1], q[2]);
+        CNOT(q[2], q[3]);
+        CNOT(q[3], q[4]);
+        CNOT(q[4], q[5]);
+        CNOT(q[5], q[6]);
+        CNOT(q[6], q[7]);
+        for (int i = 0; i < 8; i++) {
+            Measure(q[i]);
+        }
+    })", nullptr);
+    auto qubitReg = xacc::qalloc(8);
+    auto program = ir->getComposites()[0];   
+    qpu->execute(qubitReg, program);
+    // All processes record the same rebalance events.
+    const auto exeInfo = qpu->getExecutionInfo();
+    const auto initialPartition = exeInfo.get<std::vector<int>>("mpi-initial-partition");
+    const auto rebalanceEvents = exeInfo.get<std::map<int, std::vector<int>>>("mpi-rebalance-events");
+    EXPECT_FALSE(initialPartition.empty());
+    ASSERT_FALSE(rebalanceEvents.empty());
+    // The first rebalance must have moved (at least) one partition boundary.
+    EXPECT_NE(rebalanceEvents.begin()->second, initialPartition);
+    for (const auto& [gateCount, rankFirstSites] : rebalanceEvents)
+    {
+        EXPECT_EQ(rankFirstSites.size(), initialPartition.size());
+        EXPECT_EQ(rankFirstSites.front(), 0);
+    }
+    // Only rank 0 process has measurements.
+    if (!qubitReg->getMeasurements().empty())
+    {
+        EXPECT_EQ(qubitReg->getMeasurementCounts().size(), 2);
+        EXPECT_NEAR(qubitReg->computeMeasurementProbability("00000000"), 0.5, 0.1);
+        EXPECT_NEAR(qubitReg->computeMeasurementProbability("11111111"), 0.5, 0.1);
+    }
+}
+
 int main(int argc, char **argv) 
 {
   xacc::Initialize();
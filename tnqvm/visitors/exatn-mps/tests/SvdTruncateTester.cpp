@@ -1,4 +1,5 @@
 #include <memory>
+#include <cmath>
 #include <gtest/gtest.h>
 #include "xacc.hpp"
 #include "xacc_service.hpp"
@@ -22,6 +23,166 @@ TEST(SvdTruncateTester, checkSimple)
     qreg->print();
 }
 
+// GHZ state: a bond dimension of 2 is exact, hence truncation (canonical form) must not change the result.
+TEST(SvdTruncateTester, checkCanonicalTruncation) 
+{    
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testGhz(qbit q) {
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        CNOT(q[1], q[2]);
+        CNOT(q[3], q[2]);
+        CNOT(q[2], q[3]);
+        CNOT(q[3], q[4]);
+        Measure(q[0]);
+        Measure(q[1]);
+        Measure(q[2]);
+        Measure(q[3]);
+        Measure(q[4]);
+    })");
+
+    auto program = ir->getComposite("testGhz");
+    auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("shots", 1000), std::make_pair("max-bond-dim", 2), std::make_pair("canonical-form", true)});
+    auto qreg = xacc::qalloc(5);
+    accelerator->execute(qreg, program);
+    qreg->print();
+    const auto measurements = qreg->getMeasurementCounts();
+    EXPECT_EQ(measurements.size(), 2);
+    EXPECT_NEAR(qreg->computeMeasurementProbability("00000"), 0.5, 0.1);
+    EXPECT_NEAR(qreg->computeMeasurementProbability("11111"), 0.5, 0.1);
+}
+
+// Fidelity budget: the estimated fidelity (product over all truncations) must meet the target.
+TEST(SvdTruncateTester, checkFidelityBudget) 
+{    
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testRandom(qbit q) {
+        H(q[0]);
+        H(q[1]);
+        H(q[2]);
+        H(q[3]);
+        H(q[4]);
+        H(q[5]);
+        for (int layer = 0; layer < 4; layer++) {
+            for (int i = 0; i < 5; i++) {
+                Rx(q[i], 0.7);
+                Ry(q[i + 1], 1.3);
+                CNOT(q[i], q[i + 1]);
+            }
+        }
+    })");
+
+    auto program = ir->getComposite("testRandom");
+    const double fidelityTarget = 0.9;
+    auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("fidelity-target", fidelityTarget)});
+    auto qreg = xacc::qalloc(6);
+    accelerator->execute(qreg, program);
+    auto exeInfo = accelerator->getExecutionInfo();
+    const double fidelity = exeInfo.get<double>("estimated-fidelity");
+    const double discardedWeight = exeInfo.get<double>("discarded-weight");
+    std::cout << "Estimated fidelity = " << fidelity << "; discarded weight = " << discardedWeight << "\n";
+    EXPECT_GE(fidelity, fidelityTarget);
+    EXPECT_LE(fidelity, 1.0);
+    EXPECT_GE(discardedWeight, 0.0);
+    const auto bondDimHistory = exeInfo.get<std::map<int, std::vector<int>>>("bond-dim-history");
+    // All bonds have been updated by the CNOT gates.
+    EXPECT_EQ(bondDimHistory.size(), 5);
+}
+
+// Memory cap: bond dimensions are limited by the max MPS size.
+TEST(SvdTruncateTester, checkMemoryCap) 
+{    
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testMemCap(qbit q) {
+        for (int i = 0; i < 12; i++) {
+            H(q[i]);
+        }
+        for (int layer = 0; layer < 6; layer++) {
+            for (int i = 0; i < 11; i++) {
+                Rx(q[i], 0.7);
+                CNOT(q[i], q[i + 1]);
+            }
+        }
+    })");
+
+    auto program = ir->getComposite("testMemCap");
+    // 12 sites with bond dim <= 4 fit in 12 * 2 * 4 * 4 complex<double> elements.
+    const double maxMemoryMb = 12 * 2 * 4 * 4 * 16 / (1024.0 * 1024.0);
+    auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("max-mps-memory-mb", maxMemoryMb)});
+    auto qreg = xacc::qalloc(12);
+    accelerator->execute(qreg, program);
+    auto exeInfo = accelerator->getExecutionInfo();
+    const auto bondDimHistory = exeInfo.get<std::map<int, std::vector<int>>>("bond-dim-history");
+    // Final bond dimensions (bond i: between sites i and i + 1; never split: 1)
+    std::vector<double> bondDims(11, 1.0);
+    for (const auto& [bondIdx, history] : bondDimHistory)
+    {
+        ASSERT_LT(bondIdx, 11);
+        bondDims[bondIdx] = history.back();
+    }
+    // The cap is on the total size of the site tensors (chi_left x 2 x chi_right complex<double>)
+    double mpsBytes = 0.0;
+    for (int site = 0; site < 12; ++site)
+    {
+        const double leftDim = (site == 0) ? 1.0 : bondDims[site - 1];
+        const double rightDim = (site == 11) ? 1.0 : bondDims[site];
+        mpsBytes += 2.0 * leftDim * rightDim * 16.0;
+    }
+    EXPECT_LE(mpsBytes, maxMemoryMb * 1024.0 * 1024.0);
+    EXPECT_LT(exeInfo.get<double>("estimated-fidelity"), 1.0);
+}
+
+// Variational compression: gates are applied at 2 * max-bond-dim, then the MPS is compressed back.
+TEST(SvdTruncateTester, checkVariationalCompression) 
+{    
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void testVariational(qbit q) {
+        for (int i = 0; i < 8; i++) {
+            H(q[i]);
+        }
+        for (int layer = 0; layer < 5; layer++) {
+            for (int i = 0; i < 7; i++) {
+                Rx(q[i], 0.7);
+                Ry(q[i + 1], 1.3);
+                CNOT(q[i], q[i + 1]);
+            }
+        }
+        Measure(q[0]);
+        Measure(q[7]);
+    })");
+
+    auto program = ir->getComposite("testVariational");
+    const int maxBondDim = 4;
+    auto accelerator = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("max-bond-dim", maxBondDim), std::make_pair("variational-compression", true)});
+    auto qreg = xacc::qalloc(8);
+    accelerator->execute(qreg, program);
+    auto exeInfo = accelerator->getExecutionInfo();
+    const double fidelity = exeInfo.get<double>("estimated-fidelity");
+    EXPECT_GT(fidelity, 0.0);
+    EXPECT_LE(fidelity, 1.0);
+    // The final MPS is compressed to max-bond-dim.
+    const auto bondDimHistory = exeInfo.get<std::map<int, std::vector<int>>>("bond-dim-history");
+    for (const auto& [bondIdx, bondDims] : bondDimHistory)
+    {
+        EXPECT_LE(bondDims.back(), maxBondDim);
+    }
+
+    auto exactAcc = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps")});
+    auto exactReg = xacc::qalloc(8);
+    exactAcc->execute(exactReg, program);
+    // For pure states, |<Z> - <Z>exact| <= || rho - rho_exact ||_1 = 2 * sqrt(1 - fidelity).
+    const double expValTolerance = 2.0 * std::sqrt(1.0 - fidelity) + 1e-6;
+    EXPECT_NEAR(qreg->getExpectationValueZ(), exactReg->getExpectationValueZ(), expValTolerance);
+
+    // Same bond dimension, SVD truncation only: the variational compression must do at least as well.
+    auto svdAcc = xacc::getAccelerator("tnqvm", {std::make_pair("tnqvm-visitor", "exatn-mps"), std::make_pair("max-bond-dim", maxBondDim), std::make_pair("variational-compression", false)});
+    auto svdReg = xacc::qalloc(8);
+    svdAcc->execute(svdReg, program);
+    const double svdFidelity = svdAcc->getExecutionInfo().get<double>("estimated-fidelity");
+    EXPECT_LT(svdFidelity, 1.0);
+    EXPECT_GE(fidelity, svdFidelity);
+}
+
 int main(int argc, char **argv) 
 {
   xacc::Initialize();
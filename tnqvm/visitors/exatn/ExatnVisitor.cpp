@@ -43,7 +43,13 @@
 #include <chrono>
 #include <functional>
 #include <unordered_set>
+#include <map>
+#include <fstream>
+#include <cstdio>
 #include "utils/GateMatrixAlgebra.hpp"
+#ifdef MPI_ENABLED
+#include <mpi.h>
+#endif
 
 #ifdef TNQVM_EXATN_USES_MKL_BLAS
 #include <dlfcn.h>
@@ -97,25 +103,53 @@ template<typename TNQVM_COMPLEX_TYPE>
 double calcExpValueZ(const std::vector<int>& in_bits, const std::vector<TNQVM_COMPLEX_TYPE>& in_stateVec)
 {
   TNQVM_TELEMETRY_ZONE("calcExpValueZ", __FILE__, __LINE__);
-  const auto hasEvenParity = [](uint64_t x, const std::vector<int>& in_qubitIndices) -> bool {
-    size_t count = 0;
-    for (const auto& bitIdx : in_qubitIndices)
-    {
-        if (x & (1ULL << bitIdx))
-        {
-            count++;
-        }
-    }
-    return (count % 2) == 0;
-  };
+  return CalcExpValueZ(in_bits, in_stateVec);
+}
+
+// Calculates the exp-val-z of multiple qubit subsets in one pass over the state vector.
+template<typename TNQVM_COMPLEX_TYPE>
+std::vector<double> calcExpValueZ(const std::vector<std::vector<int>>& in_bitsList, const std::vector<TNQVM_COMPLEX_TYPE>& in_stateVec)
+{
+  TNQVM_TELEMETRY_ZONE("calcExpValueZ", __FILE__, __LINE__);
+  std::vector<uint64_t> masks;
+  masks.reserve(in_bitsList.size());
+  for (const auto& bits : in_bitsList)
+  {
+    masks.emplace_back(GetParityMask(bits));
+  }
+  return CalcExpValueZByMasks(masks, in_stateVec);
+}
+
+// VQE mode: name of the tensor holding the cached (ansatz) state vector.
+const std::string VQE_RESET_TENSOR_NAME = "RESET_";
 
-  double result = 0.0;
-  for(uint64_t i = 0; i < in_stateVec.size(); ++i)
+// Retrieves the matrix of a single-qubit gate instruction.
+// Returns false if the gate is not supported (e.g. multi-qubit gates).
+bool getSingleQubitGateMatrix(const xacc::Instruction& in_gate, GateMatrixType& out_gateMatrix)
+{
+  using namespace tnqvm;
+  if (in_gate.bits().size() != 1)
   {
-    result += (hasEvenParity(i, in_bits) ? 1.0 : -1.0) * std::norm(in_stateVec[i]);
+    return false;
   }
 
-  return result;
+  switch (GetGateType(in_gate.name()))
+  {
+    case CommonGates::I: out_gateMatrix = GetGateMatrix<CommonGates::I>(); return true;
+    case CommonGates::H: out_gateMatrix = GetGateMatrix<CommonGates::H>(); return true;
+    case CommonGates::X: out_gateMatrix = GetGateMatrix<CommonGates::X>(); return true;
+    case CommonGates::Y: out_gateMatrix = GetGateMatrix<CommonGates::Y>(); return true;
+    case CommonGates::Z: out_gateMatrix = GetGateMatrix<CommonGates::Z>(); return true;
+    case CommonGates::T: out_gateMatrix = GetGateMatrix<CommonGates::T>(); return true;
+    case CommonGates::Tdg: out_gateMatrix = GetGateMatrix<CommonGates::Tdg>(); return true;
+    case CommonGates::Rx: out_gateMatrix = GetGateMatrix<CommonGates::Rx>(in_gate.getParameter(0).as<double>()); return true;
+    case CommonGates::Ry: out_gateMatrix = GetGateMatrix<CommonGates::Ry>(in_gate.getParameter(0).as<double>()); return true;
+    case CommonGates::Rz: out_gateMatrix = GetGateMatrix<CommonGates::Rz>(in_gate.getParameter(0).as<double>()); return true;
+    case CommonGates::U: 
+      out_gateMatrix = GetGateMatrix<CommonGates::U>(in_gate.getParameter(0).as<double>(), in_gate.getParameter(1).as<double>(), in_gate.getParameter(2).as<double>()); 
+      return true;
+    default: return false;
+  }
 }
 } // namespace
 
@@ -232,25 +266,12 @@ template<typename TNQVM_COMPLEX_TYPE>
 int CalculateExpectationValueFunctor<TNQVM_COMPLEX_TYPE>::apply(talsh::Tensor &local_tensor) {
   TNQVM_TELEMETRY_ZONE(__FUNCTION__, __FILE__, __LINE__);
 
-  const auto hasEvenParity =
-      [](size_t x, const std::vector<int> &in_qubitIndices) -> bool {
-    size_t count = 0;
-    for (const auto &bitIdx : in_qubitIndices) {
-      if (x & (1ULL << bitIdx)) {
-        count++;
-      }
-    }
-    return (count % 2) == 0;
-  };
-
   TNQVM_COMPLEX_TYPE *elements;
   const bool isOkay = local_tensor.getDataAccessHost(&elements);
   m_result = 0.0;
   if (isOkay) {
-    for (uint64_t i = 0; i < local_tensor.getVolume(); ++i) {
-      m_result += (hasEvenParity(i, m_qubitIndices) ? 1.0 : -1.0) *
-                  std::norm(elements[i]);
-    }
+    m_result = CalcExpValueZByMasks({GetParityMask(m_qubitIndices)}, elements,
+                                    local_tensor.getVolume())[0];
   }
 
   return 0;
@@ -785,18 +806,31 @@ void ExatnVisitor<TNQVM_COMPLEX_TYPE>::finalize() {
   if (m_buffer->size() > MAX_NUMBER_QUBITS_FOR_STATE_VEC && !m_measureQbIdx.empty() && m_shots > 0 && !m_hasEvaluated)
   {
     std::cout << "Simulating bit string by tensor contraction and projection \n";
-    for (int i = 0; i < m_shots; ++i)
+    // Number of process sub-groups to split the shots into (MPI only).
+    int nbShotGroups = 1;
+    if (options.keyExists<int>("mpi-shot-groups"))
     {
-      const auto convertToBitString = [](const std::vector<uint8_t>& in_bitVec){
-          std::string result;
-          for (const auto& bit : in_bitVec)
-          {
-              result.append(std::to_string(bit));
-          }
-          return result;
-      };
+      nbShotGroups = std::min<int>(options.get<int>("mpi-shot-groups"), getNumMpiProcs());
+    }
+    if (nbShotGroups > 1)
+    {
+      sampleShotsByProcessGroups(nbShotGroups);
+    }
+    else
+    {
+      for (int i = 0; i < m_shots; ++i)
+      {
+        const auto convertToBitString = [](const std::vector<uint8_t>& in_bitVec){
+            std::string result;
+            for (const auto& bit : in_bitVec)
+            {
+                result.append(std::to_string(bit));
+            }
+            return result;
+        };
 
-      m_buffer->appendMeasurement(convertToBitString(generateMeasureSample(m_tensorNetwork, m_measureQbIdx)));
+        m_buffer->appendMeasurement(convertToBitString(generateMeasureSample(m_tensorNetwork, m_measureQbIdx)));
+      }
     }
   }
   else
@@ -918,7 +952,9 @@ void ExatnVisitor<TNQVM_COMPLEX_TYPE>::visit(Tdg &in_TdgGate) {
 template<typename TNQVM_COMPLEX_TYPE>
 void ExatnVisitor<TNQVM_COMPLEX_TYPE>::visit(CPhase &in_CPhaseGate) {
   TNQVM_TELEMETRY_ZONE(__FUNCTION__, __FILE__, __LINE__);
-  appendGateTensor<CommonGates::CPhase>(in_CPhaseGate);
+  assert(in_CPhaseGate.nParameters() == 1);
+  const double theta = in_CPhaseGate.getParameter(0).as<double>();
+  appendGateTensor<CommonGates::CPhase>(in_CPhaseGate, theta);
 }
 
 template<typename TNQVM_COMPLEX_TYPE>
@@ -1030,30 +1066,24 @@ void ExatnVisitor<TNQVM_COMPLEX_TYPE>::appendGateTensor(const xacc::Instruction
       gateMatrix.emplace_back(std::move(rowConverted));
     }
     m_gateTensorBodies[uniqueGateName] = flattenGateMatrix(gateMatrix);
-    // Currently, we only support 2-qubit gates.
-    assert(in_gateInstruction.nRequiredBits() > 0 &&
-           in_gateInstruction.nRequiredBits() <= 2);
-    const auto gateTensorShape =
-        (in_gateInstruction.nRequiredBits() == 1 ? TensorShape{2, 2}
-                                                 : TensorShape{2, 2, 2, 2});
-    // Create the tensor
+    assert(in_gateInstruction.nRequiredBits() > 0);
+    // Create the tensor: rank-2k for a k-qubit gate
     const bool created = exatn::createTensor(
-        uniqueGateName, getExatnElementType(), gateTensorShape);
+        uniqueGateName, getExatnElementType(),
+        TensorShape(std::vector<exatn::DimExtent>(2 * in_gateInstruction.nRequiredBits(), 2)));
     assert(created);
     // Init tensor body data
     exatn::initTensorData(uniqueGateName, flattenGateMatrix(gateMatrix));
     // Register tensor isometry:
-    // For rank-2 gate isometric leg groups are: {0}, {1}.
-    // For rank-4 gate isometric leg groups are: {0,1}, {2,3}.
-    if (in_gateInstruction.nRequiredBits() == 1) {
-      const bool registered =
-          exatn::registerTensorIsometry(uniqueGateName, {0}, {1});
-      assert(registered);
-    } else if (in_gateInstruction.nRequiredBits() == 2) {
-      const bool registered =
-          exatn::registerTensorIsometry(uniqueGateName, {0, 1}, {2, 3});
-      assert(registered);
+    // For a rank-2k gate isometric leg groups are: {0, .., k-1}, {k, .., 2k-1}.
+    std::vector<unsigned int> inLegs, outLegs;
+    for (unsigned int i = 0; i < in_gateInstruction.nRequiredBits(); ++i) {
+      inLegs.emplace_back(i);
+      outLegs.emplace_back(in_gateInstruction.nRequiredBits() + i);
     }
+    const bool registered =
+        exatn::registerTensorIsometry(uniqueGateName, inLegs, outLegs);
+    assert(registered);
   }
 
   // Helper to create unique tensor names in the format
@@ -1111,6 +1141,61 @@ void ExatnVisitor<TNQVM_COMPLEX_TYPE>::appendGateTensor(const xacc::Instruction
   }
 }
 
+template <typename TNQVM_COMPLEX_TYPE>
+void ExatnVisitor<TNQVM_COMPLEX_TYPE>::applyGateMatrix(
+    const std::vector<size_t> &in_qubits,
+    const std::vector<std::vector<std::complex<double>>> &in_matrix) {
+  TNQVM_TELEMETRY_ZONE(__FUNCTION__, __FILE__, __LINE__);
+  if ((1ULL << in_qubits.size()) != in_matrix.size()) {
+    xacc::error("Gate matrix dimension doesn't match the number of qubits.");
+  }
+  validateGateQubits(in_qubits, m_buffer->size());
+  if (m_hasEvaluated) {
+    // Same as appendGateTensor: start a new network after evaluation.
+    resetNetwork();
+  }
+
+  m_tensorIdCounter++;
+  // Generic gates are not deduplicated: each matrix has its own tensor body.
+  const std::string uniqueGateName =
+      "UNITARY" + std::to_string(in_qubits.size()) + "_" +
+      std::to_string(m_tensorIdCounter);
+  std::vector<std::vector<TNQVM_COMPLEX_TYPE>> gateMatrix;
+  for (const auto &row : in_matrix) {
+    if (row.size() != in_matrix.size()) {
+      xacc::error("Invalid gate matrix: the matrix must be square.");
+    }
+    gateMatrix.emplace_back(row.begin(), row.end());
+  }
+  m_gateTensorBodies[uniqueGateName] = flattenGateMatrix(gateMatrix);
+  const bool created = exatn::createTensor(
+      uniqueGateName, getExatnElementType(),
+      TensorShape(std::vector<exatn::DimExtent>(2 * in_qubits.size(), 2)));
+  assert(created);
+  exatn::initTensorData(uniqueGateName, m_gateTensorBodies[uniqueGateName]);
+  std::vector<unsigned int> inLegs, outLegs;
+  for (unsigned int i = 0; i < in_qubits.size(); ++i) {
+    inLegs.emplace_back(i);
+    outLegs.emplace_back(in_qubits.size() + i);
+  }
+  const bool registered =
+      exatn::registerTensorIsometry(uniqueGateName, inLegs, outLegs);
+  assert(registered);
+
+  // The first qubit is the most significant bit of the matrix,
+  // i.e. the slowest (last) leg of the tensor: reverse the pairing.
+  std::vector<unsigned int> gatePairing(in_qubits.rbegin(), in_qubits.rend());
+  if (m_isAppendingCircuitGates) {
+    m_appendedGateTensors.emplace_back(
+        std::make_pair(uniqueGateName, gatePairing));
+  }
+  const bool appended = m_tensorNetwork.appendTensorGate(
+      m_tensorIdCounter, exatn::getTensor(uniqueGateName), gatePairing);
+  if (!appended) {
+    xacc::error("Failed to append tensor for gate " + uniqueGateName);
+  }
+}
+
 template<typename TNQVM_COMPLEX_TYPE>
 ExatnVisitor<TNQVM_COMPLEX_TYPE>::ObservableTerm::ObservableTerm(
     const std::vector<std::shared_ptr<Instruction>> &in_operatorsInProduct,
@@ -1506,82 +1591,257 @@ const double ExatnVisitor<TNQVM_COMPLEX_TYPE>::getExpectationValueZ(
     return internalComputeExpectationValueZ(in_function);
   }
 
-  // The new qubit register tensor name will have name "RESET_"
-  const std::string resetTensorName = "RESET_";
-  if (!m_hasEvaluated)
+  cacheAnsatzStateVector();
+  std::vector<std::shared_ptr<Instruction>> basisChangeInsts;
+  std::vector<int> measureQbIdx;
+  InstructionIterator it(in_function);
+  while (it.hasNext())
   {
+    auto nextInst = it.next();
+    if (nextInst->isEnabled() && !nextInst->isComposite())
     {
-      TNQVM_TELEMETRY_ZONE("exatn::evaluateSync", __FILE__, __LINE__);
-      const bool evaluated = exatn::evaluateSync(m_tensorNetwork);
-      assert(evaluated);
-      // Synchronize:
-      exatn::sync();
-      m_cacheStateVec = retrieveStateVector();
+      if (nextInst->name() != "Measure")
+      {
+        basisChangeInsts.emplace_back(nextInst);
+      }
+      else
+      {
+        measureQbIdx.emplace_back(nextInst->bits()[0]);
+      }
     }
+  }
+  assert(!measureQbIdx.empty());
+  // If there are no basis change instructions (i.e. Z basis),
+  // use the cached state vector directly.
+  if (basisChangeInsts.empty())
+  {
+    return calcExpValueZ(measureQbIdx, m_cacheStateVec);
+  }
+  return calcExpValueZ(measureQbIdx, applyBasisChange(in_function->name(), basisChangeInsts));
+}
+
+template<typename TNQVM_COMPLEX_TYPE>
+std::vector<double> ExatnVisitor<TNQVM_COMPLEX_TYPE>::getExpectationValueZBatch(
+    const std::vector<std::shared_ptr<CompositeInstruction>>& in_functions) {
+  TNQVM_TELEMETRY_ZONE(__FUNCTION__, __FILE__, __LINE__);
+  // Large circuits: there is no cached wavefunction to share.
+  if (!m_buffer || m_buffer->size() > m_maxQubit) {
+    return TNQVMVisitor::getExpectationValueZBatch(in_functions);
+  }
 
-    // State vector after the base ansatz
-    assert(m_cacheStateVec.size() == (1ULL << m_buffer->size()));
+  // Terms that can be measured from the same rotated state vector:
+  // i.e. they agree on the change-of-basis gates of every qubit they share.
+  struct BasisGroup
+  {
+    // Per-qubit change-of-basis signature (empty string: Z basis)
+    std::map<size_t, std::string> basis;
+    std::vector<std::shared_ptr<Instruction>> basisChangeInsts;
+    std::vector<size_t> termIds;
+    // Terms with multi-qubit change-of-basis gates are not grouped.
+    bool isExclusive = false;
+  };
 
-    // The qubit register tensor shape is {2, 2, 2, ...}, 1 leg for each qubit
-    std::vector<int> qubitRegResetTensorShape(m_buffer->size(), 2);
-    const bool created = exatn::createTensor(resetTensorName, getExatnElementType(), qubitRegResetTensorShape);
-    assert(created);
-    // Initialize the tensor body with the state vector from the previous
-    // evaluation.
-    const bool initialized = exatn::initTensorData(resetTensorName, m_cacheStateVec);
-    assert(initialized);
-    for (auto iter = m_qubitRegTensor.cbegin(); iter != m_qubitRegTensor.cend(); ++iter)
+  std::vector<std::vector<int>> measureQbIdxList(in_functions.size());
+  std::vector<BasisGroup> groups;
+  for (size_t termId = 0; termId < in_functions.size(); ++termId)
+  {
+    std::map<size_t, std::string> termBasis;
+    std::map<size_t, std::vector<std::shared_ptr<Instruction>>> termGates;
+    std::vector<std::shared_ptr<Instruction>> allGates;
+    bool isQubitWise = true;
+    InstructionIterator it(in_functions[termId]);
+    while (it.hasNext())
+    {
+      auto nextInst = it.next();
+      if (nextInst->isEnabled() && !nextInst->isComposite())
+      {
+        if (nextInst->name() == "Measure")
+        {
+          measureQbIdxList[termId].emplace_back(nextInst->bits()[0]);
+          termBasis[nextInst->bits()[0]];
+          continue;
+        }
+
+        allGates.emplace_back(nextInst);
+        if (nextInst->bits().size() == 1)
+        {
+          termBasis[nextInst->bits()[0]] += nextInst->toString() + ";";
+          termGates[nextInst->bits()[0]].emplace_back(nextInst);
+        }
+        else
+        {
+          isQubitWise = false;
+        }
+      }
+    }
+    assert(!measureQbIdxList[termId].empty());
+
+    if (!isQubitWise)
+    {
+      BasisGroup group;
+      group.basisChangeInsts = allGates;
+      group.termIds.emplace_back(termId);
+      group.isExclusive = true;
+      groups.emplace_back(std::move(group));
+      continue;
+    }
+
+    // Greedy grouping: first compatible group.
+    const auto isCompatible = [&termBasis](const BasisGroup& in_group) {
+      if (in_group.isExclusive)
+      {
+        return false;
+      }
+      for (const auto& [qubit, basis] : termBasis)
+      {
+        const auto iter = in_group.basis.find(qubit);
+        if (iter != in_group.basis.end() && iter->second != basis)
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    auto groupIter = std::find_if(groups.begin(), groups.end(), isCompatible);
+    if (groupIter == groups.end())
+    {
+      groups.emplace_back(BasisGroup());
+      groupIter = std::prev(groups.end());
+    }
+
+    for (const auto& [qubit, basis] : termBasis)
+    {
+      // New qubit for this group: add its change-of-basis gates.
+      if (groupIter->basis.emplace(qubit, basis).second)
+      {
+        const auto gateIter = termGates.find(qubit);
+        if (gateIter != termGates.end())
+        {
+          groupIter->basisChangeInsts.insert(groupIter->basisChangeInsts.end(), gateIter->second.begin(), gateIter->second.end());
+        }
+      }
+    }
+    groupIter->termIds.emplace_back(termId);
+  }
+
+  if (xacc::verbose)
+  {
+    xacc::info("Exp-val-z: " + std::to_string(in_functions.size()) + " terms in " + std::to_string(groups.size()) + " measurement basis groups.");
+  }
+
+  cacheAnsatzStateVector();
+  std::vector<double> result(in_functions.size(), 0.0);
+  for (const auto& group : groups)
+  {
+    std::vector<std::vector<int>> groupMeasureQbIdx;
+    groupMeasureQbIdx.reserve(group.termIds.size());
+    for (const auto& termId : group.termIds)
+    {
+      groupMeasureQbIdx.emplace_back(measureQbIdxList[termId]);
+    }
+
+    const auto expVals = group.basisChangeInsts.empty() ?
+      calcExpValueZ(groupMeasureQbIdx, m_cacheStateVec) :
+      calcExpValueZ(groupMeasureQbIdx, applyBasisChange(in_functions[group.termIds.front()]->name(), group.basisChangeInsts));
+    assert(expVals.size() == group.termIds.size());
+    for (size_t i = 0; i < group.termIds.size(); ++i)
+    {
+      result[group.termIds[i]] = expVals[i];
+    }
+  }
+
+  return result;
+}
+
+template<typename TNQVM_COMPLEX_TYPE>
+void ExatnVisitor<TNQVM_COMPLEX_TYPE>::cacheAnsatzStateVector() {
+  // Already cached.
+  if (m_hasEvaluated)
+  {
+    return;
+  }
+
+  {
+    TNQVM_TELEMETRY_ZONE("exatn::evaluateSync", __FILE__, __LINE__);
+    const bool evaluated = exatn::evaluateSync(m_tensorNetwork);
+    assert(evaluated);
+    // Synchronize:
+    exatn::sync();
+    m_cacheStateVec = retrieveStateVector();
+  }
+
+  // State vector after the base ansatz
+  assert(m_cacheStateVec.size() == (1ULL << m_buffer->size()));
+
+  // The qubit register tensor shape is {2, 2, 2, ...}, 1 leg for each qubit
+  std::vector<int> qubitRegResetTensorShape(m_buffer->size(), 2);
+  const bool created = exatn::createTensor(VQE_RESET_TENSOR_NAME, getExatnElementType(), qubitRegResetTensorShape);
+  assert(created);
+  // Initialize the tensor body with the state vector from the previous
+  // evaluation.
+  const bool initialized = exatn::initTensorData(VQE_RESET_TENSOR_NAME, m_cacheStateVec);
+  assert(initialized);
+  for (auto iter = m_qubitRegTensor.cbegin(); iter != m_qubitRegTensor.cend(); ++iter)
+  {
+    const auto& tensorName = iter->second.getTensor()->getName();
+    // Not a root tensor
+    if (!tensorName.empty() && tensorName[0] != '_')
     {
-      const auto& tensorName = iter->second.getTensor()->getName();
-      // Not a root tensor
-      if (!tensorName.empty() && tensorName[0] != '_')
+      const bool destroyed = exatn::destroyTensorSync(tensorName);
+      assert(destroyed);
+    }
+  }
+  m_hasEvaluated = true;
+}
+
+template<typename TNQVM_COMPLEX_TYPE>
+std::vector<TNQVM_COMPLEX_TYPE> ExatnVisitor<TNQVM_COMPLEX_TYPE>::applyBasisChange(
+    const std::string& in_name, const std::vector<std::shared_ptr<Instruction>>& in_basisChangeInsts) {
+  TNQVM_TELEMETRY_ZONE(__FUNCTION__, __FILE__, __LINE__);
+  assert(m_hasEvaluated);
+  // Fast path: single-qubit change-of-basis gates (e.g. H, Rx) are applied
+  // in-place to a scratch copy of the cached state vector (no ExaTN evaluation).
+  {
+    std::vector<GateMatrixType> gateMatrices(in_basisChangeInsts.size());
+    bool allSingleQubitGates = true;
+    for (size_t i = 0; i < in_basisChangeInsts.size() && allSingleQubitGates; ++i)
+    {
+      allSingleQubitGates = getSingleQubitGateMatrix(*in_basisChangeInsts[i], gateMatrices[i]);
+    }
+
+    if (allSingleQubitGates)
+    {
+      auto stateVec = m_cacheStateVec;
+      for (size_t i = 0; i < in_basisChangeInsts.size(); ++i)
       {
-        const bool destroyed = exatn::destroyTensorSync(tensorName);
-        assert(destroyed);
+        ApplySingleQubitGateInPlace(stateVec, in_basisChangeInsts[i]->bits()[0], gateMatrices[i]);
       }
+      return stateVec;
     }
   }
 
+  // Otherwise, contract the change-of-basis gates with the cached state tensor.
   // Create a new tensor network
-  m_tensorNetwork = TensorNetwork(in_function->name());
+  m_tensorNetwork = TensorNetwork(in_name);
   // Reset counter
   m_tensorIdCounter = 1;
   m_measureQbIdx.clear();
   // Use the root tensor from previous evaluation as the initial tensor
-  m_tensorNetwork.appendTensor(m_tensorIdCounter, exatn::getTensor(resetTensorName), std::vector<std::pair<unsigned int, unsigned int>>{});
-  // Walk the remaining circuit and visit all gates
-  InstructionIterator it(in_function);
+  m_tensorNetwork.appendTensor(m_tensorIdCounter, exatn::getTensor(VQE_RESET_TENSOR_NAME), std::vector<std::pair<unsigned int, unsigned int>>{});
+  // Append the change-of-basis gates
   m_hasEvaluated = false;
-  size_t nbBasisChangeInsts = 0;
-  while (it.hasNext())
+  for (auto& inst : in_basisChangeInsts)
   {
-    auto nextInst = it.next();
-    if (nextInst->isEnabled() && !nextInst->isComposite())
-    {
-      if (nextInst->name() != "Measure")
-      {
-        nextInst->accept(this);
-        nbBasisChangeInsts++;
-      }
-      else
-      {
-        m_measureQbIdx.emplace_back(nextInst->bits()[0]);
-      }
-    }
+    inst->accept(this);
   }
-  assert(!m_measureQbIdx.empty());
-  // If there are basis change instructions:
-  // i.e. not Z basis
-  if (nbBasisChangeInsts > 0)
   {
     TNQVM_TELEMETRY_ZONE("exatn::evaluateSync", __FILE__, __LINE__);
     const bool evaluated = exatn::evaluateSync(m_tensorNetwork);
     assert(evaluated);
   }
   m_hasEvaluated = true;
-  const double exp_val_z = (nbBasisChangeInsts > 0) ? calcExpValueZ(m_measureQbIdx, retrieveStateVector()) :  calcExpValueZ(m_measureQbIdx, m_cacheStateVec);
-  m_measureQbIdx.clear();
-  return exp_val_z;
+  return retrieveStateVector();
 }
 
 template <typename TNQVM_COMPLEX_TYPE>
@@ -1615,10 +1875,166 @@ double ExatnVisitor<TNQVM_COMPLEX_TYPE>::getExpectationValueZBySlicing() {
   // Q0 -> Q(m_maxQubit - 1): compute slice
   // The rest (nbProjectedQubits): we sequence through nbProjectedPaths to
   // compute partial expectations for all slices then reduce.
-  // Loop to be parallelized
-  if (getNumMpiProcs() <= 1) {
-    std::vector<double> partialExpectationValues(nbProjectedPaths);
-    for (int i = 0; i < nbProjectedPaths; ++i) {
+  // Paths are assigned to MPI processes dynamically (see below).
+  // Each process evaluates 'slice-batch-size' paths concurrently.
+  const int64_t nbProcs = getNumMpiProcs();
+  const int64_t processRank = (nbProcs > 1) ? exatn::getProcessRank() : 0;
+  int64_t batchSize = 1;
+  if (options.keyExists<int>("slice-batch-size")) {
+    batchSize = std::max(1, options.get<int>("slice-batch-size"));
+  }
+  const auto &processGroup = (nbProcs > 1) ? exatn::getCurrentProcessGroup()
+                                           : exatn::getDefaultProcessGroup();
+
+  // Checkpoint: completed paths and their partial exp-vals, keyed by the path
+  // index and by the hash of the circuit. Completed paths of a matching
+  // checkpoint are not recomputed.
+  // With MPI, each process writes its own file (suffixed by its rank) but
+  // loads the files of all the processes (of this run and of a larger
+  // previous run): the paths are handed out dynamically, hence a completed
+  // path is reused by whichever process draws it this time. The unsuffixed
+  // file of a single-process run is loaded too.
+  std::string checkpointBaseName;
+  std::string checkpointFileName;
+  std::vector<std::string> loadedCheckpointFiles;
+  int checkpointInterval = 1;
+  std::map<int64_t, double> completedPaths;
+  size_t nbUnsavedPaths = 0;
+  const std::string circuitHash = std::to_string(computeCircuitHash());
+  const auto getRankCheckpointFileName = [&](int64_t in_rank) {
+    return checkpointBaseName + "." + std::to_string(in_rank);
+  };
+  if (options.stringExists("slice-checkpoint-file")) {
+    checkpointBaseName = options.getString("slice-checkpoint-file");
+    checkpointFileName = (nbProcs > 1)
+                             ? getRankCheckpointFileName(processRank)
+                             : checkpointBaseName;
+    executionInfo.insert("slice-checkpoint-hash", circuitHash);
+    if (options.keyExists<int>("slice-checkpoint-interval")) {
+      checkpointInterval = std::max(1, options.get<int>("slice-checkpoint-interval"));
+    }
+    // Rank files are contiguous (every process writes its file at start),
+    // hence stop at the first missing one past the current ranks.
+    std::vector<std::string> candidateFiles{checkpointBaseName};
+    for (int64_t rank = 0;; ++rank) {
+      const std::string rankFileName = getRankCheckpointFileName(rank);
+      if (rank >= nbProcs && !std::ifstream(rankFileName).good()) {
+        break;
+      }
+      candidateFiles.emplace_back(rankFileName);
+    }
+    for (const auto &fileName : candidateFiles) {
+      std::ifstream checkpointFile(fileName);
+      std::string savedHash;
+      if (!(checkpointFile >> savedHash)) {
+        continue;
+      }
+      loadedCheckpointFiles.emplace_back(fileName);
+      if (savedHash == circuitHash) {
+        int64_t pathIdx;
+        double partialExpVal;
+        while (checkpointFile >> pathIdx >> partialExpVal) {
+          completedPaths[pathIdx] = partialExpVal;
+        }
+      } else {
+        xacc::warning("Checkpoint '" + fileName +
+                      "' was created by a different circuit: ignored.");
+      }
+    }
+    if (!completedPaths.empty()) {
+      xacc::info("Resuming from checkpoint '" + checkpointBaseName + "': " +
+                 std::to_string(completedPaths.size()) + " completed paths.");
+    }
+  }
+  const auto saveCheckpoint = [&]() {
+    // Write to a temporary file then rename, so that a crash while writing
+    // doesn't corrupt the previous checkpoint.
+    const std::string tempFileName = checkpointFileName + ".tmp";
+    {
+      std::ofstream checkpointFile(tempFileName, std::ios::trunc);
+      checkpointFile.precision(17);
+      checkpointFile << circuitHash << "\n";
+      for (const auto &[pathIdx, partialExpVal] : completedPaths) {
+        checkpointFile << pathIdx << " " << partialExpVal << "\n";
+      }
+    }
+    std::rename(tempFileName.c_str(), checkpointFileName.c_str());
+    nbUnsavedPaths = 0;
+  };
+  if (!checkpointFileName.empty()) {
+    // The file of this process holds all the loaded paths, so that it can
+    // replace the previous one.
+    saveCheckpoint();
+  }
+
+  // Dynamic assignment (self-scheduling): the paths are handed out in order,
+  // one batch at a time, by a shared path counter. A process draws its next
+  // batch as soon as it has completed the previous one, hence faster
+  // processes (or processes with cheaper paths) compute more paths, and there
+  // is no synchronization between processes until the final reduction.
+  // With MPI, the counter lives on rank 0 and is incremented with an atomic
+  // one-sided fetch-and-add (ExaTN has no atomic remote operation, hence the
+  // explicit MPI API here).
+  int64_t localPathCounter = 0;
+#ifdef MPI_ENABLED
+  MPI_Win pathCounterWin = MPI_WIN_NULL;
+  int64_t *pathCounterPtr = nullptr;
+  if (nbProcs > 1) {
+    auto commProxy = exatn::getDefaultProcessGroup().getMPICommProxy();
+    MPI_Comm comm = commProxy.getRef<MPI_Comm>();
+    MPI_Win_allocate((processRank == 0) ? sizeof(int64_t) : 0,
+                     sizeof(int64_t), MPI_INFO_NULL, comm, &pathCounterPtr,
+                     &pathCounterWin);
+    if (processRank == 0) {
+      MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, pathCounterWin);
+      *pathCounterPtr = 0;
+      MPI_Win_unlock(0, pathCounterWin);
+    }
+    // The counter must be initialized before any process draws from it.
+    MPI_Barrier(comm);
+  }
+#endif
+  // Returns the first path of the next batch (>= nbProjectedPaths: no more
+  // paths).
+  const auto drawNextBatch = [&]() -> int64_t {
+#ifdef MPI_ENABLED
+    if (nbProcs > 1) {
+      const int64_t increment = batchSize;
+      int64_t batchStart = 0;
+      MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, pathCounterWin);
+      MPI_Fetch_and_op(&increment, &batchStart, MPI_INT64_T, 0, 0, MPI_SUM,
+                       pathCounterWin);
+      MPI_Win_unlock(0, pathCounterWin);
+      return batchStart;
+    }
+#endif
+    const int64_t batchStart = localPathCounter;
+    localPathCounter += batchSize;
+    return batchStart;
+  };
+
+  std::vector<double> partialExpectationValues;
+  int64_t nbLocalPaths = 0;
+  for (int64_t batchStart = drawNextBatch(); batchStart < nbProjectedPaths;
+       batchStart = drawNextBatch()) {
+    const int64_t batchEnd =
+        std::min(batchStart + batchSize, nbProjectedPaths);
+    nbLocalPaths += batchEnd - batchStart;
+    std::vector<int64_t> remainingPaths;
+    for (int64_t i = batchStart; i < batchEnd; ++i) {
+      const auto iter = completedPaths.find(i);
+      if (iter != completedPaths.end()) {
+        partialExpectationValues.emplace_back(iter->second);
+      } else {
+        remainingPaths.emplace_back(i);
+      }
+    }
+    if (remainingPaths.empty()) {
+      continue;
+    }
+    std::vector<std::vector<int>> bitStrings;
+    std::vector<bool> evenParities;
+    for (const int64_t i : remainingPaths) {
       bool evenParity = true;
       // Open legs: 0-m_maxQubit
       std::vector<int> bitString(m_maxQubit, -1);
@@ -1635,128 +2051,104 @@ double ExatnVisitor<TNQVM_COMPLEX_TYPE>::getExpectationValueZBySlicing() {
           bitString.emplace_back(0);
         }
       }
-      std::vector<TNQVM_COMPLEX_TYPE> waveFuncSlice = computeWaveFuncSlice(
-          m_tensorNetwork, bitString, exatn::getDefaultProcessGroup());
-      const double exp_val_z = calcExpValueZ(m_measureQbIdx, waveFuncSlice);
-      partialExpectationValues[i] = evenParity ? exp_val_z : -exp_val_z;
-    }
-    const auto finalExpVal = std::accumulate(
-        partialExpectationValues.begin(), partialExpectationValues.end(), 0.0);
-    return finalExpVal;
-  } else {
-    // Multiple MPI processes:
-    // Note: if the number of MPI processes > total number of paths,
-    // just use enough processes (each process handles 1 path), the rest is
-    // unused.
-    const auto nbMpiProcsToUse = (nbProjectedPaths > getNumMpiProcs())
-                                     ? getNumMpiProcs()
-                                     : nbProjectedPaths;
-    const auto processRank = exatn::getProcessRank();
-    const auto nbProjectedPathsPerProcess = nbProjectedPaths / nbMpiProcsToUse;
-    // If not evenly divided, process 0 to get the remain.
-    // i.e. process 0 always has the largest partial exp-val vectors.
-    const auto nbProjectedPathsProcess0 =
-        nbProjectedPathsPerProcess + nbProjectedPaths % nbMpiProcsToUse;
-    assert((nbProjectedPathsProcess0 +
-            (nbMpiProcsToUse - 1) * nbProjectedPathsPerProcess) ==
-           nbProjectedPaths);
-    std::vector<double> partialExpectationValues(nbProjectedPathsPerProcess);
+      bitStrings.emplace_back(std::move(bitString));
+      evenParities.emplace_back(evenParity);
+    }
+    const auto waveFuncSlices =
+        computeWaveFuncSlices(m_tensorNetwork, bitStrings, processGroup);
+    for (size_t sliceIdx = 0; sliceIdx < waveFuncSlices.size(); ++sliceIdx) {
+      const double exp_val_z =
+          calcExpValueZ(m_measureQbIdx, waveFuncSlices[sliceIdx]);
+      partialExpectationValues.emplace_back(
+          evenParities[sliceIdx] ? exp_val_z : -exp_val_z);
+      if (!checkpointFileName.empty()) {
+        completedPaths[remainingPaths[sliceIdx]] =
+            partialExpectationValues.back();
+        ++nbUnsavedPaths;
+      }
+    }
+    if (!checkpointFileName.empty() && nbUnsavedPaths >= static_cast<size_t>(checkpointInterval)) {
+      saveCheckpoint();
+    }
+  }
+#ifdef MPI_ENABLED
+  if (pathCounterWin != MPI_WIN_NULL) {
+    // Collective: all processes have drawn past the last path.
+    MPI_Win_free(&pathCounterWin);
+  }
+#endif
+  std::stringstream ss;
+  ss << "Process [" << processRank << "]: Number of paths = "
+     << nbLocalPaths << "\n";
+  xacc::info(ss.str());
+  // All paths are completed: the checkpoint is no longer needed.
+  // Each process removes its own file, rank 0 removes the loaded files of
+  // the processes which are not part of this run.
+  // Note: with MPI, only once all processes are done (after the all-reduce).
+  const auto removeCheckpoint = [&]() {
+    if (checkpointFileName.empty()) {
+      return;
+    }
+    std::remove(checkpointFileName.c_str());
     if (processRank == 0) {
-      partialExpectationValues.resize(nbProjectedPathsProcess0);
-    }
-    // Name of the tensor to hold the accumulated exp-value of the process.
-    const std::string accumulatedTensorName = "ExpVal";
-
-    // These processes need to do work:
-    if (processRank < nbMpiProcsToUse) {
-      const int64_t processStartIdx =
-          (processRank == 0) ? 0
-                             : (nbProjectedPathsProcess0 +
-                                (processRank - 1) * nbProjectedPathsPerProcess);
-      const int64_t processEndIdx =
-          (processRank == 0) ? nbProjectedPathsProcess0
-                             : (processStartIdx + nbProjectedPathsPerProcess);
-      std::stringstream ss;
-      ss << "Process [" << processRank
-                << "]: Start = " << processStartIdx
-                << "; End = " << processEndIdx << "\n";
-      xacc::info(ss.str());
-      int64_t vectorIdx = 0;
-      for (int64_t i = processStartIdx; i < processEndIdx; ++i) {
-        bool evenParity = true;
-        // Open legs: 0-m_maxQubit
-        std::vector<int> bitString(m_maxQubit, -1);
-        for (int64_t bitIdx = 0; bitIdx < nbProjectedQubits; ++bitIdx) {
-          const int globalQid = bitIdx + m_maxQubit;
-          const int64_t bitMask = 1ULL << bitIdx;
-          if ((i & bitMask) == bitMask) {
-            bitString.emplace_back(1);
-            if (xacc::container::contains(m_measureQbIdx, globalQid)) {
-              // Flip even parity flag
-              evenParity = !evenParity;
-            }
-          } else {
-            bitString.emplace_back(0);
+      for (const auto &fileName : loadedCheckpointFiles) {
+        bool isCurrentFile = (fileName == checkpointFileName);
+        if (nbProcs > 1) {
+          for (int64_t rank = 0; rank < nbProcs; ++rank) {
+            isCurrentFile = isCurrentFile || (fileName == getRankCheckpointFileName(rank));
           }
         }
-        std::vector<TNQVM_COMPLEX_TYPE> waveFuncSlice = computeWaveFuncSlice(
-            m_tensorNetwork, bitString, exatn::getCurrentProcessGroup());
-        const double exp_val_z = calcExpValueZ(m_measureQbIdx, waveFuncSlice);
-        assert(vectorIdx < partialExpectationValues.size());
-        partialExpectationValues[vectorIdx] =
-            evenParity ? exp_val_z : -exp_val_z;
-        ++vectorIdx;
+        if (!isCurrentFile) {
+          std::remove(fileName.c_str());
+        }
       }
-
-      // Compute local accumulate:
-      const double localAccumulateExpVal =
-          std::accumulate(partialExpectationValues.begin(),
-                          partialExpectationValues.end(), 0.0);
-
-      // MPI Reduce: We don't want to explicitly use MPI API here,
-      // hence using exatn::allreduceTensor API.
-      // Each process will just construct an one-element tensor which
-      // contains the local accumulated exp-val.
-      const bool created = exatn::createTensor(accumulatedTensorName,
-                                               exatn::TensorElementType::REAL64,
-                                               exatn::TensorShape{1});
-      assert(created);
-      std::stringstream ssLog;
-      ssLog << "Process [" << processRank
-                << "]: Local accumulated exp-val = "
-                << localAccumulateExpVal << "\n";
-      xacc::info(ssLog.str());
-      // Init tensor body data
-      exatn::initTensorData(accumulatedTensorName,
-                            std::vector<double>{localAccumulateExpVal});
-    } else {
-      // These processes are excess (in case there are too many processes)
-      const bool created = exatn::createTensor(accumulatedTensorName,
-                                               exatn::TensorElementType::REAL64,
-                                               exatn::TensorShape{1});
-      assert(created);
-      // Init zero tensor body data
-      exatn::initTensorData(accumulatedTensorName, std::vector<double>{0.0});
-    }
-
-    // All-reduce the accumulated tensor across all processes in the group.
-    const bool allReduced = exatn::allreduceTensorSync(
-        exatn::getDefaultProcessGroup(), accumulatedTensorName);
-    assert(allReduced);
-
-    // Done:
-    auto talsh_tensor = exatn::getLocalTensor(accumulatedTensorName);
-    assert(talsh_tensor->getVolume() == 1);
-    const double *body_ptr;
-    // Invalid value to detect any problems.
-    double finalExpVal = -9999.99;
-    if (talsh_tensor->getDataAccessHostConst(&body_ptr)) {
-      finalExpVal = *body_ptr;
     }
-    const bool destroyed = exatn::destroyTensorSync(accumulatedTensorName);
-    assert(destroyed);
-    return finalExpVal;
+  };
+
+  // Compute local accumulate:
+  const double localAccumulateExpVal = std::accumulate(
+      partialExpectationValues.begin(), partialExpectationValues.end(), 0.0);
+  if (nbProcs <= 1) {
+    removeCheckpoint();
+    return localAccumulateExpVal;
   }
+
+  // MPI Reduce: We don't want to explicitly use MPI API here,
+  // hence using exatn::allreduceTensor API.
+  // Each process will just construct an one-element tensor which
+  // contains the local accumulated exp-val (zero if it has no paths, i.e. too
+  // many processes).
+  const std::string accumulatedTensorName = "ExpVal";
+  const bool created =
+      exatn::createTensor(accumulatedTensorName,
+                          exatn::TensorElementType::REAL64, exatn::TensorShape{1});
+  assert(created);
+  std::stringstream ssLog;
+  ssLog << "Process [" << processRank
+        << "]: Local accumulated exp-val = " << localAccumulateExpVal << "\n";
+  xacc::info(ssLog.str());
+  // Init tensor body data
+  exatn::initTensorData(accumulatedTensorName,
+                        std::vector<double>{localAccumulateExpVal});
+
+  // All-reduce the accumulated tensor across all processes in the group.
+  const bool allReduced = exatn::allreduceTensorSync(
+      exatn::getDefaultProcessGroup(), accumulatedTensorName);
+  assert(allReduced);
+
+  // Done:
+  auto talsh_tensor = exatn::getLocalTensor(accumulatedTensorName);
+  assert(talsh_tensor->getVolume() == 1);
+  const double *body_ptr;
+  // Invalid value to detect any problems.
+  double finalExpVal = -9999.99;
+  if (talsh_tensor->getDataAccessHostConst(&body_ptr)) {
+    finalExpVal = *body_ptr;
+  }
+  const bool destroyed = exatn::destroyTensorSync(accumulatedTensorName);
+  assert(destroyed);
+  removeCheckpoint();
+  return finalExpVal;
 }
 
 template <typename TNQVM_COMPLEX_TYPE>
@@ -1925,7 +2317,9 @@ std::vector<uint8_t> ExatnVisitor<TNQVM_COMPLEX_TYPE>::generateMeasureSample(con
         // Evaluate
         {
           TNQVM_TELEMETRY_ZONE("exatn::evaluateSync", __FILE__, __LINE__);
-          if (exatn::evaluateSync(combinedNetwork))
+          // The network is contracted by the shot sub-group (if any) or all the processes.
+          const bool evaluated = m_shotProcessGroup ? exatn::evaluateSync(*m_shotProcessGroup, combinedNetwork) : exatn::evaluateSync(combinedNetwork);
+          if (evaluated)
           {
               exatn::sync();
               auto talsh_tensor = exatn::getLocalTensor(combinedNetwork.getTensor(0)->getName());
@@ -1957,8 +2351,9 @@ std::vector<uint8_t> ExatnVisitor<TNQVM_COMPLEX_TYPE>::generateMeasureSample(con
             assert(prob_0 >= 0.0 && prob_1 >= 0.0);
             assert(std::fabs(1.0 - prob_0 - prob_1) < 1e-12);
 
-            // Generate a random number
-            const double randProbPick = generateRandomProbability();
+            // Generate a random number:
+            // all processes of a shot sub-group must pick the same result, hence use the shared stream.
+            const double randProbPick = m_shotProcessGroup ? std::uniform_real_distribution<double>(0.0, 1.0)(m_shotRandomEngine) : generateRandomProbability();
             // If radom number < probability of 0 state -> pick zero, and vice versa.
             resultBitString.emplace_back(randProbPick <= prob_0 ? 0 : 1);
             resultProbs.emplace_back(randProbPick <= prob_0 ? prob_0 : prob_1);
@@ -2095,16 +2490,30 @@ std::vector<TNQVM_COMPLEX_TYPE>
 ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeWaveFuncSlice(
     const TensorNetwork &in_tensorNetwork, const std::vector<int> &bitString,
     const exatn::ProcessGroup &in_processGroup) const {
+  return computeWaveFuncSlices(in_tensorNetwork, {bitString}, in_processGroup)
+      .front();
+}
+
+template <typename TNQVM_COMPLEX_TYPE>
+std::vector<std::vector<TNQVM_COMPLEX_TYPE>>
+ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeWaveFuncSlices(
+    const TensorNetwork &in_tensorNetwork,
+    const std::vector<std::vector<int>> &in_bitStrings,
+    const exatn::ProcessGroup &in_processGroup) const {
   // Closing the tensor network with the bra
-  std::vector<std::pair<unsigned int, unsigned int>> pairings;
-  int nbOpenLegs = 0;
-  const auto constructBraNetwork = [&](const std::vector<int> &in_bitString) {
+  // Note: tensor (and network) names are suffixed by the slice index
+  // since the slices are evaluated concurrently.
+  const auto constructBraNetwork =
+      [&](const std::vector<int> &in_bitString, size_t in_sliceIdx,
+          std::vector<std::pair<unsigned int, unsigned int>> &out_pairings) {
+    int nbOpenLegs = 0;
     int tensorIdCounter = 1;
     TensorNetwork braTensorNet("bra");
     // Create the qubit register tensor
     for (int i = 0; i < in_bitString.size(); ++i) {
       const auto bitVal = in_bitString[i];
-      const std::string braQubitName = "QB" + std::to_string(i);
+      const std::string braQubitName =
+          "QB" + std::to_string(i) + "_" + std::to_string(in_sliceIdx);
       if (bitVal == 0) {
         const bool created =
             exatn::createTensor(in_processGroup, braQubitName,
@@ -2115,7 +2524,7 @@ ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeWaveFuncSlice(
             braQubitName,
             std::vector<TNQVM_COMPLEX_TYPE>{{1.0, 0.0}, {0.0, 0.0}});
         assert(initialized);
-        pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
+        out_pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
       } else if (bitVal == 1) {
         const bool created =
             exatn::createTensor(in_processGroup, braQubitName,
@@ -2126,7 +2535,7 @@ ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeWaveFuncSlice(
             braQubitName,
             std::vector<TNQVM_COMPLEX_TYPE>{{0.0, 0.0}, {1.0, 0.0}});
         assert(initialized);
-        pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
+        out_pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
       } else if (bitVal == -1) {
         // Add an Id tensor
         const bool created =
@@ -2137,7 +2546,7 @@ ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeWaveFuncSlice(
             braQubitName, std::vector<TNQVM_COMPLEX_TYPE>{
                               {1.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {1.0, 0.0}});
         assert(initialized);
-        pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
+        out_pairings.emplace_back(std::make_pair(i, i + nbOpenLegs));
         nbOpenLegs++;
       } else {
         xacc::error("Unknown values of '" + std::to_string(bitVal) +
@@ -2152,36 +2561,177 @@ ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeWaveFuncSlice(
     return braTensorNet;
   };
 
-  auto braTensors = constructBraNetwork(bitString);
-  braTensors.conjugate();
-  auto combinedTensorNetwork = in_tensorNetwork;
-  assert(pairings.size() == m_buffer->size());
-  combinedTensorNetwork.appendTensorNetwork(std::move(braTensors), pairings);
-  combinedTensorNetwork.collapseIsometries();
-  // combinedTensorNetwork.printIt();
-  std::vector<TNQVM_COMPLEX_TYPE> waveFnSlice;
+  // Submit all the slices before waiting for any of them,
+  // so that the ExaTN runtime can execute them concurrently.
+  std::vector<TensorNetwork> combinedTensorNetworks;
+  std::vector<bool> submitted;
+  for (size_t sliceIdx = 0; sliceIdx < in_bitStrings.size(); ++sliceIdx) {
+    std::vector<std::pair<unsigned int, unsigned int>> pairings;
+    auto braTensors =
+        constructBraNetwork(in_bitStrings[sliceIdx], sliceIdx, pairings);
+    braTensors.conjugate();
+    auto combinedTensorNetwork = in_tensorNetwork;
+    assert(pairings.size() == m_buffer->size());
+    combinedTensorNetwork.appendTensorNetwork(std::move(braTensors), pairings);
+    combinedTensorNetwork.collapseIsometries();
+    combinedTensorNetwork.rename(m_kernelName + "_" + std::to_string(sliceIdx));
+    combinedTensorNetworks.emplace_back(std::move(combinedTensorNetwork));
+  }
   {
     TNQVM_TELEMETRY_ZONE("exatn::evaluateSync", __FILE__, __LINE__);
     // std::cout << "SUBMIT TENSOR NETWORK FOR EVALUATION\n";
     // combinedTensorNetwork.printIt();
-    combinedTensorNetwork.rename(m_kernelName);
-    if (exatn::evaluateSync(in_processGroup, combinedTensorNetwork)) {
-      exatn::sync();
-      auto talsh_tensor =
-          exatn::getLocalTensor(combinedTensorNetwork.getTensor(0)->getName());
+    for (auto &combinedTensorNetwork : combinedTensorNetworks) {
+      submitted.emplace_back(
+          exatn::evaluate(in_processGroup, combinedTensorNetwork));
+    }
+    exatn::sync();
+  }
+  std::vector<std::vector<TNQVM_COMPLEX_TYPE>> waveFnSlices(in_bitStrings.size());
+  for (size_t sliceIdx = 0; sliceIdx < in_bitStrings.size(); ++sliceIdx) {
+    if (submitted[sliceIdx]) {
+      auto talsh_tensor = exatn::getLocalTensor(
+          combinedTensorNetworks[sliceIdx].getTensor(0)->getName());
       const TNQVM_COMPLEX_TYPE *body_ptr;
       if (talsh_tensor->getDataAccessHostConst(&body_ptr)) {
-        waveFnSlice.assign(body_ptr, body_ptr + talsh_tensor->getVolume());
+        waveFnSlices[sliceIdx].assign(body_ptr,
+                                      body_ptr + talsh_tensor->getVolume());
       }
     }
+    // Destroy bra tensors
+    for (int i = 0; i < m_buffer->size(); ++i) {
+      const std::string braQubitName =
+          "QB" + std::to_string(i) + "_" + std::to_string(sliceIdx);
+      const bool destroyed = exatn::destroyTensor(braQubitName);
+      assert(destroyed);
+    }
   }
-  // Destroy bra tensors
-  for (int i = 0; i < m_buffer->size(); ++i) {
-    const std::string braQubitName = "QB" + std::to_string(i);
-    const bool destroyed = exatn::destroyTensor(braQubitName);
+  return waveFnSlices;
+}
+
+template <typename TNQVM_COMPLEX_TYPE>
+void ExatnVisitor<TNQVM_COMPLEX_TYPE>::sampleShotsByProcessGroups(int in_nbGroups) {
+  auto &process_group = exatn::getDefaultProcessGroup();
+  const int processRank = exatn::getProcessRank();
+  const int nbProcs = process_group.getSize();
+  assert(in_nbGroups > 1 && in_nbGroups <= nbProcs);
+  // Contiguous blocks of processes form the sub-groups.
+  const int groupIdx = (processRank * in_nbGroups) / nbProcs;
+#ifdef MPI_ENABLED
+  m_shotProcessGroup = process_group.split(groupIdx);
+#endif
+  assert(m_shotProcessGroup);
+  unsigned int localRank;
+  const bool rankInGroup = m_shotProcessGroup->rankIsIn(processRank, &localRank);
+  assert(rankInGroup);
+
+  // Random streams: all processes of a sub-group share the same stream (same
+  // sampling decisions), different sub-groups use different streams. The base
+  // seed is drawn by rank 0 and all-reduced (no explicit MPI API usage).
+  const std::string seedTensorName = "ShotSeed";
+  {
+    const bool created = exatn::createTensor(
+        seedTensorName, exatn::TensorElementType::REAL64, exatn::TensorShape{1});
+    assert(created);
+    exatn::initTensorData(
+        seedTensorName,
+        std::vector<double>{processRank == 0 ? static_cast<double>(std::random_device{}()) : 0.0});
+    const bool allReduced = exatn::allreduceTensorSync(process_group, seedTensorName);
+    assert(allReduced);
+    auto talsh_tensor = exatn::getLocalTensor(seedTensorName);
+    const double *body_ptr;
+    const bool accessOk = talsh_tensor->getDataAccessHostConst(&body_ptr);
+    assert(accessOk);
+    std::seed_seq seedSeq{static_cast<unsigned int>(*body_ptr), static_cast<unsigned int>(groupIdx)};
+    m_shotRandomEngine.seed(seedSeq);
+    const bool destroyed = exatn::destroyTensorSync(seedTensorName);
     assert(destroyed);
   }
-  return waveFnSlice;
+
+  // Shots of this sub-group:
+  const size_t totalShots = m_shots;
+  const size_t firstShot = groupIdx * totalShots / in_nbGroups;
+  const size_t lastShot = (groupIdx + 1) * totalShots / in_nbGroups;
+  std::stringstream ss;
+  ss << "Process [" << processRank << "]: Shot group " << groupIdx
+     << "; Start = " << firstShot << "; End = " << lastShot << "\n";
+  xacc::info(ss.str());
+  std::vector<std::vector<uint8_t>> samples;
+  for (size_t shot = firstShot; shot < lastShot; ++shot) {
+    samples.emplace_back(generateMeasureSample(m_tensorNetwork, m_measureQbIdx));
+  }
+  m_shotProcessGroup.reset();
+
+  // Gather: bit strings are packed into 32-bit words (exactly representable
+  // as double) of a (shots x words) tensor. The first process of each
+  // sub-group fills in the rows of its shots, then the tensor is sum-reduced.
+  const size_t nbBits = m_measureQbIdx.size();
+  const size_t nbWords = (nbBits + 31) / 32;
+  const std::string samplesTensorName = "ShotSamples";
+  std::vector<double> localData(totalShots * nbWords, 0.0);
+  if (localRank == 0) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+      for (size_t word = 0; word < nbWords; ++word) {
+        uint64_t wordVal = 0;
+        for (size_t bit = 32 * word; bit < std::min(nbBits, 32 * (word + 1)); ++bit) {
+          wordVal |= static_cast<uint64_t>(samples[i][bit]) << (bit - 32 * word);
+        }
+        localData[(firstShot + i) + totalShots * word] = wordVal;
+      }
+    }
+  }
+  const bool created = exatn::createTensor(
+      samplesTensorName, exatn::TensorElementType::REAL64,
+      exatn::TensorShape{totalShots, nbWords});
+  assert(created);
+  exatn::initTensorData(samplesTensorName, localData);
+  const bool allReduced = exatn::allreduceTensorSync(process_group, samplesTensorName);
+  assert(allReduced);
+  if (processRank == 0) {
+    auto talsh_tensor = exatn::getLocalTensor(samplesTensorName);
+    const double *body_ptr;
+    const bool accessOk = talsh_tensor->getDataAccessHostConst(&body_ptr);
+    assert(accessOk);
+    for (size_t shot = 0; shot < totalShots; ++shot) {
+      std::string bitString;
+      for (size_t bit = 0; bit < nbBits; ++bit) {
+        const auto wordVal = static_cast<uint64_t>(body_ptr[shot + totalShots * (bit / 32)]);
+        bitString.append(std::to_string((wordVal >> (bit % 32)) & 1));
+      }
+      m_buffer->appendMeasurement(bitString);
+    }
+  }
+  const bool destroyed = exatn::destroyTensorSync(samplesTensorName);
+  assert(destroyed);
+}
+
+template <typename TNQVM_COMPLEX_TYPE>
+size_t ExatnVisitor<TNQVM_COMPLEX_TYPE>::computeCircuitHash() const {
+  size_t seed = 0;
+  const auto hashCombine = [&seed](size_t in_hash) {
+    seed ^= in_hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+  hashCombine(m_buffer->size());
+  hashCombine(m_maxQubit);
+  hashCombine(getNumMpiProcs());
+  for (const auto &qubitIdx : m_measureQbIdx) {
+    hashCombine(std::hash<int>{}(qubitIdx));
+  }
+  for (const auto &[tensorName, pairing] : m_appendedGateTensors) {
+    hashCombine(std::hash<std::string>{}(tensorName));
+    for (const auto &leg : pairing) {
+      hashCombine(std::hash<unsigned int>{}(leg));
+    }
+    // Generic (matrix) gates are named by index: include the tensor body.
+    const auto iter = m_gateTensorBodies.find(tensorName);
+    if (iter != m_gateTensorBodies.end()) {
+      for (const auto &element : iter->second) {
+        hashCombine(std::hash<double>{}(element.real()));
+        hashCombine(std::hash<double>{}(element.imag()));
+      }
+    }
+  }
+  return seed;
 }
 
 template <typename TNQVM_COMPLEX_TYPE>
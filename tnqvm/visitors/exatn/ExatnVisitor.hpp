@@ -37,6 +37,7 @@
 #include <complex>
 #include <vector>
 #include <utility>
+#include <random>
 #include "TNQVMVisitor.hpp"
 #include "tensor_network.hpp"
 
@@ -82,6 +83,26 @@ using TensorFunctor = talsh::TensorFunctor<exatn::Identifiable>;
 // | exp-val-by-conjugate        | If true, expectation value of *large* circuits (exceed memory limit)   |    bool     | false                    |
 // |                             | is computed by closing the tensor network with its conjugate.          |             |                          |
 // +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | slice-batch-size            | Number of slices (projected paths) evaluated concurrently by each      |    int      | 1                        |
+// |                             | process when computing the expectation value of *large* circuits.      |             |                          |
+// |                             | With MPI, the slices are assigned to processes dynamically: each       |             |                          |
+// |                             | process draws its next batch from a shared counter (one-sided MPI      |             |                          |
+// |                             | fetch-and-add) as soon as it completes the previous one.               |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | slice-checkpoint-file       | Checkpoint file (suffixed by the process rank if using MPI) of the     |    string   | <unused>                 |
+// |                             | completed slices of *large* circuit expectation values. A run of the   |             |                          |
+// |                             | same circuit resumes from it. Removed once all slices are completed.   |             |                          |
+// |                             | With MPI, each process writes its own file but loads those of all the  |             |                          |
+// |                             | processes: a completed slice is reused by any process that draws it.   |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | slice-checkpoint-interval   | Number of completed slices between two checkpoint writes.              |    int      | 1                        |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | mpi-shot-groups             | Number of process sub-groups sampling the shots of *large* circuits    |    int      | 1                        |
+// |                             | (exceed memory limit) independently, each group contracting its share  |             |                          |
+// |                             | of the shots. The samples are gathered on rank 0 (MPI only).           |             |                          |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// Execution info (getExecutionInfo):
+// - "slice-checkpoint-hash" (std::string): circuit hash (first line) of the slicing checkpoint, if 'slice-checkpoint-file' is set.
 
 namespace tnqvm {
     // Simple struct to identify a concrete quantum gate instance,
@@ -270,8 +291,13 @@ namespace tnqvm {
         virtual void visit(fSim& in_fsimGate) override;
         // others
         virtual void visit(Measure& in_MeasureGate) override;
+        // Generic k-qubit gate (appended as a rank-2k gate tensor)
+        virtual void applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix) override;
         virtual bool supportVqeMode() const override { return true; }
         virtual const double getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function) override;
+        // VQE mode: group observed sub-circuits by (qubit-wise commuting) measurement basis,
+        // apply each basis change once and compute the parities of all terms in the group in one pass.
+        virtual std::vector<double> getExpectationValueZBatch(const std::vector<std::shared_ptr<CompositeInstruction>>& in_functions) override;
 
         void subscribe(IExatnListener<TNQVM_COMPLEX_TYPE>* listener) { m_listeners.emplace_back(listener); }
         std::vector<TNQVM_COMPLEX_TYPE> retrieveStateVector();
@@ -315,12 +341,19 @@ namespace tnqvm {
         template<tnqvm::CommonGates GateType, typename... GateParams>
         void appendGateTensor(const xacc::Instruction& in_gateInstruction, GateParams&&... in_params);
         void evaluateNetwork(); 
+        // VQE mode: evaluate the base (ansatz) network and cache the resulting state vector.
+        void cacheAnsatzStateVector();
+        // VQE mode: apply change-of-basis gates to the cached ansatz state vector.
+        std::vector<TNQVM_COMPLEX_TYPE> applyBasisChange(const std::string& in_name, const std::vector<std::shared_ptr<Instruction>>& in_basisChangeInsts);
         void resetExaTN(); 
         void resetNetwork();
         TNQVM_COMPLEX_TYPE expVal(const std::vector<ObservableTerm>& in_observableExpression); 
         TNQVM_COMPLEX_TYPE evaluateTerm(const std::vector<std::shared_ptr<Instruction>>& in_observableTerm); 
         void applyInverse();
         std::vector<uint8_t> generateMeasureSample(const TensorNetwork& in_tensorNetwork, const std::vector<int>& in_qubitIdx);
+        // Splits the processes into sub-groups, each one sampling its share of the shots (large circuits) by generateMeasureSample,
+        // then gathers the samples to the buffer of rank 0.
+        void sampleShotsByProcessGroups(int in_nbGroups);
         // Calculate the flops and memory requirements to generate a full sample (all qubits) for the input tensor network.
         // Note: this doesn't actually contract the tensor network, just getting this data from the ExaTN optimizer.
         // Output: pairs of flops and memory (in bytes); one pair for each qubit.
@@ -331,11 +364,19 @@ namespace tnqvm {
         // Returns the number of MPI processes in the process group if using MPI.
         // (returns 1 if not using MPI)
         size_t getNumMpiProcs() const;
+        // Hash of the circuit (gate tensors and their qubits, measured qubits, etc.),
+        // used to validate the slicing checkpoint.
+        size_t computeCircuitHash() const;
         // Compute the wave-function slice or amplitude (if all bits are set):
         std::vector<TNQVM_COMPLEX_TYPE>
         computeWaveFuncSlice(const TensorNetwork &in_tensorNetwork,
                              const std::vector<int> &in_bitString,
                              const exatn::ProcessGroup &in_processGroup) const;
+        // Compute several wave-function slices (evaluated concurrently by the ExaTN runtime):
+        std::vector<std::vector<TNQVM_COMPLEX_TYPE>>
+        computeWaveFuncSlices(const TensorNetwork &in_tensorNetwork,
+                              const std::vector<std::vector<int>> &in_bitStrings,
+                              const exatn::ProcessGroup &in_processGroup) const;
         
         // Compute exp-val-z for large circuits:
         // Select the appropriate method based on user config:
@@ -412,6 +453,10 @@ namespace tnqvm {
         std::vector<TNQVM_COMPLEX_TYPE> m_cacheStateVec;
         // Max number of qubits that we allow full wave function contraction.
         size_t m_maxQubit;
+        // Process sub-group (and its random stream shared by all processes of the group)
+        // used by generateMeasureSample when the shots are split across sub-groups.
+        std::shared_ptr<exatn::ProcessGroup> m_shotProcessGroup;
+        std::mt19937_64 m_shotRandomEngine;
         // Make the debug logger friend, e.g. retrieve internal states for
         // logging purposes.
         friend class ExatnDebugLogger<TNQVM_COMPLEX_TYPE>;
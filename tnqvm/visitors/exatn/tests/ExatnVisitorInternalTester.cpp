@@ -269,6 +269,95 @@ TEST(ExatnVisitorInternalTester, testSequentialCollapse)
   EXPECT_TRUE(areAllBitsEqual);
 }
 
+// In-place (multi-threaded) single-qubit gate kernel vs. the reference implementation.
+TEST(ExatnVisitorInternalTester, testInPlaceSingleQubitGate)
+{
+  const size_t nbQubits = 18;
+  StateVectorType stateVec(1ULL << nbQubits);
+  for (size_t i = 0; i < stateVec.size(); ++i)
+  {
+    stateVec[i] = std::complex<double>(std::sin(0.37 * i), std::cos(1.1 * i));
+  }
+  auto stateVecInPlace = stateVec;
+  const GateMatrixType rxMat = {
+    { std::cos(0.25), std::complex<double>(0, -1) * std::sin(0.25) },
+    { std::complex<double>(0, -1) * std::sin(0.25), std::cos(0.25) }
+  };
+
+  for (size_t qId = 0; qId < nbQubits; ++qId)
+  {
+    ApplySingleQubitGate(stateVec, qId, rxMat);
+    ApplySingleQubitGateInPlace(stateVecInPlace, qId, rxMat, 4);
+  }
+
+  for (size_t i = 0; i < stateVec.size(); ++i)
+  {
+    EXPECT_NEAR(std::abs(stateVec[i] - stateVecInPlace[i]), 0.0, 1e-12);
+  }
+}
+
+// Multi-mask parity reduction vs. a per-element reference loop.
+TEST(ExatnVisitorInternalTester, testParityReduction)
+{
+  const size_t nbQubits = 18;
+  StateVectorType stateVec(1ULL << nbQubits);
+  for (size_t i = 0; i < stateVec.size(); ++i)
+  {
+    stateVec[i] = std::complex<double>(std::sin(0.37 * i), std::cos(1.1 * i));
+  }
+  const std::vector<std::vector<int>> bitsList { { 0 }, { 1, 2 }, { 0, 5, 17 }, { 3, 4, 8, 16 } };
+  std::vector<uint64_t> masks;
+  for (const auto& bits : bitsList)
+  {
+    masks.emplace_back(GetParityMask(bits));
+  }
+  const auto expVals = CalcExpValueZByMasks(masks, stateVec, 4);
+  ASSERT_EQ(expVals.size(), bitsList.size());
+  for (size_t j = 0; j < bitsList.size(); ++j)
+  {
+    double expected = 0.0;
+    for (size_t i = 0; i < stateVec.size(); ++i)
+    {
+      size_t count = 0;
+      for (const auto& bitIdx : bitsList[j])
+      {
+        count += ((i >> bitIdx) & 1);
+      }
+      expected += ((count % 2 == 0) ? 1.0 : -1.0) * std::norm(stateVec[i]);
+    }
+    EXPECT_NEAR(expVals[j], expected, 1e-6);
+    EXPECT_NEAR(CalcExpValueZ(bitsList[j], stateVec), expected, 1e-6);
+  }
+}
+
+// Generic (three-qubit) gate tensor: Toffoli gate given as an 8x8 matrix.
+TEST(ExatnVisitorInternalTester, testGenericGateMatrix)
+{
+  GateMatrixType toffoliMat(8, std::vector<std::complex<double>>(8, 0.0));
+  for (size_t i = 0; i < 6; ++i)
+  {
+    toffoliMat[i][i] = 1.0;
+  }
+  toffoliMat[6][7] = 1.0;
+  toffoliMat[7][6] = 1.0;
+
+  auto gateRegistry = xacc::getIRProvider("quantum");
+  auto exatnVisitor = std::make_shared<DefaultExatnVisitor>();
+  auto buffer = xacc::qalloc(4);
+  exatnVisitor->initialize(buffer, -1);
+  gateRegistry->createInstruction("X", std::vector<std::size_t>{0})->accept(exatnVisitor);
+  gateRegistry->createInstruction("X", std::vector<std::size_t>{2})->accept(exatnVisitor);
+  // Controls: q0, q2; target: q3
+  exatnVisitor->applyGateMatrix({ 0, 2, 3 }, toffoliMat);
+  // Controls: q0, q1 (not set); target: q2
+  exatnVisitor->applyGateMatrix({ 0, 1, 2 }, toffoliMat);
+  gateRegistry->createInstruction("Measure", std::vector<std::size_t>{2})->accept(exatnVisitor);
+  gateRegistry->createInstruction("Measure", std::vector<std::size_t>{3})->accept(exatnVisitor);
+  exatnVisitor->finalize();
+  // |1011> (q0, q2, q3 set): Z2 * Z3 = 1
+  EXPECT_NEAR(buffer->getExpectationValueZ(), 1.0, 1e-9);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
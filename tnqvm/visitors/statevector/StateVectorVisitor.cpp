@@ -0,0 +1,417 @@
+/***********************************************************************************
+ * Copyright (c) 2020, UT-Battelle
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the xacc nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **********************************************************************************/
+#include "StateVectorVisitor.hpp"
+#include "base/Gates.hpp"
+#include "utils/GateMatrixAlgebra.hpp"
+#include "InstructionIterator.hpp"
+#include "xacc_plugin.hpp"
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+const std::complex<double> I_UNIT(0.0, 1.0);
+
+// Default max number of qubits of fused gates.
+constexpr int DEFAULT_FUSION_MAX_QUBITS = 4;
+// Gate fusion is only enabled by default for large state vectors
+// (matrix products are not worth it for small ones).
+constexpr size_t FUSION_MIN_NUMBER_QUBITS = 16;
+
+GateMatrixType diagonalGateMatrix(const std::complex<double>& in_d0, const std::complex<double>& in_d1)
+{
+    return { { in_d0, 0.0 }, { 0.0, in_d1 } };
+}
+
+// Controlled-U matrix (basis: |control, target>)
+GateMatrixType controlledGateMatrix(const GateMatrixType& in_gateMatrix)
+{
+    GateMatrixType result { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0, 0.0 } };
+    for (size_t row = 0; row < 2; ++row)
+    {
+        for (size_t col = 0; col < 2; ++col)
+        {
+            result[2 + row][2 + col] = in_gateMatrix[row][col];
+        }
+    }
+    return result;
+}
+
+// Generate measurement samples (bit strings) from the state vector:
+// the random numbers are sorted so that a single pass over the
+// (cumulative) probability distribution serves all the shots.
+std::vector<std::string> sampleStateVector(const std::vector<std::complex<double>>& in_stateVec, const std::vector<size_t>& in_measureQubits, int in_nbShots)
+{
+    static std::mt19937 randomEngine(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::vector<double> randomProbs(in_nbShots);
+    for (auto& prob : randomProbs)
+    {
+        prob = distribution(randomEngine);
+    }
+    std::sort(randomProbs.begin(), randomProbs.end());
+
+    std::vector<std::string> result;
+    result.reserve(in_nbShots);
+    double cumulativeProb = 0.0;
+    uint64_t stateSelect = 0;
+    for (const auto& prob : randomProbs)
+    {
+        while (stateSelect < in_stateVec.size() - 1 && cumulativeProb + std::norm(in_stateVec[stateSelect]) < prob)
+        {
+            cumulativeProb += std::norm(in_stateVec[stateSelect++]);
+        }
+
+        std::string bitString;
+        for (const auto& qubit : in_measureQubits)
+        {
+            bitString.push_back(((stateSelect >> qubit) & 1) ? '1' : '0');
+        }
+        result.emplace_back(std::move(bitString));
+    }
+
+    // Shuffle the result (the samples were generated in order)
+    std::shuffle(result.begin(), result.end(), randomEngine);
+    return result;
+}
+} // namespace
+
+namespace tnqvm {
+void StateVectorVisitor::initialize(std::shared_ptr<AcceleratorBuffer> buffer, int nbShots)
+{
+    if (buffer->size() > MAX_NUMBER_QUBITS)
+    {
+        xacc::error("The 'statevector' visitor only supports up to " + std::to_string(MAX_NUMBER_QUBITS) + " qubits. Please use a tensor network visitor (e.g. 'exatn-mps') instead.");
+        return;
+    }
+
+    m_buffer = buffer;
+    m_shots = nbShots;
+    m_measureQubits.clear();
+    m_nbThreads = options.keyExists<int>("sv-num-threads") ? std::max(1, options.get<int>("sv-num-threads")) : std::max(1u, std::thread::hardware_concurrency());
+    const int fusionMaxQubits = options.keyExists<int>("sv-fusion-max-qubits") ? options.get<int>("sv-fusion-max-qubits") : (buffer->size() >= FUSION_MIN_NUMBER_QUBITS ? DEFAULT_FUSION_MAX_QUBITS : 0);
+    m_gateQueue = (fusionMaxQubits > 0) ? std::make_unique<FusedGateQueue>(fusionMaxQubits) : nullptr;
+    m_stateVec.assign(1ULL << buffer->size(), 0.0);
+    // Default is the |0> state
+    m_stateVec[0] = 1.0;
+}
+
+void StateVectorVisitor::finalize()
+{
+    if (!m_buffer)
+    {
+        return;
+    }
+    flushGates();
+
+    if (!m_measureQubits.empty())
+    {
+        if (m_shots > 0)
+        {
+            for (const auto& bitString : sampleStateVector(m_stateVec, m_measureQubits, m_shots))
+            {
+                m_buffer->appendMeasurement(bitString);
+            }
+        }
+        else
+        {
+            m_buffer->addExtraInfo("exp-val-z", CalcExpValueZ(m_measureQubits, m_stateVec, m_nbThreads));
+        }
+    }
+
+    m_measureQubits.clear();
+    m_buffer.reset();
+}
+
+const double StateVectorVisitor::getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function)
+{
+    // Apply the change-of-basis gates to a copy of the (ansatz) state vector.
+    flushGates();
+    const auto cachedStateVec = m_stateVec;
+    std::vector<size_t> measureQubits;
+    InstructionIterator it(in_function);
+    while (it.hasNext())
+    {
+        auto nextInst = it.next();
+        if (nextInst->isEnabled() && !nextInst->isComposite())
+        {
+            if (nextInst->name() == "Measure")
+            {
+                measureQubits.emplace_back(nextInst->bits()[0]);
+            }
+            else
+            {
+                nextInst->accept(this);
+            }
+        }
+    }
+
+    flushGates();
+    const double result = measureQubits.empty() ? 1.0 : CalcExpValueZ(measureQubits, m_stateVec, m_nbThreads);
+    m_stateVec = cachedStateVec;
+    return result;
+}
+
+const std::vector<std::complex<double>> StateVectorVisitor::getState()
+{
+    flushGates();
+    return m_stateVec;
+}
+
+bool StateVectorVisitor::fuseGate(const std::vector<size_t>& in_qubits, const GateMatrixType& in_gateMatrix)
+{
+    if (!m_gateQueue)
+    {
+        return false;
+    }
+
+    if (m_gateQueue->addGate(in_qubits, in_gateMatrix))
+    {
+        m_gateQueue->flush(m_stateVec, m_nbThreads);
+    }
+    return true;
+}
+
+void StateVectorVisitor::flushGates()
+{
+    if (m_gateQueue && !m_gateQueue->empty())
+    {
+        m_gateQueue->flush(m_stateVec, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix)
+{
+    if (in_qubits.empty() || in_qubits.size() > MAX_FUSED_GATE_QUBITS)
+    {
+        xacc::error("Generic gates must act on 1 to " + std::to_string(MAX_FUSED_GATE_QUBITS) + " qubits.");
+    }
+    if ((1ULL << in_qubits.size()) != in_matrix.size())
+    {
+        xacc::error("Gate matrix dimension doesn't match the number of qubits.");
+    }
+    validateGateQubits(in_qubits, m_buffer->size());
+    if (!fuseGate(in_qubits, in_matrix))
+    {
+        ApplyMultiQubitGateInPlace(m_stateVec, in_qubits, in_matrix, m_nbThreads);
+    }
+}
+
+// === Single-qubit gates ===
+void StateVectorVisitor::visit(Hadamard& in_HadamardGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::H>();
+    if (!fuseGate({ in_HadamardGate.bits()[0] }, gateMatrix))
+    {
+        ApplySingleQubitGateInPlace(m_stateVec, in_HadamardGate.bits()[0], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(X& in_XGate)
+{
+    if (!fuseGate({ in_XGate.bits()[0] }, GetGateMatrix<CommonGates::X>()))
+    {
+        ApplyXGateInPlace(m_stateVec, in_XGate.bits()[0], m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Y& in_YGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::Y>();
+    if (!fuseGate({ in_YGate.bits()[0] }, gateMatrix))
+    {
+        ApplySingleQubitGateInPlace(m_stateVec, in_YGate.bits()[0], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Z& in_ZGate)
+{
+    if (!fuseGate({ in_ZGate.bits()[0] }, diagonalGateMatrix(1.0, -1.0)))
+    {
+        ApplyDiagonalGateInPlace(m_stateVec, in_ZGate.bits()[0], 1.0, -1.0, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Rx& in_RxGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::Rx>(in_RxGate.getParameter(0).as<double>());
+    if (!fuseGate({ in_RxGate.bits()[0] }, gateMatrix))
+    {
+        ApplySingleQubitGateInPlace(m_stateVec, in_RxGate.bits()[0], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Ry& in_RyGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::Ry>(in_RyGate.getParameter(0).as<double>());
+    if (!fuseGate({ in_RyGate.bits()[0] }, gateMatrix))
+    {
+        ApplySingleQubitGateInPlace(m_stateVec, in_RyGate.bits()[0], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Rz& in_RzGate)
+{
+    const double theta = in_RzGate.getParameter(0).as<double>();
+    if (!fuseGate({ in_RzGate.bits()[0] }, diagonalGateMatrix(std::exp(-0.5 * I_UNIT * theta), std::exp(0.5 * I_UNIT * theta))))
+    {
+        ApplyDiagonalGateInPlace(m_stateVec, in_RzGate.bits()[0], std::exp(-0.5 * I_UNIT * theta), std::exp(0.5 * I_UNIT * theta), m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(S& in_SGate)
+{
+    if (!fuseGate({ in_SGate.bits()[0] }, diagonalGateMatrix(1.0, I_UNIT)))
+    {
+        ApplyDiagonalGateInPlace(m_stateVec, in_SGate.bits()[0], 1.0, I_UNIT, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Sdg& in_SdgGate)
+{
+    if (!fuseGate({ in_SdgGate.bits()[0] }, diagonalGateMatrix(1.0, -I_UNIT)))
+    {
+        ApplyDiagonalGateInPlace(m_stateVec, in_SdgGate.bits()[0], 1.0, -I_UNIT, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(T& in_TGate)
+{
+    if (!fuseGate({ in_TGate.bits()[0] }, diagonalGateMatrix(1.0, std::exp(I_UNIT * M_PI_4))))
+    {
+        ApplyDiagonalGateInPlace(m_stateVec, in_TGate.bits()[0], 1.0, std::exp(I_UNIT * M_PI_4), m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Tdg& in_TdgGate)
+{
+    if (!fuseGate({ in_TdgGate.bits()[0] }, diagonalGateMatrix(1.0, std::exp(-I_UNIT * M_PI_4))))
+    {
+        ApplyDiagonalGateInPlace(m_stateVec, in_TdgGate.bits()[0], 1.0, std::exp(-I_UNIT * M_PI_4), m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(U& in_UGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::U>(in_UGate.getParameter(0).as<double>(), in_UGate.getParameter(1).as<double>(), in_UGate.getParameter(2).as<double>());
+    if (!fuseGate({ in_UGate.bits()[0] }, gateMatrix))
+    {
+        ApplySingleQubitGateInPlace(m_stateVec, in_UGate.bits()[0], gateMatrix, m_nbThreads);
+    }
+}
+
+// === Two-qubit gates ===
+void StateVectorVisitor::visit(CNOT& in_CNOTGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::X>();
+    if (!fuseGate({ in_CNOTGate.bits()[0], in_CNOTGate.bits()[1] }, controlledGateMatrix(gateMatrix)))
+    {
+        ApplyControlledGateInPlace(m_stateVec, in_CNOTGate.bits()[0], in_CNOTGate.bits()[1], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(CY& in_CYGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::Y>();
+    if (!fuseGate({ in_CYGate.bits()[0], in_CYGate.bits()[1] }, controlledGateMatrix(gateMatrix)))
+    {
+        ApplyControlledGateInPlace(m_stateVec, in_CYGate.bits()[0], in_CYGate.bits()[1], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(CZ& in_CZGate)
+{
+    if (!fuseGate({ in_CZGate.bits()[0], in_CZGate.bits()[1] }, controlledGateMatrix(GetGateMatrix<CommonGates::Z>())))
+    {
+        ApplyControlledPhaseGateInPlace(m_stateVec, in_CZGate.bits()[0], in_CZGate.bits()[1], -1.0, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(CH& in_CHGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::H>();
+    if (!fuseGate({ in_CHGate.bits()[0], in_CHGate.bits()[1] }, controlledGateMatrix(gateMatrix)))
+    {
+        ApplyControlledGateInPlace(m_stateVec, in_CHGate.bits()[0], in_CHGate.bits()[1], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(CRZ& in_CRZGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::Rz>(in_CRZGate.getParameter(0).as<double>());
+    if (!fuseGate({ in_CRZGate.bits()[0], in_CRZGate.bits()[1] }, controlledGateMatrix(gateMatrix)))
+    {
+        ApplyControlledGateInPlace(m_stateVec, in_CRZGate.bits()[0], in_CRZGate.bits()[1], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(CPhase& in_CPhaseGate)
+{
+    const double theta = in_CPhaseGate.getParameter(0).as<double>();
+    if (!fuseGate({ in_CPhaseGate.bits()[0], in_CPhaseGate.bits()[1] }, controlledGateMatrix(diagonalGateMatrix(1.0, std::exp(I_UNIT * theta)))))
+    {
+        ApplyControlledPhaseGateInPlace(m_stateVec, in_CPhaseGate.bits()[0], in_CPhaseGate.bits()[1], std::exp(I_UNIT * theta), m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(Swap& in_SwapGate)
+{
+    if (!fuseGate({ in_SwapGate.bits()[0], in_SwapGate.bits()[1] }, GetGateMatrix<CommonGates::Swap>()))
+    {
+        ApplySwapGateInPlace(m_stateVec, in_SwapGate.bits()[0], in_SwapGate.bits()[1], m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(iSwap& in_iSwapGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::iSwap>();
+    if (!fuseGate({ in_iSwapGate.bits()[0], in_iSwapGate.bits()[1] }, gateMatrix))
+    {
+        ApplyTwoQubitGateInPlace(m_stateVec, in_iSwapGate.bits()[0], in_iSwapGate.bits()[1], gateMatrix, m_nbThreads);
+    }
+}
+
+void StateVectorVisitor::visit(fSim& in_fsimGate)
+{
+    const auto gateMatrix = GetGateMatrix<CommonGates::fSim>(in_fsimGate.getParameter(0).as<double>(), in_fsimGate.getParameter(1).as<double>());
+    if (!fuseGate({ in_fsimGate.bits()[0], in_fsimGate.bits()[1] }, gateMatrix))
+    {
+        ApplyTwoQubitGateInPlace(m_stateVec, in_fsimGate.bits()[0], in_fsimGate.bits()[1], gateMatrix, m_nbThreads);
+    }
+}
+
+// === Others ===
+void StateVectorVisitor::visit(Measure& in_MeasureGate)
+{
+    // Terminal measurements: sampled (or exp-val-z computed) at finalize().
+    m_measureQubits.emplace_back(in_MeasureGate.bits()[0]);
+}
+} // namespace tnqvm
+
+// Register with CppMicroservices
+REGISTER_PLUGIN(tnqvm::StateVectorVisitor, tnqvm::TNQVMVisitor)
@@ -0,0 +1,115 @@
+/***********************************************************************************
+ * Copyright (c) 2020, UT-Battelle
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the xacc nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **********************************************************************************/
+#pragma once
+
+#include "TNQVMVisitor.hpp"
+#include "utils/GateMatrixAlgebra.hpp"
+
+// Dense state-vector visitor:
+// Name: "statevector"
+// Gates are applied in-place to a full (2^N) state vector using the
+// multi-threaded kernels in utils/GateMatrixAlgebra.hpp (specialized for
+// diagonal, permutation and controlled gates).
+// This is the fast path for small/medium circuits (up to 32 qubits):
+// the exatn and exatn-mps visitors are substituted by this visitor when the
+// register has at most 'sv-fast-path-max-qubits' qubits (TNQVM accelerator
+// option, not set by default) and no tensor-network-only option is given.
+// Supported initialization keys:
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// |  Initialization Parameter   |                  Parameter Description                                 |    type     |         default          |
+// +=============================+========================================================================+=============+==========================+
+// | sv-num-threads              | Number of threads used by the gate kernels.                            |    int      | hardware concurrency     |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+// | sv-fusion-max-qubits        | Max number of qubits of fused gates (0: no gate fusion).               |    int      | 4 (>= 16 qubits), else 0 |
+// +-----------------------------+------------------------------------------------------------------------+-------------+--------------------------+
+
+namespace tnqvm {
+class StateVectorVisitor : public TNQVMVisitor
+{
+public:
+    // Max number of qubits that this visitor accepts.
+    static constexpr size_t MAX_NUMBER_QUBITS = 32;
+
+    // Virtual function impls:
+    virtual void initialize(std::shared_ptr<AcceleratorBuffer> buffer, int nbShots) override;
+    virtual void finalize() override;
+
+    // Service name as defined in manifest.json
+    virtual const std::string name() const override { return "statevector"; }
+    virtual const std::string description() const override { return "Dense state-vector visitor"; }
+    virtual std::shared_ptr<TNQVMVisitor> clone() override { return std::make_shared<StateVectorVisitor>(); }
+    virtual OptionPairs getOptions() override { return OptionPairs{{"sv-num-threads", "Number of threads used by the gate kernels (default: hardware concurrency)."}, {"sv-fusion-max-qubits", "Max number of qubits of fused gates (0: no gate fusion)."}}; }
+
+    // one-qubit gates
+    virtual void visit(Identity& in_IdentityGate) override {}
+    virtual void visit(Hadamard& in_HadamardGate) override;
+    virtual void visit(X& in_XGate) override;
+    virtual void visit(Y& in_YGate) override;
+    virtual void visit(Z& in_ZGate) override;
+    virtual void visit(Rx& in_RxGate) override;
+    virtual void visit(Ry& in_RyGate) override;
+    virtual void visit(Rz& in_RzGate) override;
+    virtual void visit(S& in_SGate) override;
+    virtual void visit(Sdg& in_SdgGate) override;
+    virtual void visit(T& in_TGate) override;
+    virtual void visit(Tdg& in_TdgGate) override;
+    virtual void visit(U& in_UGate) override;
+    // two-qubit gates
+    virtual void visit(CNOT& in_CNOTGate) override;
+    virtual void visit(CY& in_CYGate) override;
+    virtual void visit(CZ& in_CZGate) override;
+    virtual void visit(CH& in_CHGate) override;
+    virtual void visit(CRZ& in_CRZGate) override;
+    virtual void visit(CPhase& in_CPhaseGate) override;
+    virtual void visit(Swap& in_SwapGate) override;
+    virtual void visit(iSwap& in_iSwapGate) override;
+    virtual void visit(fSim& in_fsimGate) override;
+    // others
+    virtual void visit(Measure& in_MeasureGate) override;
+    // Generic k-qubit gate (k <= MAX_FUSED_GATE_QUBITS)
+    virtual void applyGateMatrix(const std::vector<size_t>& in_qubits, const std::vector<std::vector<std::complex<double>>>& in_matrix) override;
+
+    virtual bool supportVqeMode() const override { return true; }
+    virtual const double getExpectationValueZ(std::shared_ptr<CompositeInstruction> in_function) override;
+    virtual const std::vector<std::complex<double>> getState() override;
+
+private:
+    // Queues the gate for fusion if enabled, returns false otherwise (i.e. the gate must be applied directly).
+    bool fuseGate(const std::vector<size_t>& in_qubits, const GateMatrixType& in_gateMatrix);
+    // Applies all the pending (fused) gates to the state vector.
+    void flushGates();
+
+    std::shared_ptr<AcceleratorBuffer> m_buffer;
+    std::vector<std::complex<double>> m_stateVec;
+    // Measured qubits (in the order of the Measure instructions)
+    std::vector<size_t> m_measureQubits;
+    int m_shots;
+    size_t m_nbThreads;
+    std::unique_ptr<FusedGateQueue> m_gateQueue;
+};
+} // namespace tnqvm
@@ -0,0 +1,174 @@
+/***********************************************************************************
+ * Copyright (c) 2020, UT-Battelle
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the xacc nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **********************************************************************************/
+#include <memory>
+#include <gtest/gtest.h>
+#include "xacc.hpp"
+#include "xacc_service.hpp"
+
+TEST(StateVectorVisitorTester, checkExpValAgainstExatn)
+{
+    const std::string src = R"(__qpu__ void testExpVal(qbit q) {
+        H(q[0]);
+        Ry(q[1], 0.456);
+        CX(q[0], q[2]);
+        CZ(q[1], q[2]);
+        Rz(q[2], 1.234);
+        CPhase(q[2], q[0], 0.789);
+        T(q[0]);
+        Swap(q[0], q[1]);
+        iSwap(q[2], q[1]);
+        Y(q[1]);
+        Rx(q[0], 0.1);
+        U(q[2], 0.3, 0.2, 0.1);
+        H(q[0]);
+        Measure(q[0]);
+        Measure(q[2]);
+    })";
+
+    auto svAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "statevector"}});
+    auto refAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn"}});
+    auto program = xacc::getCompiler("xasm")->compile(src, svAcc)->getComposites()[0];
+    auto svBuffer = xacc::qalloc(3);
+    svAcc->execute(svBuffer, program);
+    auto refBuffer = xacc::qalloc(3);
+    refAcc->execute(refBuffer, program);
+    EXPECT_NEAR(svBuffer->getExpectationValueZ(), refBuffer->getExpectationValueZ(), 1e-9);
+    // Gate fusion (forced on for this small circuit)
+    auto fusedAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "statevector"}, {"sv-fusion-max-qubits", 2}});
+    auto fusedBuffer = xacc::qalloc(3);
+    fusedAcc->execute(fusedBuffer, program);
+    EXPECT_NEAR(fusedBuffer->getExpectationValueZ(), refBuffer->getExpectationValueZ(), 1e-9);
+}
+
+// exatn-mps hands small registers over to the dense engine when requested.
+TEST(StateVectorVisitorTester, checkFastPath)
+{
+    const std::string src = R"(__qpu__ void testFastPath(qbit q) {
+        H(q[0]);
+        CNOT(q[0], q[1]);
+        Ry(q[2], 0.345);
+        CNOT(q[1], q[2]);
+        CZ(q[2], q[3]);
+        Rx(q[3], 1.234);
+        Measure(q[0]);
+        Measure(q[3]);
+    })";
+
+    auto mpsAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-mps"}});
+    auto program = xacc::getCompiler("xasm")->compile(src, mpsAcc)->getComposites()[0];
+    auto mpsBuffer = xacc::qalloc(4);
+    mpsAcc->execute(mpsBuffer, program);
+    EXPECT_EQ(mpsAcc->getExecutionInfo().getString("visitor"), "exatn-mps");
+
+    auto fastAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-mps"}, {"sv-fast-path-max-qubits", 4}});
+    auto fastBuffer = xacc::qalloc(4);
+    fastAcc->execute(fastBuffer, program);
+    EXPECT_EQ(fastAcc->getExecutionInfo().getString("visitor"), "statevector");
+    EXPECT_NEAR(fastBuffer->getExpectationValueZ(), mpsBuffer->getExpectationValueZ(), 1e-9);
+
+    // Register larger than the threshold or MPS truncation requested: no fast path.
+    auto smallThresholdAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-mps"}, {"sv-fast-path-max-qubits", 3}});
+    smallThresholdAcc->execute(xacc::qalloc(4), program);
+    EXPECT_EQ(smallThresholdAcc->getExecutionInfo().getString("visitor"), "exatn-mps");
+    auto truncatedAcc = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "exatn-mps"}, {"sv-fast-path-max-qubits", 4}, {"max-bond-dim", 2}});
+    truncatedAcc->execute(xacc::qalloc(4), program);
+    EXPECT_EQ(truncatedAcc->getExecutionInfo().getString("visitor"), "exatn-mps");
+}
+
+// Gates that are native to this visitor vs. their decompositions.
+TEST(StateVectorVisitorTester, checkGateDecompositions)
+{
+    auto accelerator = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "statevector"}});
+    auto xasmCompiler = xacc::getCompiler("xasm");
+    auto ir = xasmCompiler->compile(R"(__qpu__ void nativeGates(qbit q) {
+        H(q[0]);
+        Ry(q[1], 0.987);
+        S(q[0]);
+        CY(q[0], q[1]);
+        CRZ(q[1], q[0], -0.321);
+        Sdg(q[1]);
+        H(q[0]);
+        H(q[1]);
+        Measure(q[0]);
+        Measure(q[1]);
+    }
+    __qpu__ void decomposedGates(qbit q) {
+        H(q[0]);
+        Ry(q[1], 0.987);
+        T(q[0]);
+        T(q[0]);
+        Tdg(q[1]);
+        Tdg(q[1]);
+        CX(q[0], q[1]);
+        T(q[1]);
+        T(q[1]);
+        Rz(q[0], -0.1605);
+        CX(q[1], q[0]);
+        Rz(q[0], 0.1605);
+        CX(q[1], q[0]);
+        Tdg(q[1]);
+        Tdg(q[1]);
+        H(q[0]);
+        H(q[1]);
+        Measure(q[0]);
+        Measure(q[1]);
+    })", accelerator);
+
+    auto nativeBuffer = xacc::qalloc(2);
+    accelerator->execute(nativeBuffer, ir->getComposite("nativeGates"));
+    auto decomposedBuffer = xacc::qalloc(2);
+    accelerator->execute(decomposedBuffer, ir->getComposite("decomposedGates"));
+    EXPECT_NEAR(nativeBuffer->getExpectationValueZ(), decomposedBuffer->getExpectationValueZ(), 1e-9);
+}
+
+TEST(StateVectorVisitorTester, checkShots)
+{
+    auto accelerator = xacc::getAccelerator("tnqvm", {{"tnqvm-visitor", "statevector"}, {"shots", 1024}});
+    auto program = xacc::getCompiler("xasm")->compile(R"(__qpu__ void testBell(qbit q) {
+        H(q[0]);
+        CX(q[0], q[1]);
+        Measure(q[0]);
+        Measure(q[1]);
+    })", accelerator)->getComposites()[0];
+    auto buffer = xacc::qalloc(2);
+    accelerator->execute(buffer, program);
+    buffer->print();
+    // Bell state: only "00" and "11"
+    EXPECT_EQ(buffer->getMeasurementCounts().size(), 2);
+    EXPECT_EQ(buffer->getMeasurementCounts()["00"] + buffer->getMeasurementCounts()["11"], 1024);
+    EXPECT_NEAR(buffer->computeMeasurementProbability("00"), 0.5, 0.1);
+}
+
+int main(int argc, char **argv)
+{
+    xacc::Initialize();
+    ::testing::InitGoogleTest(&argc, argv);
+    auto ret = RUN_ALL_TESTS();
+    xacc::Finalize();
+    return ret;
+}